@@ -0,0 +1,111 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CAPTURESEGMENT__H__
+#define __SGCT__CAPTURESEGMENT__H__
+
+#include <sgct/capturesink.h>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+/**
+ * The layout of the segment files that raw captures are written to. A segment starts
+ * with a block that contains the SegmentHeader, followed by any number of frame records.
+ * Each record consists of a block that contains the FrameHeader, followed by the pixel
+ * data of the frame exactly as it was read back from the GPU: rows from bottom to top,
+ * channels in BGR(A) order, little-endian. Every block and record is padded to a
+ * multiple of BlockSize, so all writes are aligned to the block size of the disk. The
+ * end of the frames is marked by the end of the file or a FrameHeader with a magic of 0.
+ */
+namespace sgct::rawcapture {
+
+constexpr const uint32_t BlockSize = 4096;
+constexpr const char SegmentMagic[8] = { 'S', 'G', 'C', 'T', 'R', 'A', 'W', '\0' };
+constexpr const uint32_t FrameMagic = 0x454d5246; // "FRME"
+constexpr const uint32_t Version = 2;
+
+using DataType = CaptureSink::DataType;
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t blockSize;
+    /// The file name that individual frames would have had without the frame number
+    char prefix[256];
+};
+
+struct FrameHeader {
+    uint32_t magic = FrameMagic;
+    uint32_t frameNumber = 0;
+    /// The time in seconds since the application was started when the frame was captured
+    double timestamp = 0.0;
+    int32_t nodeId = 0;
+    int32_t windowId = 0;
+    /// 0 for mono, 1 for the left eye, 2 for the right eye
+    int32_t eye = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t channels = 0;
+    DataType dataType = DataType::UInt8;
+    /// The frame number of the master when the frame was captured, 0 in version 1
+    uint32_t clusterFrameNumber = 0;
+    /// The number of bytes of pixel data that follow the header block
+    uint64_t dataSize = 0;
+    /// The number of bytes from the start of this record to the start of the next one
+    uint64_t recordSize = 0;
+};
+
+/// \return The number of bytes of one channel of a pixel with the provided type
+int bytesPerChannel(DataType type);
+
+} // namespace sgct::rawcapture
+
+namespace sgct {
+
+/**
+ * Appends raw frames to a sequence of segment files. A new segment is started whenever
+ * the next frame would not fit into the current segment. On Linux the segments are
+ * preallocated to reduce fragmentation and then truncated to the used size when closed.
+ * Frames can be appended from multiple threads at the same time. The frames are stored in
+ * the order in which they are appended, which is not necessarily their capture order.
+ */
+class CaptureSegmentWriter : public CaptureSink {
+public:
+    /**
+     * \param prefix The path and file name prefix of the segment files. The files are
+     *        named \p prefix followed by "segment", the segment number, and ".sgctraw"
+     * \param segmentSize The maximum size of a segment file in bytes
+     */
+    CaptureSegmentWriter(std::string prefix, uint64_t segmentSize);
+    ~CaptureSegmentWriter() override;
+
+    /// Writes a record for the \p header followed by \p header.dataSize bytes of \p data
+    void appendFrame(rawcapture::FrameHeader header, const unsigned char* data);
+
+    /// Appends the pixel data of the \p image with a header that describes the \p frame
+    void write(const Image& image, const Frame& frame) override;
+
+private:
+    void openSegment();
+    void closeSegment();
+
+    const std::string _prefix;
+    const uint64_t _segmentSize;
+
+    std::mutex _mutex;
+    FILE* _file = nullptr;
+    std::string _filename;
+    int _segmentIndex = 0;
+    uint64_t _offset = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__CAPTURESEGMENT__H__
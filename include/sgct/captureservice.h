@@ -0,0 +1,135 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CAPTURESERVICE__H__
+#define __SGCT__CAPTURESERVICE__H__
+
+#include <sgct/capturesink.h>
+#include <sgct/math.h>
+#include <sgct/settings.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+class Image;
+
+/**
+ * Saves captured frames to disk on a fixed pool of worker threads that is shared by the
+ * screen captures of all windows. The number of workers is the number of capture threads
+ * in the Settings; if that number is 0, the images are saved on the thread that submits
+ * them. Images that have been saved are kept and handed out again by acquireImage, so
+ * that continuous captures do not allocate a new image for every frame.
+ */
+class CaptureService {
+public:
+    /// Counters that show whether the capture threads keep up with the captured frames
+    struct Statistics {
+        /// The number of images that were saved or written to a sink
+        uint64_t nSaved = 0;
+        /// The number of images that were discarded because the queue was full
+        unsigned int nDropped = 0;
+        /// The number of images that are currently waiting for a worker
+        size_t queueDepth = 0;
+        /// The largest number of images that were waiting for a worker at the same time
+        size_t maxQueueDepth = 0;
+        /// The number of submissions that had to wait until the queue had space
+        unsigned int nWaits = 0;
+        /// The total and the longest time in seconds that a submission had to wait
+        double waitTime = 0.0;
+        double maxWaitTime = 0.0;
+        /// The total and the longest time in seconds that saving a single image took
+        double saveTime = 0.0;
+        double maxSaveTime = 0.0;
+    };
+
+    static CaptureService& instance();
+    static void destroy();
+
+    /**
+     * Returns an image with allocated data of the requested size. If a previously saved
+     * image with the same properties is available, it is reused.
+     */
+    std::unique_ptr<Image> acquireImage(ivec2 size, int channels, int bytesPerChannel);
+
+    /**
+     * Queues the \p image to be saved to \p filename. If the queue is full, the behavior
+     * depends on the capture queue policy in the Settings: Block waits until a worker
+     * has taken a job from the queue, Drop discards the image, and Grow queues the image
+     * regardless of the queue size.
+     *
+     * \return false if the image was dropped, true otherwise
+     */
+    bool submit(std::unique_ptr<Image> image, std::string filename);
+
+    /**
+     * Queues the \p image to be written to the \p sink. The queue behaves the same way as
+     * for images that are saved to individual files. If the image is dropped, the sink is
+     * notified of the dropped \p frame instead.
+     *
+     * \return false if the image was dropped, true otherwise
+     */
+    bool submit(std::unique_ptr<Image> image, std::shared_ptr<CaptureSink> sink,
+        CaptureSink::Frame frame);
+
+    /// \return The number of images that were discarded because the queue was full
+    unsigned int droppedJobs() const;
+
+    /// \return The counters of all images that were submitted since the start
+    Statistics statistics() const;
+
+private:
+    struct Job {
+        std::unique_ptr<Image> image;
+        std::string filename;
+        /// If this is set, the image is written to the sink instead of saved to file
+        std::shared_ptr<CaptureSink> sink;
+        CaptureSink::Frame frame;
+    };
+
+    CaptureService();
+    ~CaptureService();
+
+    bool enqueue(Job job);
+    void workerLoop();
+
+    /// \return The time in seconds that saving the image took
+    double save(Job& job);
+
+    /// Adds a saved image to the statistics. _mutex has to be locked
+    void recordSave(double time);
+
+    /// Puts the image back into the pool of free images. _mutex has to be locked
+    void recycleImage(std::unique_ptr<Image> image);
+
+    static CaptureService* _instance;
+
+    const Settings::CaptureQueuePolicy _policy;
+    const size_t _queueSize;
+
+    std::vector<std::thread> _workers;
+    std::deque<Job> _jobs;
+    std::vector<std::unique_ptr<Image>> _freeImages;
+    bool _isStopping = false;
+    Statistics _statistics;
+
+    mutable std::mutex _mutex;
+    /// Signaled when a job is added to the queue or the workers should stop
+    std::condition_variable _jobAdded;
+    /// Signaled when a worker has taken a job from the queue
+    std::condition_variable _jobTaken;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__CAPTURESERVICE__H__
@@ -0,0 +1,65 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CAPTURESINK__H__
+#define __SGCT__CAPTURESINK__H__
+
+#include <cstdint>
+
+namespace sgct {
+
+class Image;
+
+/**
+ * The destination of the frames that are captured from a window. A sink is attached to a
+ * ScreenCapture and receives every frame that is captured with it instead of the frame
+ * being saved as an individual image file. The frames are handed to the sink on the
+ * worker threads of the CaptureService, so write can be called from multiple threads at
+ * the same time and the calls are not necessarily in the order of the frames. The
+ * sequence number of the Frame can be used to restore the order.
+ */
+class CaptureSink {
+public:
+    /// The type of the channels of the captured pixels
+    enum class DataType : uint32_t { UInt8 = 0, UInt16, Float16, Float32 };
+
+    struct Frame {
+        /// Increases by one for every frame captured into the same sink, starting at 0
+        uint64_t sequence = 0;
+        /// The screenshot number of the frame, which is the same on all nodes
+        unsigned int frameNumber = 0;
+        /// The frame number of the master when the frame was captured
+        unsigned int clusterFrameNumber = 0;
+        /// The time in seconds since the application was started when it was captured
+        double timestamp = 0.0;
+        int nodeId = 0;
+        int windowId = 0;
+        /// 0 for mono, 1 for the left eye, 2 for the right eye
+        int eye = 0;
+        DataType dataType = DataType::UInt8;
+    };
+
+    virtual ~CaptureSink() = default;
+
+    /**
+     * Called for every captured frame. The rows of the \p image are ordered from bottom
+     * to top and the channels are in BGR(A) order. The \p image is reused for later
+     * frames once this function returns.
+     */
+    virtual void write(const Image& image, const Frame& frame) = 0;
+
+    /**
+     * Called instead of write for frames that were discarded because the capture queue
+     * was full. This function is called on the thread that captured the frame.
+     */
+    virtual void drop(const Frame&) {}
+};
+
+} // namespace sgct
+
+#endif // __SGCT__CAPTURESINK__H__
@@ -89,6 +89,9 @@ public:
      */
     User* trackedUser();
 
+    /// \return all users in the cluster, the first of which is the default user
+    const std::vector<std::unique_ptr<User>>& users() const;
+
     /// \return the number of nodes in the cluster
     int numberOfNodes() const;
 
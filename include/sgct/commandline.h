@@ -26,13 +26,22 @@ struct Configuration {
     std::optional<bool> firmSync;
     std::optional<bool> ignoreSync;
     std::optional<Settings::CaptureFormat> captureFormat;
+    std::optional<std::string> captureVideoCommand;
+    std::optional<bool> record;
     std::optional<int> nCaptureThreads;
     std::optional<bool> exportCorrectionMeshes;
+    std::optional<bool> useCorrectionMeshCache;
+    std::optional<std::string> correctionMeshCachePath;
+    std::optional<float> correctionMeshTolerance;
+    std::optional<bool> watchCorrectionFiles;
     std::optional<std::string> screenshotPath;
     std::optional<std::string> screenshotPrefix;
     std::optional<bool> addNodeNameInScreenshot;
     std::optional<bool> omitWindowNameInScreenshot;
     std::optional<bool> useOpenGLDebugContext;
+    std::optional<int> benchmarkFrames;
+    std::optional<double> benchmarkSeconds;
+    std::optional<bool> useSoftwareOpenGL;
 };
 
 /**
@@ -34,9 +34,33 @@ void validateUser(const User& user);
 
 
 struct Capture {
-    enum class Format { PNG, JPG, TGA };
+    enum class Format { PNG, JPG, TGA, Raw, Video, SharedMemory };
+    enum class QueuePolicy { Block, Drop, Grow };
+    enum class PngFilter { None, Sub, Up, Average, Paeth, Adaptive };
+    enum class JpegSubsampling { Chroma444, Chroma422, Chroma420 };
     std::optional<std::string> path;
     std::optional<Format> format;
+    /// The number of frames that can be read back from the GPU at the same time
+    std::optional<int> readbackBuffers;
+    /// The number of frames that can wait to be saved by the capture threads
+    std::optional<int> queueSize;
+    std::optional<QueuePolicy> queuePolicy;
+    /// The maximum size of the segment files of raw captures in MiB
+    std::optional<int> segmentSize;
+    /// The command that video captures are piped into instead of written to a file
+    std::optional<std::string> videoCommand;
+    /// The frame rate in Hz that is stored in the header of video captures
+    std::optional<float> videoFrameRate;
+    /// The name that the shared memory of shared memory captures starts with
+    std::optional<std::string> sharedMemoryName;
+    /// The number of frames that the shared memory of a capture can hold
+    std::optional<int> sharedMemorySlots;
+    /// The zlib compression level of PNG files in the range [-1, 9]
+    std::optional<int> pngCompression;
+    std::optional<PngFilter> pngFilter;
+    /// The quality of JPEG files in the range [1, 100]
+    std::optional<int> jpegQuality;
+    std::optional<JpegSubsampling> jpegSubsampling;
 };
 void validateCapture(const Capture& capture);
 
@@ -59,11 +83,25 @@ struct Settings {
         std::optional<int> refreshRate;
     };
 
+    struct DynamicResolution {
+        /// The frame rate (in Hz) that the resolution scaling is trying to maintain
+        std::optional<float> targetFrameRate;
+        std::optional<float> minScale;
+        std::optional<float> maxScale;
+        /// The amount by which the scale is changed at a time
+        std::optional<float> step;
+        /// The fraction of the frame time that has to be free before the scale increases
+        std::optional<float> hysteresis;
+        /// The number of frames over which the frame time is averaged
+        std::optional<int> frames;
+    };
+
     std::optional<bool> useDepthTexture;
     std::optional<bool> useNormalTexture;
     std::optional<bool> usePositionTexture;
     std::optional<BufferFloatPrecision> bufferFloatPrecision;
     std::optional<Display> display;
+    std::optional<DynamicResolution> dynamicResolution;
 };
 void validateSettings(const Settings& settings);
 
@@ -239,6 +277,7 @@ struct Viewport {
     std::optional<std::string> blendMaskTexture;
     std::optional<std::string> blendLevelMaskTexture;
     std::optional<std::string> correctionMeshTexture;
+    std::optional<bool> useWarpMap;
     std::optional<bool> isTracked;
     std::optional<Eye> eye;
     std::optional<vec2> position;
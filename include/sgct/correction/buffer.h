@@ -13,6 +13,9 @@
 
 namespace sgct::correction {
 
+/// Separates the triangle strips in the indices of a GL_TRIANGLE_STRIP buffer
+constexpr const unsigned int PrimitiveRestartIndex = 0xFFFFFFFF;
+
 struct CorrectionMeshVertex {
     float x = 0.f;
     float y = 0.f;
@@ -28,6 +31,11 @@ struct Buffer {
     std::vector<CorrectionMeshVertex> vertices;
     std::vector<unsigned int> indices;
     unsigned int geometryType = 0x0004; // GL_TRIANGLES
+
+    // The number of columns and rows if the vertices form a regular grid that is stored
+    // row by row, which is set by createGridIndices
+    unsigned int gridColumns = 0;
+    unsigned int gridRows = 0;
 };
 
 } // namespace sgct::correction
@@ -0,0 +1,27 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_GRIDMESH__H__
+#define __SGCT__CORRECTION_GRIDMESH__H__
+
+#include <sgct/correction/buffer.h>
+
+namespace sgct::correction {
+
+/**
+ * Creates the indices of \p buffer for a regular grid of \p nCols by \p nRows vertices
+ * that are stored row by row. Every row of quads becomes one triangle strip and the
+ * strips are separated by the PrimitiveRestartIndex. This needs a third of the indices of
+ * separate triangles, and as the vertices are visited row by row, the vertices that are
+ * shared with the previous strip are often still in the post-transform cache.
+ */
+void createGridIndices(Buffer& buffer, unsigned int nCols, unsigned int nRows);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_GRIDMESH__H__
@@ -0,0 +1,44 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_MESHCACHE__H__
+#define __SGCT__CORRECTION_MESHCACHE__H__
+
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <optional>
+#include <string>
+
+/**
+ * A cache of parsed correction meshes in a binary format that can be read without any
+ * parsing. Every cached mesh stores the size, modification time, and checksum of the
+ * mesh file it was created from, together with the viewport parameters and the
+ * simplification tolerance that the mesh depends on. A cached mesh is only used if all
+ * of these match.
+ */
+namespace sgct::correction {
+
+/**
+ * Returns the mesh that was cached in \p folder for the mesh file at \p path and the
+ * viewport with the provided parameters, or std::nullopt if there is no such mesh or if
+ * the mesh file has changed since it was cached.
+ */
+std::optional<Buffer> loadCachedMesh(const std::string& folder, const std::string& path,
+    const vec2& pos, const vec2& size, float aspectRatio, const vec2& tolerance);
+
+/**
+ * Stores the \p buffer that was created from the mesh file at \p path for the viewport
+ * with the provided parameters in \p folder. Failing to write the cache is not an error,
+ * as the mesh file is just parsed again the next time.
+ */
+void cacheMesh(const std::string& folder, const std::string& path, const vec2& pos,
+    const vec2& size, float aspectRatio, const vec2& tolerance, const Buffer& buffer);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_MESHCACHE__H__
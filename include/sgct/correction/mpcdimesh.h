@@ -10,10 +10,21 @@
 #define __SGCT__CORRECTION_MPCDIMESH__H__
 
 #include <sgct/correction/buffer.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 
 namespace sgct::correction {
 
-Buffer generateMpcdiMesh(const std::vector<char>& mpcdiMesh);
+/**
+ * Creates the mesh from the PFM warp file of an MPCDI region while the file is being
+ * decompressed. \p read is called repeatedly to fill the provided buffer with the next
+ * bytes of the file and returns the number of bytes that were written. \p fileSize is
+ * the size of the whole file, which the dimensions in the header are checked against
+ * before any memory is allocated for the mesh.
+ */
+Buffer generateMpcdiMesh(const std::function<size_t(char*, size_t)>& read,
+    uint64_t fileSize);
 
 } // namespace sgct::correction
 
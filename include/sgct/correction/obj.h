@@ -16,6 +16,15 @@ namespace sgct::correction {
 
 Buffer generateOBJMesh(const std::string& path);
 
+/**
+ * Writes the \p buffer as a Wavefront OBJ file to \p path that can be read back with
+ * generateOBJMesh. Triangle strips are written as individual triangles.
+ *
+ * \throw std::runtime_error if the geometry type is not supported or the file could
+ *        not be written
+ */
+void exportOBJMesh(const std::string& path, const Buffer& buffer);
+
 } // namespace sgct::correction
 
 #endif // __SGCT__CORRECTION_OBJ__H__
@@ -0,0 +1,33 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_SIMPLIFY__H__
+#define __SGCT__CORRECTION_SIMPLIFY__H__
+
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+
+namespace sgct::correction {
+
+/**
+ * Simplifies a grid mesh that was created by createGridIndices by merging blocks of cells
+ * in which the warping is smooth. A merged block is drawn as a fan of triangles around
+ * its center vertex. Blocks are only merged if the interpolated texture coordinates at
+ * all removed vertices are within \p tolerance of the original ones and the interpolated
+ * colors are within half a step of an 8-bit color, so that blend ramps and mask edges
+ * are kept. The vertices on the border of the grid are never removed, so the outline of
+ * the mesh stays the same. Buffers that are not grids are left unchanged.
+ *
+ * \param buffer The grid mesh that is replaced with the simplified mesh
+ * \param tolerance The largest error of the texture coordinates in each direction
+ */
+void simplifyGridMesh(Buffer& buffer, const vec2& tolerance);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_SIMPLIFY__H__
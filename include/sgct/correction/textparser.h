@@ -0,0 +1,68 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_TEXTPARSER__H__
+#define __SGCT__CORRECTION_TEXTPARSER__H__
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace sgct::correction {
+
+/// Reads the whole file into memory, or returns std::nullopt if it cannot be read
+std::optional<std::string> readTextFile(const std::string& path);
+
+/**
+ * Returns the number of lines in \p text that start with \p prefix, which is used to
+ * size the buffers before the lines are parsed.
+ */
+size_t countLines(std::string_view text, std::string_view prefix);
+
+/**
+ * Returns the next line of \p text without the line break and removes it from \p text.
+ * A carriage return at the end of the line is left in place and treated as whitespace
+ * by the LineParser.
+ */
+std::string_view nextLine(std::string_view& text);
+
+/**
+ * Parses numbers and literals from a single line of text without any allocations, which
+ * replaces sscanf for the text formats of the correction meshes. Every function skips
+ * the whitespace in front of the value and only advances if the value was read, so
+ * alternatives can be tried one after another.
+ */
+class LineParser {
+public:
+    explicit LineParser(std::string_view line);
+
+    /// Returns true and advances if the text continues with \p literal
+    bool consume(std::string_view literal);
+
+    bool read(float& value);
+    bool read(double& value);
+    bool read(int& value);
+    bool read(unsigned int& value);
+
+    /// Reads the characters until the next whitespace
+    std::string_view readWord();
+
+    /// Returns true if only whitespace is left
+    bool isEmpty();
+
+private:
+    void skipWhitespace();
+
+    const char* _pos;
+    const char* _end;
+};
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_TEXTPARSER__H__
@@ -0,0 +1,50 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_WARPMAP__H__
+#define __SGCT__CORRECTION_WARPMAP__H__
+
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <vector>
+
+namespace sgct::correction {
+
+/**
+ * A correction mesh that was rasterized into an image with one texel per pixel of the
+ * window. Every texel stores the texture coordinates and the color of the mesh at the
+ * center of the pixel, and whether the pixel is covered by the mesh at all.
+ */
+struct WarpMap {
+    /// The lower left corner of the area covered by the map in normalized device coords
+    vec2 position = { 0.f, 0.f };
+    /// The size of the area covered by the map in normalized device coordinates
+    vec2 size = { 0.f, 0.f };
+    /// The number of texels, which is 0 if the mesh does not cover any pixel
+    ivec2 resolution = { 0, 0 };
+    /// The s, t, and coverage of every texel, row by row from the bottom
+    std::vector<float> texels;
+    /// The interpolated RGBA vertex color of every texel, in the same order as texels
+    std::vector<float> colors;
+    /// True if all texels are in [0, 1], so that they fit into normalized integers
+    bool isNormalized = true;
+    /// True if all colors are in [0, 1], so that they fit into normalized integers
+    bool isColorNormalized = true;
+};
+
+/**
+ * Rasterizes the triangles of \p buffer into a warp map for a window with the provided
+ * \p resolution in pixels. The map only covers the bounding box of the mesh, which is
+ * aligned to the pixels of the window. The vertex colors are interpolated per channel,
+ * including alpha, the same way as when the mesh itself is rendered.
+ */
+WarpMap createWarpMap(const Buffer& buffer, const ivec2& resolution);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_WARPMAP__H__
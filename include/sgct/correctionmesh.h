@@ -9,14 +9,17 @@
 #ifndef __SGCT__CORRECTION_MESH__H__
 #define __SGCT__CORRECTION_MESH__H__
 
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <sgct/correction/warpmap.h>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace sgct {
 
 class BaseViewport;
-
-namespace correction { struct Buffer; }
+class Window;
 
 /**
  * Helper class for reading and rendering a correction mesh. A correction mesh is used for
@@ -24,17 +27,53 @@ namespace correction { struct Buffer; }
  */
 class CorrectionMesh {
 public:
+    /// The properties of the window that the parsed mesh depends on
+    struct WindowState {
+        float aspectRatio = 1.f;
+        ivec2 framebufferResolution = ivec2{ 1, 1 };
+        /// The resolution of the window on the screen, which the warp map is created for
+        ivec2 outputResolution = ivec2{ 1, 1 };
+    };
+
+    /**
+     * Returns the current state of \p window. The window can be resized or rescaled by
+     * the render thread at any time, so this has to be called on the render thread
+     * before a mesh is read on a worker thread.
+     */
+    static WindowState windowState(const Window& window);
+
+    ~CorrectionMesh();
+
     /**
-     * This function finds a suitable parser for warping meshes and loads them.
+     * Parses the warping mesh at \p path without creating any OpenGL objects, so that it
+     * can be called on a worker thread ahead of loadMesh, which then only uploads the
+     * result. SCISS and SkySkan meshes are skipped, as parsing them also changes the
+     * projection of the viewport, and are parsed in loadMesh instead.
+     *
+     * \param path the path to the mesh data
+     * \param parent the viewport the mesh is loaded for, which must not be changed by
+     *        another thread until this function returns
+     * \param window the state of the parent's window when the read was requested
+     * \param useWarpMap If true, the mesh is also rasterized into a warp map
+     * \throw std::runtime_error if mesh was not loaded successfully
+     */
+    void readMesh(const std::string& path, BaseViewport& parent,
+        const WindowState& window, bool useWarpMap = false);
+
+    /**
+     * This function finds a suitable parser for warping meshes and loads them. If the
+     * mesh was already parsed by readMesh, it is only uploaded.
      *
      * \param path the path to the mesh data
      * \param parent the pointer to parent viewport
      * \param needsMaskGeometry If true, a separate geometry to applying blend masks is
      *        loaded
+     * \param useWarpMap If true, the mesh is also rasterized into a warp map texture
+     *        that can be rendered with renderWarpMap instead of the mesh
      * \throw std::runtime_error if mesh was not loaded successfully
      */
     void loadMesh(std::string path, BaseViewport& parent,
-        bool needsMaskGeometry = false);
+        bool needsMaskGeometry = false, bool useWarpMap = false);
 
     /// Render the final mesh where for mapping the frame buffer to the screen.
     void renderQuadMesh() const;
@@ -45,23 +84,51 @@ public:
     /// Render the final mesh where for mapping the frame buffer to the screen.
     void renderMaskMesh() const;
 
+    /**
+     * Renders a quad that looks up the texture coordinates of every pixel in the warp
+     * map, which is bound to texture unit 1, and the color of the mesh, which is bound to
+     * texture unit 2. The shader has to sample the frame buffer texture at these
+     * coordinates instead of the quad's coordinates.
+     */
+    void renderWarpMap() const;
+
+    /// Returns true if the mesh was rasterized into a warp map by loadMesh
+    bool hasWarpMap() const;
+
 private:
     struct CorrectionMeshGeometry {
         ~CorrectionMeshGeometry();
 
+        void render() const;
+
         unsigned int vao = 0;
         unsigned int vbo = 0;
         unsigned int ibo = 0;
         unsigned int nVertices = 0;
         unsigned int nIndices = 0;
         unsigned int type = 0x0005; // GL_TRIANGLE_STRIP;
+        unsigned int indexType = 0x1405; // GL_UNSIGNED_INT
+        // If all vertices have the same color, it is not stored in the vertex buffer but
+        // set as a constant vertex attribute before rendering
+        bool hasVertexColors = true;
+        float color[4] = { 1.f, 1.f, 1.f, 1.f };
+        size_t bytes = 0;
     };
 
     void createMesh(CorrectionMeshGeometry& geom, const correction::Buffer& buffer);
+    void createWarpMap(const correction::WarpMap& map);
 
     CorrectionMeshGeometry _quadGeometry;
     CorrectionMeshGeometry _warpGeometry;
     CorrectionMeshGeometry _maskGeometry;
+    CorrectionMeshGeometry _warpMapGeometry;
+    unsigned int _warpMap = 0;
+    unsigned int _warpMapColor = 0;
+
+    /// The mesh that was parsed by readMesh and is waiting to be uploaded
+    std::optional<correction::Buffer> _buffer;
+    /// The warp map that was rasterized by readMesh and is waiting to be uploaded
+    std::optional<correction::WarpMap> _warpMapData;
 };
 
 } // namespace sgct
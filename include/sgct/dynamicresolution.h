@@ -0,0 +1,49 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__DYNAMICRESOLUTION__H__
+#define __SGCT__DYNAMICRESOLUTION__H__
+
+#include <sgct/settings.h>
+
+namespace sgct {
+
+/**
+ * Picks the resolution scale that keeps the frame time below the target frame time. The
+ * frame time is averaged over a number of frames, after which the scale is lowered if
+ * the target was missed, or raised if the frame time at the next higher scale is
+ * predicted to stay below the target with the hysteresis margin to spare. The cost of a
+ * frame is assumed to be proportional to the number of pixels, that is the square of the
+ * scale.
+ */
+class DynamicResolution {
+public:
+    explicit DynamicResolution(Settings::DynamicResolution settings);
+
+    /**
+     * Adds the frame time of the slowest node in the cluster for the last frame.
+     *
+     * \param frameTime The frame time in seconds
+     * \return true if the scale was changed as a result of this frame time
+     */
+    bool addFrameTime(double frameTime);
+
+    /// \return The scale that should currently be used for rendering
+    float scale() const;
+
+private:
+    const Settings::DynamicResolution _settings;
+    float _scale;
+    double _accumulatedTime = 0.0;
+    int _nFrames = 0;
+    int _nFramesToSkip = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__DYNAMICRESOLUTION__H__
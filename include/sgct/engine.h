@@ -12,6 +12,7 @@
 #include <sgct/actions.h>
 #include <sgct/callbackdata.h>
 #include <sgct/config.h>
+#include <sgct/dynamicresolution.h>
 #include <sgct/frustum.h>
 #include <sgct/joystick.h>
 #include <sgct/keys.h>
@@ -19,13 +20,19 @@
 #include <sgct/mouse.h>
 #include <sgct/window.h>
 #include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <future>
+#include <memory>
 #include <optional>
 #include <thread>
+#include <vector>
 
 namespace sgct {
 
 struct Configuration;
+class FileWatcher;
 class Node;
 class StatisticsRenderer;
 
@@ -197,21 +204,75 @@ public:
     /// Sets if the statistics graph should be rendered or not
     void setStatsGraphVisibility(bool state);
 
+    /**
+     * Sets whether the viewports and cube maps should only be rendered when the scene has
+     * changed. The scene is considered changed if setSceneChanged was called, if the
+     * shared data differs from the previous frame, if a user has moved, or if a window
+     * was resized. Otherwise the framebuffers keep their previous contents and only the
+     * warping and blending into the windows is performed. Content that changes without
+     * any of these, for example animations driven by a local clock, has to call
+     * setSceneChanged in every frame in which it changes. The decision is made for the
+     * whole node: if any of these changes applies, all viewports and cube map faces of
+     * all windows of this node are rendered again, even the ones that are unaffected.
+     */
+    void setSkipUnchangedFrames(bool state);
+
+    /// Forces the viewports of this node to be rendered in the current frame
+    void setSceneChanged();
+
     /**
      * Take an RGBA screenshot and save it as a PNG file. If stereo rendering is enabled
      * then two screenshots will be saved per frame, one for each eyeo.
      *
-     * To record frames for a movie simply call this function every frame you wish to
-     * record. The read to disk is multi-threaded.
+     * To record frames for a movie, use startRecording instead of calling this function
+     * every frame. The read to disk is multi-threaded.
+     *
+     * In a cluster, a screenshot that is requested on the master is taken by all nodes in
+     * the same frame, which is the next frame if the request is made after the pre-sync
+     * step. The screenshots are numbered by the master, so calling this function on a
+     * client node has no effect.
      */
     void takeScreenshot();
 
+    /**
+     * Starts capturing every frame of all windows until stopRecording is called. With
+     * the video capture format, each recording is written as one continuous video per
+     * window, otherwise the frames are saved the same way as individual screenshots.
+     * In a cluster, the recording is controlled by the master and all nodes capture the
+     * same frames; calling this function on a client node has no effect.
+     */
+    void startRecording();
+
+    /**
+     * Stops the recording that was started with startRecording. The frames that are still
+     * pending are saved and the video streams are finished before the next frame.
+     */
+    void stopRecording();
+
+    /// \return true if every frame is currently being captured
+    bool isRecording() const;
+
     /// Set the screenshot number (file index)
     void setScreenShotNumber(unsigned int number);
 
     /// \return the current screenshot number (file index)
     unsigned int screenShotNumber() const;
 
+    /**
+     * \return The number of the current frame on the master, which is the same on all
+     *         nodes of the cluster and is stored with every captured frame
+     */
+    unsigned int clusterFrameNumber() const;
+
+    /**
+     * Reads the correction meshes and mask images of all viewports again and replaces
+     * them on all nodes in the same frame. If the files are watched for changes, this
+     * happens automatically for the viewports that use a file which the master has seen
+     * changing. Like takeScreenshot, a call on the master is applied in the next frame,
+     * while a call on a client node has no effect.
+     */
+    void reloadCorrectionData();
+
     /**
      * This function returns the currently assigned draw function to be used in internal
      * classes that need to repeatedly call this. In general, there is no need for
@@ -314,6 +375,41 @@ private:
     void blitPreviousWindowViewport(Window& prevWindow, Window& window,
         const Viewport& viewport, Frustum::Mode mode);
 
+    /// Prints the summary of the frames that were recorded in benchmark mode
+    void printBenchmarkReport() const;
+
+    /**
+     * \param hasWindowChanged true if the framebuffers of any window were recreated in
+     *        this frame, which discards their contents
+     * \return true if the viewports have to be rendered in the current frame
+     */
+    bool isRenderingRequired(bool hasWindowChanged);
+
+    /**
+     * Checks the watched correction files for changes and reads the data of the viewports
+     * that use them in the background. The master starts a new reload generation with the
+     * changed files as soon as the data has been read.
+     */
+    void updateCorrectionReload();
+
+    /**
+     * Moves the viewports whose data has been read in the background to the staged ones.
+     *
+     * \param wait If true, the function waits for a read that is still running
+     * \return true if a read has finished
+     */
+    bool finishCorrectionRead(bool wait);
+
+    /**
+     * Uploads the correction data of the viewports that use the files of a new reload
+     * generation of the master. Data that was not read in the background yet is read
+     * first, and a background read of these viewports that is still running is waited
+     * for, so that all nodes replace the data in the same frame.
+     *
+     * \return true if the correction data of any viewport was replaced
+     */
+    bool applyCorrectionReload();
+
     const std::function<void()> _preWindowFn;
     const std::function<void(GLFWwindow*)> _initOpenGLFn;
     const std::function<void()> _preSyncFn;
@@ -333,8 +429,25 @@ private:
 
     bool _createDebugContext = false;
     bool _takeScreenshot = false;
+    bool _isRecording = false;
+
+    /// The capture state of a frame, which the master sends to all nodes with its data
+    struct CaptureState {
+        unsigned int frameNumber = 0;
+        unsigned int shotNumber = 0;
+        bool takeScreenshot = false;
+        bool isRecording = false;
+    };
+    /// The capture state of the frame that is currently rendered
+    CaptureState _capture;
+    /// The capture state that was last received from the master, guarded by DataSync
+    CaptureState _receivedCapture;
     bool _shouldTerminate = false;
 
+    bool _skipUnchangedFrames = false;
+    bool _isSceneChanged = true;
+    uint64_t _sceneStateHash = 0;
+
     bool _printSyncMessage = true;
     float _syncTimeout = 60.f;
 
@@ -348,11 +461,70 @@ private:
     std::optional<FXAAShader> _fxaa;
     ShaderProgram _fboQuad;
     ShaderProgram _overlay;
+    ShaderProgram _warpMap;
 
     std::unique_ptr<std::thread> _thread;
 
+    struct Benchmark {
+        /// Wall-clock durations of the stages of a single frame in seconds
+        struct Frame {
+            double total = 0.0;
+            double preSync = 0.0;
+            double sync = 0.0;
+            double preDraw = 0.0;
+            double draw = 0.0;
+            double composite = 0.0;
+            double postDraw = 0.0;
+            double swap = 0.0;
+            double gpuDraw = 0.0;
+            uint64_t allocations = 0;
+        };
+
+        std::optional<int> nFrames;
+        std::optional<double> duration;
+        double startTime = 0.0;
+        std::vector<Frame> frames;
+    };
+    std::optional<Benchmark> _benchmark;
+
+    /// Only the master's controller decides the scale, but all nodes create one
+    std::optional<DynamicResolution> _dynamicResolution;
+    /// The resolution scale agreed on by the cluster; set by the master's sync data
+    std::atomic<float> _resolutionScale = 1.f;
+
     unsigned int _frameCounter = 0;
     unsigned int _shotCounter = 0;
+
+    /**
+     * Viewports move from changed to reading while their data is read in the background
+     * and then to staged, where they wait until the master starts a generation that
+     * contains their files. The changed files move along with the viewports
+     */
+    struct CorrectionReload {
+        std::unique_ptr<FileWatcher> watcher;
+        std::vector<Viewport*> changed;
+        std::vector<std::string> changedFiles;
+        std::vector<Viewport*> reading;
+        std::vector<std::string> readingFiles;
+        std::vector<Viewport*> staged;
+        std::vector<std::string> stagedFiles;
+        std::future<void> task;
+    };
+    CorrectionReload _correctionReload;
+    bool _watchCorrectionFiles = false;
+
+    /// The reload of the correction data, which the master sends to all nodes
+    struct CorrectionState {
+        /// Increased by the master every time the correction data is reloaded
+        unsigned int generation = 0;
+        /// The files whose viewports are reloaded, or empty to reload all viewports
+        std::vector<std::string> files;
+    };
+    CorrectionState _correction;
+    /// The state that was last received from the master, guarded by DataSync
+    CorrectionState _receivedCorrection;
+    /// The generation of the correction data that is currently used by this node
+    unsigned int _appliedCorrectionGeneration = 0;
 };
 
 } // namespace sgct
@@ -21,8 +21,23 @@ namespace sgct {
  * 1002: User / Tracking tracker name must not be empty
  * 1003: User / Name 'default' is not permitted for a user
  * 1010: Capture / Capture path must not be empty
+ * 1011: Capture / Number of capture readback buffers must be positive
+ * 1012: Capture / Capture queue size must be positive
+ * 1013: Capture / PNG compression level must be in the range [-1, 9]
+ * 1014: Capture / Capture segment size must be positive
+ * 1015: Capture / Video capture command must not be empty
+ * 1016: Capture / Video capture frame rate must be positive
+ * 1017: Capture / Shared memory capture name must not be empty
+ * 1018: Capture / Number of shared memory capture slots must be positive
+ * 1019: Capture / JPEG quality must be in the range [1, 100]
  * 1020: Settings / Swap interval must not be negative
  * 1021: Settings / Refresh rate must not be negative
+ * 1022: Settings / Dynamic resolution target frame rate must be positive
+ * 1023: Settings / Dynamic resolution scales must be in the range (0, 1]
+ * 1024: Settings / Dynamic resolution minimum scale must not exceed maximum
+ * 1025: Settings / Dynamic resolution step must be positive
+ * 1026: Settings / Dynamic resolution hysteresis must be in the range [0, 1)
+ * 1027: Settings / Dynamic resolution must average over at least one frame
  * 1030: Device / Device name must not be empty
  * 1031: Device / VRPN address for sensors must not be empty
  * 1032: Device / VRPN address for buttons must not be empty
@@ -72,15 +87,17 @@ namespace sgct {
  * 1128: Cluster / Two or more nodes are using the same port
 
  * 2000s: Correction Meshes
- * 2000: CorrectionMesh / Failed to export. Geometry type is not supported"
- * 2001: CorrectionMesh / Failed to export " + exportPath + ". Failed to open"
  * 2010: DomeProjection / Could not determine format for warping mesh
  * 2020: MPCDIMesh / Configuration error. Trying load MPCDI to wrong viewport
  * 2021: MPCDIMesh / Error reading from file. Could not find lines
  * 2022: MPCDIMesh / Invalid header information in MPCDI mesh
  * 2023: MPCDIMesh / Incorrect file type. Unknown header type
+ * 2024: MPCDIMesh / Unexpected end of the MPCDI mesh data
+ * 2025: MPCDIMesh / MPCDI mesh header describes more data than the file contains
  * 2030: OBJ / Failed to open warping mesh file
  * 2031: OBJ / Vertex count doesn't match number of texture coordinates
+ * 2032: OBJ / Failed to export. Geometry type not supported
+ * 2033: OBJ / Failed to export. Failed to open or write
  * 2040: PaulBourke / Failed to open warping mesh file
  * 2041: PaulBourke / Error reading mapping type
  * 2042: PaulBourke / Invalid data
@@ -190,7 +207,10 @@ namespace sgct {
  * 6041: Node / Missing field port in node
  * 6050: Settings / Wrong buffer precision value. Must be 16 or 32
  * 6051: Settings / Wrong buffer precision value type
- * 6060: Capture / Unknown capturing format. Needs to be png, tga, jpg
+ * 6060: Capture / Unknown capturing format. Needs to be png, tga, jpg, raw, video, shm
+ * 6061: Capture / Unknown capture queue policy. Needs to be block, drop, grow
+ * 6062: Capture / Unknown PNG filter. Needs to be none, sub, up, average, paeth, adaptive
+ * 6063: Capture / Unknown JPEG subsampling. Needs to be 444, 422, 420
  * 6070: Tracker / Tracker is missing 'name'
  * 6080: XML Parsing / No XML file provided
  * 6081: XML Parsing / Could not find configureation file: %s
@@ -226,6 +246,13 @@ namespace sgct {
  * 9010: Image / Failed to create PNG info struct
  * 9011: Image / One of the called PNG functions failed
  * 9012: Image / Invalid image size %i x %i %i channels
+ * 9013: Image / Failed to compress PNG data
+ * 9014: Image / Could not create capture segment '%s'
+ * 9015: Image / Could not write to capture segment '%s'
+ * 9016: Image / Could not open video stream '%s'
+ * 9017: Image / Could not write to video stream '%s'
+ * 9018: Image / Could not create shared memory '%s'
+ * 9019: Image / Could not create semaphore '%s'
 
  OBS:  When adding a new error code, don't forget to update docs/errors.md accordingly
  */
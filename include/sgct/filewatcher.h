@@ -0,0 +1,61 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__FILEWATCHER__H__
+#define __SGCT__FILEWATCHER__H__
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * Watches a list of files for changes without blocking or using a thread of its own. On
+ * Linux the folders of the files are watched with inotify, which also detects files that
+ * are replaced by moving another file onto them. On other platforms the modification
+ * times and sizes of the files are compared at most once per second.
+ */
+class FileWatcher {
+public:
+    explicit FileWatcher(const std::vector<std::string>& files);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /// Returns the watched files that have been written since the last call
+    std::vector<std::string> changedFiles();
+
+private:
+    struct File {
+        /// The path as it was passed to the constructor
+        std::string path;
+        std::filesystem::path folder;
+        std::filesystem::path name;
+        // The last known state, which is only needed if the files are polled
+        std::filesystem::file_time_type time;
+        uintmax_t size = 0;
+    };
+    std::vector<File> _files;
+
+#ifdef __linux__
+    int _inotify = -1;
+    /// The inotify watch descriptor and the folder it belongs to
+    std::vector<std::pair<int, std::filesystem::path>> _folders;
+#else // __linux__
+    std::chrono::steady_clock::time_point _lastCheck;
+#endif // __linux__
+};
+
+} // namespace sgct
+
+#endif // __SGCT__FILEWATCHER__H__
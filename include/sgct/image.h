@@ -10,6 +10,7 @@
 #define __SGCT__IMAGE__H__
 
 #include <sgct/math.h>
+#include <sgct/settings.h>
 #include <string>
 
 namespace sgct {
@@ -26,7 +27,7 @@ public:
     void load(unsigned char* data, int length);
 
     /// Save the buffer to file. Type is automatically set by filename suffix.
-    void save(const std::string& filename);
+    void save(const std::string& filename) const;
 
     unsigned char* data();
     const unsigned char* data() const;
@@ -39,14 +40,32 @@ public:
     void setBytesPerChannel(int bpc);
 
 private:
+    /// Converts the data returned by stb into the channel and row order of the image
+    void convertLoadedData();
+
     /**
      * Compression levels 1-9.
      *   -1 = Default compression
      *    0 = No compression
      *    1 = Best speed
      *    9 = Best compression
+     *
+     * The image is split into horizontal stripes that are filtered and compressed in
+     * parallel.
      */
-    void savePNG(std::string filename, int compressionLevel = -1);
+    void savePNG(std::string filename, int compressionLevel = -1,
+        Settings::PngFilter filter = Settings::PngFilter::None) const;
+
+    /**
+     * Quality 1-100, where 100 results in the largest files with the fewest artifacts.
+     * Every row of 8 or 16 pixel high blocks is a restart interval of its own, which
+     * lets horizontal stripes of the image be encoded in parallel.
+     */
+    void saveJPEG(std::string filename, int quality,
+        Settings::JpegSubsampling subsampling) const;
+
+    /// Writes an uncompressed TGA file with the rows and channels in the order in memory
+    void saveTGA(std::string filename) const;
 
     int _nChannels = 0;
     ivec2 _size = ivec2{ 0, 0 };
@@ -55,6 +55,27 @@ constexpr const char* OverlayFrag = R"(
   }
 )";
 
+constexpr const char* WarpMapFrag = R"(
+  #version 330 core
+
+  in vec2 tr_uv;
+  in vec4 tr_color;
+  out vec4 out_color;
+
+  uniform sampler2D tex;
+  uniform sampler2D warpMap;
+  uniform sampler2D warpColor;
+
+  void main() {
+    // Texture coordinates and coverage of the correction mesh
+    vec3 warp = texture(warpMap, tr_uv).rgb;
+    if (warp.b < 0.5) {
+      discard;
+    }
+    out_color = texture(warpColor, tr_uv) * texture(tex, warp.rg);
+  }
+)";
+
 constexpr const char* AnaglyphRedCyanFrag = R"(
   #version 330 core
 
@@ -0,0 +1,112 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__MEMORY__H__
+#define __SGCT__MEMORY__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Accounting of the memory that SGCT allocates internally, tagged by the subsystem that
+ * owns it. Host-side allocations are reported as they are made, GPU-side allocations are
+ * estimated from the internal format and size of the objects that are created. None of
+ * this hooks into the global allocator, so only the buffers that are explicitly reported
+ * show up here.
+ */
+namespace sgct::memory {
+
+enum class Subsystem {
+    Network = 0,
+    SharedData,
+    Image,
+    Capture,
+    CorrectionMesh,
+    Font,
+    Texture,
+    FrameBuffer,
+    CubeMap,
+    Count
+};
+
+struct Usage {
+    /// Number of bytes that are currently allocated
+    std::int64_t bytes = 0;
+    /// Largest number of bytes that have been allocated at the same time
+    std::int64_t highWaterMark = 0;
+    /// Number of allocations that have been reported since the start of the application
+    std::uint64_t allocations = 0;
+    /// Number of deallocations that have been reported since the start of the application
+    std::uint64_t deallocations = 0;
+    /// Soft limit for this subsystem, 0 if no limit has been set
+    std::int64_t budget = 0;
+};
+
+/// \return The human readable name of the subsystem
+const char* toString(Subsystem subsystem);
+
+/// \return true if the memory of the subsystem is located on the GPU
+bool isGpuMemory(Subsystem subsystem);
+
+void allocate(Subsystem subsystem, std::size_t bytes);
+void deallocate(Subsystem subsystem, std::size_t bytes);
+
+/**
+ * Updates the accounted size of a buffer whose size is changing over time, for example a
+ * std::vector that is grown on demand.
+ *
+ * \param subsystem The subsystem that owns the buffer
+ * \param tracked The number of bytes that were previously reported for this buffer. This
+ *        value is updated to \p bytes
+ * \param bytes The new size of the buffer
+ */
+void track(Subsystem subsystem, std::size_t& tracked, std::size_t bytes);
+
+/**
+ * Registers the OpenGL texture \p texture as owned by \p subsystem with the provided
+ * size. If the texture was already registered, the previous size is replaced.
+ */
+void trackTexture(Subsystem subsystem, unsigned int texture, std::size_t bytes);
+
+/// Removes a texture previously registered with trackTexture. Unknown ids are ignored
+void untrackTexture(unsigned int texture);
+
+/**
+ * Estimates the number of bytes that are used by an image with the provided OpenGL
+ * internal format. The estimate does not include any driver-specific padding.
+ *
+ * \param internalFormat The OpenGL internal format of the texture or render buffer
+ * \param width The width of the image in pixels
+ * \param height The height of the image in pixels
+ * \param layers The number of layers, for example 6 for cube maps
+ * \param samples The number of multisamples per pixel
+ */
+std::size_t estimateImageBytes(unsigned int internalFormat, int width, int height,
+    int layers = 1, int samples = 1);
+
+/**
+ * Sets a soft budget for a subsystem. A warning is logged the first time the budget is
+ * exceeded. Passing 0 removes the budget.
+ */
+void setBudget(Subsystem subsystem, std::size_t bytes);
+
+Usage usage(Subsystem subsystem);
+
+/// \return The number of allocations of all subsystems since the application started
+std::uint64_t totalAllocations();
+
+/// Resets the high-water marks of all subsystems to their current usage
+void resetHighWaterMarks();
+
+/// \return A table containing the current usage and high-water mark of all subsystems
+std::string report();
+
+} // namespace sgct::memory
+
+#endif // __SGCT__MEMORY__H__
@@ -11,6 +11,8 @@
 
 #include <sgct/config.h>
 #include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -22,8 +24,8 @@ struct ReturnValue {
     struct ViewportInfo {
         /// The configuration struct for the individual viewports
         config::MpcdiProjection proj;
-        /// The warping mesh for each viewport as included inthe MPCDI file
-        std::vector<char> meshData;
+        /// The warping mesh that was built from the PFM file of the region, if it has one
+        std::optional<correction::Buffer> mesh;
     };
     /// The list of all viewports in the MPCDI
     std::vector<ViewportInfo> viewports;
@@ -35,6 +35,8 @@ public:
     static constexpr const char DataId = 17;
     static constexpr const char ConnectedId = 18;
     static constexpr const char DisconnectId = 19;
+    /// Marks a client acknowledgement payload that carries the client's frame time
+    static constexpr const char FrameTimeId = 20;
 
     enum class ConnectionType { SyncConnection, ExternalConnection, DataTransfer };
 
@@ -94,8 +96,12 @@ public:
     /// Iterates the send frame number and returns the new frame number
     int iterateFrameCounter();
 
-    /// The client sends ack message to server + console messages
-    void pushClientMessage();
+    /**
+     * The client sends ack message to server. The optional \p payload of \p length bytes
+     * is sent together with the acknowledgement and is passed to the server's decode
+     * function
+     */
+    void pushClientMessage(const void* payload = nullptr, uint32_t length = 0);
 
     /// \return the port of this connection
     int port() const;
@@ -105,6 +111,8 @@ public:
 private:
     void setRecvFrame(int i);
     void updateBuffer(std::vector<char>& buffer, uint32_t reqSize, uint32_t& currSize);
+    /// Reports the current capacity of the receive buffers to the memory accounting
+    void trackBufferMemory();
     int readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize,
         uint32_t& uncompressedDataSize);
     int readDataTransferMessage(char* header, int32_t& packageId, uint32_t& dataSize,
@@ -142,6 +150,7 @@ private:
 
     std::vector<char> _recvBuffer;
     std::vector<char> _uncompressBuffer;
+    size_t _trackedBufferBytes = 0;
     char _headerId = 0;
 
     std::condition_variable _startConnectionCond;
@@ -13,6 +13,8 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>
@@ -60,6 +62,15 @@ public:
 
     bool matchesAddress(const std::string& address) const;
 
+    /**
+     * Sets the time (in seconds) that this node needed to render its last frame. Clients
+     * send this value to the master together with their frame acknowledgement.
+     */
+    void setFrameTime(float frameTime);
+
+    /// \return The largest frame time that was last reported by a connected client
+    float maxClientFrameTime() const;
+
     /// Retrieve the node id if this node is part of the cluster configuration
     bool isComputerServer() const;
     bool isRunning() const;
@@ -105,6 +116,10 @@ private:
 
     std::vector<std::string> _localAddresses; // stores this computers ip addresses
 
+    float _frameTime = 0.f;
+    std::map<const Network*, float> _clientFrameTimes;
+    mutable std::mutex _clientFrameTimesMutex;
+
     bool _isServer = true;
     bool _isRunning = true;
     bool _allNodesConnected = false;
@@ -10,6 +10,7 @@
 #define __SGCT__OFFSCREENBUFFER__H__
 
 #include <sgct/math.h>
+#include <cstddef>
 
 namespace sgct {
 
@@ -66,6 +67,7 @@ private:
 
     ivec2 _size = ivec2{ -1, -1 };
     bool _isMultiSampled = false;
+    size_t _trackedBytes = 0;
 };
 
 } // namespace sgct
@@ -0,0 +1,85 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__PIXELKERNELS__H__
+#define __SGCT__PIXELKERNELS__H__
+
+#include <cstddef>
+
+/**
+ * Conversions between the pixel formats of images, captured frames, and textures. Each
+ * kernel has a scalar implementation and vectorized implementations for SSE 4.1 and AVX2,
+ * of which the fastest one that the CPU supports is selected when the kernels are used
+ * for the first time. All kernels produce the same results regardless of the selected
+ * instruction set. Unless noted otherwise, \p src and \p dst may point to the same data.
+ */
+namespace sgct::pixelkernels {
+
+enum class InstructionSet { Scalar = 0, SSE41, AVX2 };
+
+/// \return The instruction set that is used by the kernels
+InstructionSet instructionSet();
+
+/**
+ * Restricts the kernels to the provided instruction set, for example to compare the
+ * vectorized kernels against the scalar ones. An instruction set that is not supported
+ * by the CPU is ignored and the best supported one is used instead.
+ */
+void setInstructionSet(InstructionSet set);
+
+/// \return A human readable name of the instruction set
+const char* toString(InstructionSet set);
+
+/**
+ * Converts between BGR(A) and RGB(A) by swapping the first and the third channel of each
+ * pixel. For 16-bit channels, the byte order of every channel can be swapped in the same
+ * pass. Pixels with fewer than three channels are only copied or byte swapped.
+ */
+void swapRedBlue(const unsigned char* src, unsigned char* dst, size_t nPixels,
+    int channels, int bytesPerChannel = 1, bool swapEndian = false);
+
+/// Swaps the byte order of \p nValues 16-bit values
+void swapEndian16(const unsigned char* src, unsigned char* dst, size_t nValues);
+
+/// Converts 8-bit BGRA pixels into BGR pixels, or into RGB if \p swapRedBlue is true
+void stripAlpha(const unsigned char* src, unsigned char* dst, size_t nPixels,
+    bool swapRedBlue);
+
+/// Reverses the order of the \p nRows rows of \p rowBytes bytes each in place
+void flipVertically(unsigned char* data, size_t rowBytes, int nRows);
+
+/// Converts unsigned normalized 16-bit values into 8-bit values with rounding
+void uint16ToUInt8(const unsigned char* src, unsigned char* dst, size_t nValues);
+
+/**
+ * Converts 16-bit floating point values into 8-bit values. The values are clamped to
+ * [0, 1] and rounded, NaN becomes 0.
+ */
+void halfToUInt8(const unsigned char* src, unsigned char* dst, size_t nValues);
+
+/**
+ * Converts 32-bit floating point values into 8-bit values. The values are clamped to
+ * [0, 1] and rounded, NaN becomes 0.
+ */
+void floatToUInt8(const unsigned char* src, unsigned char* dst, size_t nValues);
+
+/**
+ * Converts an 8-bit BGR(A) image whose rows are ordered from bottom to top into planar
+ * YUV 4:2:0 (I420) with rows from top to bottom, using the BT.601 coefficients for
+ * limited range video. The chroma of every 2x2 block of pixels is their average. \p dst
+ * has to hold i420Size bytes and must not overlap with \p src.
+ */
+void bgrToI420(const unsigned char* src, int width, int height, int channels,
+    unsigned char* dst);
+
+/// \return The number of bytes of an I420 image with the provided size
+size_t i420Size(int width, int height);
+
+} // namespace sgct::pixelkernels
+
+#endif // __SGCT__PIXELKERNELS__H__
@@ -13,11 +13,11 @@
 #include <Tracy.hpp>
 #include <TracyOpenGL.hpp>
 
-#ifdef TRACY_ENABLE
+#if defined(TRACY_ENABLE) && defined(SGCT_TRACY_GLOBAL_ALLOCATIONS)
 
 void* operator new(size_t count);
 void operator delete(void* ptr) noexcept;
 
-#endif // TRACY_ENABLE
+#endif // TRACY_ENABLE && SGCT_TRACY_GLOBAL_ALLOCATIONS
 
 #endif // __SGCT__PROFILING__H__
@@ -26,6 +26,9 @@ public:
     /// Update projection when aspect ratio changes for the viewport.
     void update(vec2 size) override;
 
+    /// Rescales the cubemap and updates the texture size used for cubic interpolation
+    void setCubemapResolutionScale(float scale) override;
+
     /// Render the non-linear projection to currently bounded FBO
     void render(const Window& window, const BaseViewport& viewport,
         Frustum::Mode frustumMode) override;
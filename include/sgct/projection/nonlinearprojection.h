@@ -49,6 +49,15 @@ public:
      */
     void setCubemapResolution(int resolution);
 
+    /**
+     * Scales the resolution of the cubemap faces relative to the resolution that was set
+     * with setCubemapResolution. The cubemap textures and framebuffer are recreated if
+     * the resulting resolution differs from the current one.
+     *
+     * \param scale The scale factor that is applied to the cubemap resolution
+     */
+    virtual void setCubemapResolutionScale(float scale);
+
     /**
      * Set the interpolation mode.
      *
@@ -129,6 +138,7 @@ protected:
     Frustum::Mode _preferedMonoFrustumMode = Frustum::Mode::MonoEye;
 
     int _cubemapResolution = 512;
+    int _unscaledCubemapResolution = 512;
     vec4 _clearColor = vec4{ 0.3f, 0.3f, 0.3f, 1.f };
     ivec4 _vpCoords = ivec4{ 0, 0, 0, 0 };
     bool _useDepthTransformation = false;
@@ -36,6 +36,12 @@ public:
     /// Update projection when aspect ratio changes for the viewport.
     void update(vec2 size) override;
 
+    /**
+     * The Spout senders are created with the size of the cubemap, so the resolution of
+     * the cubemap is kept fixed and the scale is ignored.
+     */
+    void setCubemapResolutionScale(float scale) override;
+
     /// Render the non linear projection to currently bounded FBO
     void render(const Window& window, const BaseViewport& viewport,
         Frustum::Mode frustumMode) override;
@@ -10,32 +10,28 @@
 #define __SGCT__SCREENCAPTURE__H__
 
 #include <sgct/math.h>
-#include <functional>
-#include <mutex>
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <thread>
 #include <vector>
 
 namespace sgct {
 
-class Image;
+class CaptureSink;
 
 /// This class is used internally by SGCT and is called when taking screenshots
 class ScreenCapture {
 public:
-    /// The different file formats supported
-    enum class CaptureFormat { PNG, TGA, JPEG };
+    /**
+     * The different file formats supported. Raw frames are not saved to individual
+     * files but appended to segment files without any encoding. Video frames are
+     * written as a continuous Y4M stream into a file or an external encoder. Shared
+     * memory frames are published unencoded into a ring buffer for other processes
+     */
+    enum class CaptureFormat { PNG, TGA, JPEG, Raw, Video, SharedMemory };
     enum class CaptureSource { Texture, BackBuffer, LeftBackBuffer, RightBackBuffer };
     enum class EyeIndex { Mono, StereoLeft, StereoRight };
 
-    struct ScreenCaptureThreadInfo {
-        std::string filename;
-        std::unique_ptr<Image> frameBufferImage;
-        std::unique_ptr<std::thread> captureThread;
-        std::mutex* mutex = nullptr;
-        bool isRunning = false; // needed for test if running without join
-    };
-
     ScreenCapture();
     ~ScreenCapture();
 
@@ -59,6 +55,22 @@ public:
     /// Set the image format to use
     void setCaptureFormat(CaptureFormat cf);
 
+    /**
+     * Sets the sink that receives the captured frames instead of them being saved in the
+     * capture format. The pending frames are handed to the previous sink first. If
+     * \p sink is a nullptr, the frames are saved in the capture format again. A sink
+     * should only be attached to a single ScreenCapture, as the sequence numbers of the
+     * frames are counted per ScreenCapture.
+     */
+    void setCaptureSink(std::shared_ptr<CaptureSink> sink);
+
+    /**
+     * Hands all pending frames to the CaptureService and ends the current video stream,
+     * so that the next captured frame starts a new one. The video file is closed once
+     * the capture threads have written the remaining frames.
+     */
+    void finishRecording();
+
     /**
      * This function saves the images to disc.o
      *
@@ -68,25 +80,68 @@ public:
     void saveScreenCapture(unsigned int textureId,
         CaptureSource capSrc = CaptureSource::Texture);
 
+    /**
+     * Hands the frames whose readback the GPU has completed to the CaptureService. This
+     * function is called once per frame so that the last captured frames are saved even
+     * if no further screenshots are taken.
+     */
+    void collectReadbacks();
+
+    /// \return The number of captures that had to wait for an earlier readback
+    unsigned int stalledFrames() const;
+
 private:
+    /// A pixel pack buffer that a single frame is transferred into asynchronously
+    struct Readback {
+        unsigned int pbo = 0;
+        /// GLsync object that is signaled when the transfer into the pbo is finished
+        void* fence = nullptr;
+        std::string filename;
+        unsigned int frameNumber = 0;
+        unsigned int clusterFrameNumber = 0;
+        double timestamp = 0.0;
+    };
+
+    /// \return The file name of a capture up to the frame number
+    std::string filenamePrefix() const;
     std::string createFilename(unsigned int frameNumber);
-    int availableCaptureThread();
     void checkImageBuffer(CaptureSource captureSource);
-    Image* prepareImage(int index, std::string file);
 
-    std::mutex _mutex;
-    std::vector<ScreenCaptureThreadInfo> _captureInfos;
+    /**
+     * Copies the pixels of a completed readback into an image and submits it to the
+     * CaptureService to be saved.
+     *
+     * \param readback The readback that should be finished
+     * \param wait If true, this function blocks until the GPU has finished the transfer
+     * \return true if the readback was finished or there was no pending readback
+     */
+    bool finishReadback(Readback& readback, bool wait);
+
+    /// Blocks until all pending readbacks have been handed to the CaptureService
+    void finishAllReadbacks();
 
-    unsigned int _nThreads;
-    unsigned int _pbo = 0;
+    std::vector<Readback> _readbacks;
+    /// The readback that is used for the next capture; also the oldest pending one
+    size_t _nextReadback = 0;
+    unsigned int _nStalledFrames = 0;
     unsigned int _downloadFormat = 0x80E1; // GL_BGRA;
     unsigned int _downloadType = 0x1401; // GL_UNSIGNED_BYTE;
     unsigned int _downloadTypeSetByUser = _downloadType;
     int _dataSize = 0;
+    size_t _trackedBytes = 0;
     ivec2 _resolution = ivec2{ 0, 0 };
     int _nChannels = 0;
     int _bytesPerColor = 1;
 
+    /**
+     * The sink that the frames are written to, if any; shared with the pending jobs. It
+     * is either set by the user or created for the raw and video capture formats
+     */
+    std::shared_ptr<CaptureSink> _sink;
+    bool _hasUserSink = false;
+    /// The sequence number of the next frame that is written to the sink
+    uint64_t _nextSequence = 0;
+
     EyeIndex _eyeIndex = EyeIndex::Mono;
     CaptureFormat _format = CaptureFormat::PNG;
     int _windowIndex = 0;
@@ -23,7 +23,13 @@ namespace config {
 /// This singleton class will hold global SGCT settings.
 class Settings {
 public:
-    enum class CaptureFormat { PNG, TGA, JPG };
+    enum class CaptureFormat { PNG, TGA, JPG, Raw, Video, SharedMemory };
+    /// The behavior when a frame is captured while the capture queue is full
+    enum class CaptureQueuePolicy { Block, Drop, Grow };
+    /// The PNG row filter that is applied before compressing captured PNG files
+    enum class PngFilter { None, Sub, Up, Average, Paeth, Adaptive };
+    /// The resolution of the color information of captured JPEG files
+    enum class JpegSubsampling { Chroma444, Chroma422, Chroma420 };
 
     enum class DrawBufferType {
         Diffuse,
@@ -33,6 +39,25 @@ public:
     };
     enum class BufferFloatPrecision { Float16Bit, Float32Bit };
 
+    /**
+     * Settings for the automatic scaling of the offscreen framebuffers and cube maps. The
+     * scale is lowered when the slowest node in the cluster misses the target frame rate
+     * and raised again once there is enough headroom to render at the higher scale.
+     */
+    struct DynamicResolution {
+        bool isEnabled = false;
+        /// The frame rate in Hz that should be maintained
+        float targetFrameRate = 60.f;
+        float minScale = 0.5f;
+        float maxScale = 1.f;
+        /// The amount by which the scale is changed at a time
+        float step = 0.1f;
+        /// The fraction of the frame time that has to be free before the scale increases
+        float hysteresis = 0.1f;
+        /// The number of frames over which the frame time is averaged before deciding
+        int frames = 30;
+    };
+
     static Settings& instance();
     static void destroy();
 
@@ -71,9 +96,53 @@ public:
      */
     void setBufferFloatPrecision(BufferFloatPrecision bfp);
 
+    /// Set the parameters of the dynamic resolution scaling
+    void setDynamicResolution(DynamicResolution dynamicResolution);
+
     /// Set the number of capture threads used by SGCT (multi-threaded screenshots)
     void setNumberOfCaptureThreads(int count);
 
+    /**
+     * Set the number of buffers per window and eye that frames are read back into from
+     * the GPU. With more than one buffer, the readback of a frame is finished in a later
+     * frame so that the render thread does not have to wait for the transfer.
+     */
+    void setNumberOfCaptureReadbackBuffers(int count);
+
+    /// Set the number of captured frames that can wait for a capture thread
+    void setCaptureQueueSize(int size);
+
+    /// Set what happens to a captured frame if the capture queue is full
+    void setCaptureQueuePolicy(CaptureQueuePolicy policy);
+
+    /**
+     * Set the zlib compression level that is used when saving PNG files.
+     *   -1 = Default compression
+     *    0 = No compression
+     *    1 = Best speed
+     *    9 = Best compression
+     */
+    void setPngCompressionLevel(int level);
+
+    /**
+     * Set the row filter that is used when saving PNG files. Adaptive picks the best
+     * filter for every row, which results in the smallest files but is the slowest.
+     */
+    void setPngFilter(PngFilter filter);
+
+    /**
+     * Set the quality that is used when saving JPEG files in the range [1, 100]. Lower
+     * values result in smaller files that are also written faster.
+     */
+    void setJpegQuality(int quality);
+
+    /**
+     * Set the resolution of the color information of JPEG files. 4:2:2 halves the
+     * horizontal and 4:2:0 both the horizontal and the vertical resolution, which results
+     * in smaller files that are written faster.
+     */
+    void setJpegSubsampling(JpegSubsampling subsampling);
+
     /**
      * Set capture/screenshot path used by SGCT.
      *
@@ -84,6 +153,34 @@ public:
     /// Set the screenshot capture format.
     void setCaptureFormat(CaptureFormat format);
 
+    /**
+     * Set the maximum size of the segment files that raw captures are written to. The
+     * segments can be converted into images with the sgct-capture-convert tool.
+     *
+     * \param size The size of a segment in MiB
+     */
+    void setCaptureSegmentSize(int size);
+
+    /**
+     * Set the command that video captures are piped into. If the command is empty, the
+     * video is written to a Y4M file instead. Every occurrence of {file} in the command
+     * is replaced by the file name the video would have had, without the suffix.
+     */
+    void setCaptureVideoCommand(std::string command);
+
+    /// Set the frame rate in Hz that is stored in the header of video captures
+    void setCaptureVideoFrameRate(float frameRate);
+
+    /**
+     * Set the name of the shared memory that the shared memory capture format publishes
+     * the frames to. The node id, the window index, and the eye are appended to the name
+     * so that every captured image has its own shared memory.
+     */
+    void setCaptureSharedMemoryName(std::string name);
+
+    /// Set the number of frames that the shared memory of a capture can hold
+    void setCaptureSharedMemorySlots(int slots);
+
     /// Sets the prefix to be used for all screenshots
     void setScreenshotPrefix(std::string prefix);
 
@@ -96,6 +193,24 @@ public:
     /// Set to true if warping meshes should be exported as OBJ files.
     void setExportWarpingMeshes(bool state);
 
+    /**
+     * Set if parsed warping meshes should be cached in a binary format, so that they do
+     * not have to be parsed again the next time the application is started.
+     */
+    void setUseWarpingMeshCache(bool state);
+
+    /**
+     * Set the folder in which the parsed warping meshes are cached. If the path is
+     * empty, a folder in the temporary directory of the system is used.
+     */
+    void setWarpingMeshCachePath(std::string path);
+
+    /**
+     * Set the error in pixels that the simplification of dense warping meshes may
+     * introduce in the texture coordinates. A tolerance of 0 disables the simplification.
+     */
+    void setWarpingMeshTolerance(float pixels);
+
     /// If set to true, the node name is added to screenshots
     void setAddNodeNameToScreenshot(bool state);
 
@@ -129,6 +244,12 @@ public:
     /// Get if warping meshes should be exported as obj-files.
     bool exportWarpingMeshes() const;
 
+    /// Get the folder for cached warping meshes, which is empty if the cache is disabled
+    std::string warpingMeshCachePath() const;
+
+    /// Get the error in pixels that the simplification of warping meshes may introduce
+    float warpingMeshTolerance() const;
+
     /**
      * Get the capture/screenshot path
      *
@@ -145,9 +266,48 @@ public:
     /// Return true if positions are rendered to texture
     bool usePositionTexture() const;
 
+    /// Get the parameters of the dynamic resolution scaling
+    const DynamicResolution& dynamicResolution() const;
+
     /// Get the number of capture threads (for screenshot recording)
     int numberCaptureThreads() const;
 
+    /// Get the number of buffers that captured frames are read back into
+    int numberCaptureReadbackBuffers() const;
+
+    /// Get the number of captured frames that can wait for a capture thread
+    int captureQueueSize() const;
+
+    /// Get the maximum size of the raw capture segment files in MiB
+    int captureSegmentSize() const;
+
+    /// Get the command that video captures are piped into
+    const std::string& captureVideoCommand() const;
+
+    /// Get the frame rate of video captures in Hz
+    float captureVideoFrameRate() const;
+
+    /// Get the name that the shared memory of captures starts with
+    const std::string& captureSharedMemoryName() const;
+
+    /// Get the number of frames that the shared memory of a capture can hold
+    int captureSharedMemorySlots() const;
+
+    /// Get what happens to a captured frame if the capture queue is full
+    CaptureQueuePolicy captureQueuePolicy() const;
+
+    /// Get the zlib compression level that is used when saving PNG files
+    int pngCompressionLevel() const;
+
+    /// Get the row filter that is used when saving PNG files
+    PngFilter pngFilter() const;
+
+    /// Get the quality that is used when saving JPEG files
+    int jpegQuality() const;
+
+    /// Get the chroma subsampling that is used when saving JPEG files
+    JpegSubsampling jpegSubsampling() const;
+
     /// Returns whether screenshots should contain the node name
     bool addNodeNameToScreenshot() const;
 
@@ -169,12 +329,28 @@ private:
     int _swapInterval = 1;
     int _refreshRate = 0;
     int _nCaptureThreads = std::max(std::thread::hardware_concurrency() - 1, 0u);
+    int _nCaptureReadbackBuffers = 2;
+    int _captureQueueSize = 8;
+    int _captureSegmentSize = 1024;
+    std::string _captureVideoCommand;
+    float _captureVideoFrameRate = 60.f;
+    std::string _captureSharedMemoryName = "sgct";
+    int _captureSharedMemorySlots = 3;
+    CaptureQueuePolicy _captureQueuePolicy = CaptureQueuePolicy::Block;
+    int _pngCompressionLevel = -1;
+    PngFilter _pngFilter = PngFilter::None;
+    int _jpegQuality = 100;
+    JpegSubsampling _jpegSubsampling = JpegSubsampling::Chroma444;
 
     bool _useDepthTexture = false;
     bool _useNormalTexture = false;
     bool _usePositionTexture = false;
     bool _captureBackBuffer = false;
     bool _exportWarpingMeshes = false;
+    bool _useWarpingMeshCache = true;
+    std::string _warpingMeshCachePath;
+    float _warpingMeshTolerance = 0.f;
+    DynamicResolution _dynamicResolution;
     
     struct {
         std::string capturePath;
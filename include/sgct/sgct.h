@@ -17,6 +17,7 @@
 #include <sgct/keys.h>
 #include <sgct/log.h>
 #include <sgct/math.h>
+#include <sgct/memory.h>
 #include <sgct/networkmanager.h>
 #include <sgct/node.h>
 #include <sgct/opengl.h>
@@ -31,6 +31,16 @@ public:
     void setDecodeFunction(
         std::function<void(const std::vector<std::byte>&, unsigned int)> function);
 
+    /**
+     * Sets the functions that synchronize SGCT's own per-frame state. This state is sent
+     * as a length-prefixed block in front of the user data, so the position that is
+     * passed to the user's decode function points past it. These functions are set by
+     * the Engine and shouldn't be used by the user.
+     */
+    void setInternalEncodeFunction(std::function<void(std::vector<std::byte>&)> function);
+    void setInternalDecodeFunction(
+        std::function<void(const std::vector<std::byte>&, unsigned int)> function);
+
     /// This fuction is called internally by SGCT and shouldn't be used by the user.
     void encode();
 
@@ -43,13 +53,18 @@ public:
 
 private:
     SharedData();
+    ~SharedData();
 
     // function pointers
     std::function<std::vector<std::byte>()> _encodeFn;
     std::function<void(const std::vector<std::byte>&, unsigned int)> _decodeFn;
+    std::function<void(std::vector<std::byte>&)> _internalEncodeFn;
+    std::function<void(const std::vector<std::byte>&, unsigned int)> _internalDecodeFn;
 
     static SharedData* _instance;
     std::vector<std::byte> _dataBlock;
+    std::vector<std::byte> _internalBlock;
+    size_t _trackedBytes = 0;
     std::array<std::byte, Network::HeaderSize> _headerSpace;
 };
 
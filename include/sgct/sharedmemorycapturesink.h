@@ -0,0 +1,118 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__SHAREDMEMORYCAPTURESINK__H__
+#define __SGCT__SHAREDMEMORYCAPTURESINK__H__
+
+#include <sgct/capturesink.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * The layout of the shared memory that captured frames are published to. The memory
+ * starts with a block that contains the RingHeader, followed by nSlots slots of slotSize
+ * bytes each. Every slot starts with a SlotHeader, followed by the pixel data at
+ * SlotHeaderSize bytes from the start of the slot: rows from bottom to top, channels in
+ * BGR(A) order, exactly as it was read back from the GPU. The frame with the sequence
+ * number n is stored in slot n % nSlots.
+ *
+ * The publisher never waits for the consumers, so a slot can be overwritten while it is
+ * read. A consumer therefore loads the state of the slot before and after copying the
+ * frame and only uses the copy if both values are the same and not 0. After every
+ * published frame, the named semaphore with the name of the memory followed by "_ready"
+ * is posted.
+ */
+namespace sgct::shmcapture {
+
+constexpr const uint32_t BlockSize = 4096;
+constexpr const uint32_t SlotHeaderSize = 64;
+constexpr const char Magic[8] = { 'S', 'G', 'C', 'T', 'S', 'H', 'M', '\0' };
+constexpr const uint32_t Version = 1;
+
+using DataType = CaptureSink::DataType;
+
+struct RingHeader {
+    /// Written last, so the header is complete once the magic is valid
+    char magic[8];
+    uint32_t version;
+    uint32_t nSlots;
+    /// The number of bytes of every slot including its header
+    uint64_t slotSize;
+    /// The sequence number of the newest published frame plus one, 0 if there is none
+    std::atomic<uint64_t> nPublished;
+};
+
+struct SlotHeader {
+    /// 0 while the slot is written, otherwise the sequence number of its frame plus one
+    std::atomic<uint64_t> state;
+    uint32_t frameNumber;
+    uint32_t clusterFrameNumber;
+    /// The time in seconds since the application was started when the frame was captured
+    double timestamp;
+    int32_t nodeId;
+    int32_t windowId;
+    /// 0 for mono, 1 for the left eye, 2 for the right eye
+    int32_t eye;
+    int32_t width;
+    int32_t height;
+    int32_t channels;
+    DataType dataType;
+    uint32_t reserved;
+    /// The number of bytes of pixel data that follow the header
+    uint64_t dataSize;
+};
+static_assert(sizeof(SlotHeader) <= SlotHeaderSize, "SlotHeader does not fit its slot");
+
+} // namespace sgct::shmcapture
+
+namespace sgct {
+
+/**
+ * Publishes the captured frames into a ring buffer in named POSIX shared memory, from
+ * which other processes on the same computer can read them without any disk access or
+ * encoding. The shared memory is created with the first frame and sized for frames of
+ * that size; later frames that are larger are skipped. The shared memory and the
+ * semaphore are removed when the sink is destroyed.
+ */
+class SharedMemoryCaptureSink : public CaptureSink {
+public:
+    /**
+     * \param name The name of the shared memory, which has to start with a '/'
+     * \param nSlots The number of frames that the ring buffer holds
+     */
+    SharedMemoryCaptureSink(std::string name, int nSlots);
+    ~SharedMemoryCaptureSink() override;
+
+    void write(const Image& image, const Frame& frame) override;
+
+private:
+    /// Creates the shared memory with slots for frames of \p dataSize bytes
+    void open(uint64_t dataSize);
+
+    const std::string _name;
+    const uint32_t _nSlots;
+
+    std::mutex _mutex;
+    unsigned char* _memory = nullptr;
+    size_t _memorySize = 0;
+    uint64_t _slotSize = 0;
+    /// The semaphore that is posted for every frame, a sem_t*
+    void* _semaphore = nullptr;
+    bool _hasFailed = false;
+    /// The sequence number plus one of the newest frame that was written to each slot
+    std::vector<uint64_t> _slotSequences;
+    std::vector<bool> _isWriting;
+    unsigned int _nSkippedFrames = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__SHAREDMEMORYCAPTURESINK__H__
@@ -39,6 +39,15 @@ public:
     unsigned int loadTexture(const std::string& filename, bool interpolate,
         float anisotropicFilterSize = 1.f, int mipmapLevels = 8);
 
+    /**
+     * Uploads an image that has already been loaded, for example on a worker thread, to
+     * the TextureManager. The parameters are the same as for the other overload.
+     *
+     * \return The OpenGL name for the texture that was created
+     */
+    unsigned int loadTexture(const Image& image, bool interpolate,
+        float anisotropicFilterSize = 1.f, int mipmapLevels = 8);
+
     /**
      * Removes a previously generated OpenGL texture.
      *
@@ -0,0 +1,25 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+// OBS: This file is autogenerated based on the version.h.in
+
+#ifndef __SGCT__VERSION__H__
+#define __SGCT__VERSION__H__
+
+#include <string>
+
+namespace sgct {
+    constexpr const int VersionMajor = 3;
+    constexpr const int VersionMinor = 0;
+    constexpr const int VersionRevision = 0;
+
+    constexpr const char* Version =
+        "3.0.0";
+} // namespace
+
+#endif // __SGCT__VERSION__H__
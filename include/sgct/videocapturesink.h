@@ -0,0 +1,78 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__VIDEOCAPTURESINK__H__
+#define __SGCT__VIDEOCAPTURESINK__H__
+
+#include <sgct/capturesink.h>
+#include <sgct/math.h>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * Writes the captured frames as a continuous YUV4MPEG2 (Y4M) video stream with 4:2:0
+ * chroma subsampling, either into a file or into the standard input of an external
+ * process, for example an encoder like ffmpeg. The conversion into YUV happens on the
+ * capture threads, the frames are then written in the order in which they were captured.
+ * Frames that were dropped because the capture queue was full are replaced by a copy of
+ * the previous frame, so the stream keeps its frame rate. Only 8-bit frames with three or
+ * four channels are supported; the size of the stream is the size of the first frame.
+ */
+class VideoCaptureSink : public CaptureSink {
+public:
+    /**
+     * \param filename The file that the stream is written to if \p command is empty
+     * \param command If this is not empty, the command is run and the stream is written
+     *        to its standard input instead of a file
+     * \param frameRate The frame rate in Hz that is stored in the stream header
+     */
+    VideoCaptureSink(std::string filename, std::string command, float frameRate);
+    ~VideoCaptureSink() override;
+
+    void write(const Image& image, const Frame& frame) override;
+    void drop(const Frame& frame) override;
+
+private:
+    /// Opens the file or starts the process and writes the stream header
+    void open(ivec2 size);
+
+    /// Writes a single converted frame to the stream. _mutex has to be locked
+    void writeFrame(const std::vector<unsigned char>& yuv);
+
+    /// Repeats the last frame for the next dropped frames. _mutex has to be locked
+    void writeDroppedFrames();
+
+    const std::string _filename;
+    const std::string _command;
+    const float _frameRate;
+
+    std::mutex _mutex;
+    /// Signaled when the next frame in the sequence may be written
+    std::condition_variable _frameWritten;
+    FILE* _file = nullptr;
+    bool _isPipe = false;
+    bool _hasFailed = false;
+    ivec2 _size = ivec2{ 0, 0 };
+    /// The sequence number of the frame that has to be written next
+    uint64_t _nextSequence = 0;
+    std::set<uint64_t> _droppedFrames;
+    /// The last frame that was written, used to replace the dropped frames
+    std::vector<unsigned char> _lastFrame;
+    std::vector<std::vector<unsigned char>> _freeBuffers;
+    unsigned int _nRepeatedFrames = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__VIDEOCAPTURESINK__H__
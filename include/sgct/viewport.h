@@ -13,6 +13,7 @@
 
 #include <sgct/correctionmesh.h>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -29,19 +30,43 @@ namespace sgct::config {
 
 namespace sgct {
 
+class Image;
 class NonLinearProjection;
 
 /// This class holds and manages viewportdata and calculates frustums
 class Viewport : public BaseViewport {
 public:
     Viewport(const Window* parent);
+    ~Viewport();
 
     void initialize(vec2 size, bool hasStereo, unsigned int internalFormat,
         unsigned int format, unsigned int type, int samples);
 
     void applyViewport(const sgct::config::Viewport& viewport);
     void applySettings(const sgct::config::MpcdiProjection& mpcdi);
-    void setMpcdiWarpMesh(std::vector<char> data);
+
+    /// Sets the warping mesh that was built from the MPCDI file of the window
+    void setMpcdiWarpMesh(correction::Buffer mesh);
+
+    /**
+     * Returns the files that readData reads for this viewport. The warping mesh of an
+     * MPCDI file is not included, as it is not read from a file of its own.
+     */
+    std::vector<std::string> dataFiles() const;
+
+    /**
+     * Parses the correction mesh and decodes the mask images of this viewport. This does
+     * not need an OpenGL context, so it is called on a worker thread while the windows
+     * are initialized and the results are uploaded by loadData. \p window is the state
+     * of this viewport's window, which has to be copied on the render thread.
+     */
+    void readData(const CorrectionMesh::WindowState& window);
+
+    /**
+     * Uploads the correction mesh and the mask textures of this viewport. Everything that
+     * was not read by readData before is read here. If the data was loaded before, the
+     * textures are replaced and the buffers of the mesh are reused.
+     */
     void loadData();
 
     /// Render the viewport mesh which the framebuffer texture is attached to
@@ -53,16 +78,25 @@ public:
     /// Render the viewport mesh which the framebuffer texture is attached to
     void renderMaskMesh() const;
 
+    /// Render the quad that applies the warp map, which replaces renderWarpMesh
+    void renderWarpMap() const;
+
     bool hasOverlayTexture() const;
     bool hasBlendMaskTexture() const;
     bool hasBlackLevelMaskTexture() const;
+    bool hasWarpMap() const;
     bool hasSubViewports() const;
     bool isTracked() const;
     unsigned int overlayTextureIndex() const;
     unsigned int blendMaskTextureIndex() const;
     unsigned int blackLevelMaskTextureIndex() const;
     NonLinearProjection* nonLinearProjection() const;
-    const std::vector<char>& mpcdiWarpMesh() const;
+
+    /**
+     * Returns the warping mesh that was set by setMpcdiWarpMesh and releases it, as it
+     * is only needed until the mesh is uploaded.
+     */
+    std::optional<correction::Buffer> takeMpcdiWarpMesh();
 
 private:
     void applyPlanarProjection(const config::PlanarProjection& proj);
@@ -77,15 +111,22 @@ private:
     std::string _blendMaskFilename;
     std::string _blackLevelMaskFilename;
     std::string _meshFilename;
+    bool _useWarpMap = false;
+    bool _isDataLoaded = false;
     bool _isTracked = false;
     unsigned int _overlayTextureIndex = 0;
     unsigned int _blendMaskTextureIndex = 0;
     unsigned int _blackLevelMaskTextureIndex = 0;
 
+    // The mask images that were decoded by readData and are waiting to be uploaded
+    std::unique_ptr<Image> _overlayImage;
+    std::unique_ptr<Image> _blendMaskImage;
+    std::unique_ptr<Image> _blackLevelMaskImage;
+
     // @TODO (abock, 2020-01-06) This can be replace with a std::variant as we have a
     // fixed list of overloads and this would remove the virtual function calls
     std::unique_ptr<NonLinearProjection> _nonLinearProjection;
-    std::vector<char> _mpcdiWarpMesh;
+    std::optional<correction::Buffer> _mpcdiWarpMesh;
 };
 
 } // namespace sgct
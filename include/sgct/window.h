@@ -99,12 +99,21 @@ public:
     /// Init context specific data such as viewport corrections/warping meshes
     void initContextSpecificOGL();
 
+    /**
+     * Uploads the correction data of the provided viewports again after it was read by
+     * Viewport::readData. Viewports that belong to other windows are ignored.
+     */
+    void reloadViewportData(const std::vector<Viewport*>& viewports);
+
     /// Swap previous data and current data. This is done at the end of the render loop.
     void swap(bool takeScreenshot);
+
+    /// Ends the video streams of the screen captures once a continuous recording stops
+    void finishRecording();
     void updateResolutions();
 
     /// \return true if frame buffer is resized and window is visible.
-    void update();
+    bool update();
 
     /**
      * This function is used internally within sgct to open the window.
@@ -163,6 +172,16 @@ public:
      */
     void setFramebufferResolution(ivec2 resolution);
 
+    /**
+     * Sets the scale that is applied to the framebuffer resolution and to the cubemap
+     * resolution of non-linear projections. The warping and blending into the window is
+     * still performed at the full window resolution. The change is deferred until the
+     * next call to updateResolutions.
+     *
+     * \param scale The scale factor, where 1 renders at the full framebuffer resolution
+     */
+    void setResolutionScale(float scale);
+
     /**
      * Set this window's position in screen coordinates.
      *
@@ -309,6 +328,9 @@ public:
     /// \return Get the frame buffer resolution.
     ivec2 framebufferResolution() const;
 
+    /// \return Get the scale that is currently applied to the frame buffer resolution.
+    float resolutionScale() const;
+
     /// \return Get the initial window resolution.
     ivec2 initialResolution() const;
 
@@ -381,7 +403,11 @@ private:
     bool _setWindowPos = false;
     bool _isDecorated = true;
     bool _hasAlpha = false;
+    bool _hasResolutionScaleChanged = false;
     ivec2 _framebufferRes = ivec2{ 512, 256 };
+    ivec2 _unscaledFramebufferRes = ivec2{ 512, 256 };
+    float _resolutionScale = 1.f;
+    std::optional<float> _pendingResolutionScale;
     ivec2 _windowInitialRes = ivec2{ 640, 480 };
     std::optional<ivec2> _pendingWindowRes;
     std::optional<ivec2> _pendingFramebufferRes;
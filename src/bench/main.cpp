@@ -0,0 +1,1013 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+// Micro-benchmarks for the CPU-side hot paths of SGCT. None of the benchmarks require an
+// OpenGL context, so this executable can be run on build machines to track performance
+// across releases. The results are written to stdout as JSON (default) or CSV; every log
+// message is redirected to stderr to keep the output machine-readable
+
+#include <sgct/error.h>
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/math.h>
+#include <sgct/network.h>
+#include <sgct/projection.h>
+#include <sgct/readconfig.h>
+#include <sgct/shareddata.h>
+#include <sgct/version.h>
+#include <sgct/correction/domeprojection.h>
+#include <sgct/correction/mpcdimesh.h>
+#include <sgct/correction/obj.h>
+#include <sgct/correction/paulbourke.h>
+#include <sgct/correction/pfm.h>
+#include <sgct/correction/scalable.h>
+#include <sgct/correction/simcad.h>
+#include <sgct/projection/projectionplane.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+#include <WinSock2.h>
+#endif // WIN32
+
+using namespace sgct;
+
+namespace {
+    namespace fs = std::filesystem;
+
+    struct Options {
+        enum class Format { Json, Csv };
+
+        Format format = Format::Json;
+        std::string filter;
+        std::string output;
+        std::string configFolder = SGCT_BENCH_CONFIG_FOLDER;
+        int nSamples = 15;
+        double minSampleTime = 0.01;
+        int meshSize = 128;
+        int port = 20501;
+    };
+    Options options;
+
+    struct Result {
+        std::string name;
+        std::string parameter;
+        // Number of bytes that are processed in each iteration, 0 if not applicable
+        std::size_t bytes = 0;
+        int nSamples = 0;
+        int nIterations = 0;
+        // All timings are in nanoseconds per iteration
+        double min = 0.0;
+        double median = 0.0;
+        double mean = 0.0;
+        double max = 0.0;
+        double stddev = 0.0;
+        std::string status = "ok";
+        std::string message;
+    };
+    std::vector<Result> results;
+
+    // Results of the benchmarked functions are accumulated in here to prevent the
+    // compiler from optimizing the calls away
+    volatile std::size_t Sink = 0;
+
+    std::string sizeLabel(std::size_t bytes) {
+        if (bytes >= 1024 * 1024 && bytes % (1024 * 1024) == 0) {
+            return std::to_string(bytes / (1024 * 1024)) + "MiB";
+        }
+        else if (bytes >= 1024 && bytes % 1024 == 0) {
+            return std::to_string(bytes / 1024) + "KiB";
+        }
+        else {
+            return std::to_string(bytes) + "B";
+        }
+    }
+
+    bool isFiltered(const std::string& name, const std::string& parameter) {
+        if (options.filter.empty()) {
+            return false;
+        }
+        const std::string fullName = parameter.empty() ? name : name + '/' + parameter;
+        return fullName.find(options.filter) == std::string::npos;
+    }
+
+    template <typename F>
+    double timeIterations(F& fn, int nIterations) {
+        const auto begin = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < nIterations; ++i) {
+            fn();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - begin).count();
+    }
+
+    template <typename F>
+    void benchmark(std::string name, std::string parameter, std::size_t bytes, F fn) {
+        if (isFiltered(name, parameter)) {
+            return;
+        }
+
+        std::cerr << "Running " << name << ' ' << parameter << '\n';
+
+        Result res;
+        res.name = std::move(name);
+        res.parameter = std::move(parameter);
+        res.bytes = bytes;
+        try {
+            // Warm up caches and lazily initialized state before measuring
+            fn();
+
+            // Fast functions are run in batches that are long enough to not be dominated
+            // by the resolution of the clock
+            constexpr const int MaxIterations = 1 << 24;
+            int nIterations = 1;
+            while (nIterations < MaxIterations &&
+                   timeIterations(fn, nIterations) < options.minSampleTime)
+            {
+                nIterations *= 2;
+            }
+
+            std::vector<double> samples(options.nSamples);
+            for (double& s : samples) {
+                s = timeIterations(fn, nIterations) * 1e9 / nIterations;
+            }
+            std::sort(samples.begin(), samples.end());
+
+            const double n = static_cast<double>(samples.size());
+            res.nSamples = static_cast<int>(samples.size());
+            res.nIterations = nIterations;
+            res.min = samples.front();
+            res.max = samples.back();
+            res.median = samples[samples.size() / 2];
+            res.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+            double variance = 0.0;
+            for (double s : samples) {
+                variance += (s - res.mean) * (s - res.mean);
+            }
+            res.stddev = std::sqrt(variance / n);
+        }
+        catch (const std::exception& e) {
+            res.status = "error";
+            res.message = e.what();
+        }
+        results.push_back(std::move(res));
+    }
+
+    void skip(std::string name, std::string parameter, std::string reason) {
+        if (isFiltered(name, parameter)) {
+            return;
+        }
+
+        Result res;
+        res.name = std::move(name);
+        res.parameter = std::move(parameter);
+        res.status = "skipped";
+        res.message = std::move(reason);
+        results.push_back(std::move(res));
+    }
+
+    void writeFile(const fs::path& path, const std::string& content) {
+        std::ofstream file(path, std::ios::binary);
+        file.write(content.data(), content.size());
+    }
+
+
+    //
+    // Serialization and SharedData
+    //
+    constexpr const std::size_t PayloadSizes[] = { 16, 1024, 64 * 1024, 1024 * 1024 };
+
+    std::vector<std::byte> payload(std::size_t size) {
+        std::vector<std::byte> res(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            res[i] = static_cast<std::byte>(i * 31 + 7);
+        }
+        return res;
+    }
+
+    void benchmarkSerialization() {
+        for (std::size_t size : PayloadSizes) {
+            const std::vector<std::byte> data = payload(size);
+
+            benchmark("serialize.vector", sizeLabel(size), size, [&]() {
+                std::vector<std::byte> buffer;
+                serializeObject(buffer, data);
+                Sink += buffer.size();
+            });
+
+            std::vector<std::byte> buffer;
+            serializeObject(buffer, data);
+            benchmark("deserialize.vector", sizeLabel(size), size, [&]() {
+                unsigned int pos = 0;
+                std::vector<std::byte> res;
+                deserializeObject(buffer, pos, res);
+                Sink += res.size();
+            });
+        }
+
+        // Applications usually serialize a large number of individual values instead of
+        // a single large blob, which exercises the per-call overhead instead
+        constexpr const int NScalars = 1024;
+        benchmark("serialize.scalars", std::to_string(NScalars), NScalars * 4, []() {
+            std::vector<std::byte> buffer;
+            for (int i = 0; i < NScalars; ++i) {
+                serializeObject(buffer, static_cast<float>(i));
+            }
+            Sink += buffer.size();
+        });
+
+        std::vector<std::byte> scalars;
+        for (int i = 0; i < NScalars; ++i) {
+            serializeObject(scalars, static_cast<float>(i));
+        }
+        benchmark("deserialize.scalars", std::to_string(NScalars), NScalars * 4, [&]() {
+            unsigned int pos = 0;
+            float sum = 0.f;
+            for (int i = 0; i < NScalars; ++i) {
+                float v;
+                deserializeObject(scalars, pos, v);
+                sum += v;
+            }
+            Sink += static_cast<std::size_t>(sum);
+        });
+
+        const std::string text(1024, 'x');
+        benchmark("serialize.string", sizeLabel(text.size()), text.size(), [&]() {
+            std::vector<std::byte> buffer;
+            serializeObject(buffer, text);
+            Sink += buffer.size();
+        });
+
+        std::vector<std::byte> textBuffer;
+        serializeObject(textBuffer, text);
+        benchmark("deserialize.string", sizeLabel(text.size()), text.size(), [&]() {
+            unsigned int pos = 0;
+            std::string res;
+            deserializeObject(textBuffer, pos, res);
+            Sink += res.size();
+        });
+    }
+
+    void benchmarkSharedData() {
+        SharedData& sharedData = SharedData::instance();
+        for (std::size_t size : PayloadSizes) {
+            const std::vector<std::byte> data = payload(size);
+
+            sharedData.setEncodeFunction([&data]() {
+                std::vector<std::byte> buffer;
+                serializeObject(buffer, data);
+                return buffer;
+            });
+            benchmark("shareddata.encode", sizeLabel(size), size, [&]() {
+                sharedData.encode();
+                Sink += sharedData.dataSize();
+            });
+
+            // The clients receive everything that follows the network header, which
+            // includes SGCT's own state block in front of the user data
+            sharedData.encode();
+            const std::byte* block = reinterpret_cast<std::byte*>(sharedData.dataBlock());
+            const std::vector<std::byte> received(
+                block + Network::HeaderSize,
+                block + sharedData.dataSize()
+            );
+            sharedData.setDecodeFunction(
+                [](const std::vector<std::byte>& buffer, unsigned int pos) {
+                    std::vector<std::byte> res;
+                    deserializeObject(buffer, pos, res);
+                    Sink += res.size();
+                }
+            );
+            benchmark("shareddata.decode", sizeLabel(size), size, [&]() {
+                sharedData.decode(
+                    reinterpret_cast<const char*>(received.data()),
+                    static_cast<int>(received.size())
+                );
+            });
+        }
+        sharedData.setEncodeFunction(nullptr);
+        sharedData.setDecodeFunction(nullptr);
+    }
+
+
+    //
+    // Network
+    //
+    template <typename P>
+    bool waitFor(P predicate) {
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > timeout) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    void benchmarkNetwork() {
+        auto isSkipped = [](std::size_t size) {
+            return isFiltered("network.loopback", sizeLabel(size));
+        };
+        if (std::all_of(std::begin(PayloadSizes), std::end(PayloadSizes), isSkipped)) {
+            return;
+        }
+
+#ifdef WIN32
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif // WIN32
+
+        constexpr const Network::ConnectionType Sync =
+            Network::ConnectionType::SyncConnection;
+        std::unique_ptr<Network> server;
+        std::unique_ptr<Network> client;
+        std::atomic_int nReceived = 0;
+        std::string error;
+        try {
+            const int port = options.port;
+            const std::string address = "127.0.0.1";
+            server = std::make_unique<Network>(port, address, true, Sync);
+            server->setDecodeFunction([&nReceived](const char*, int) { nReceived++; });
+            server->initialize();
+
+            client = std::make_unique<Network>(port, address, false, Sync);
+            client->initialize();
+
+            const bool connected = waitFor([&]() {
+                return server->isConnected() && client->isConnected();
+            });
+            if (!connected) {
+                error = "Timeout while establishing the loopback connection";
+            }
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        for (std::size_t size : PayloadSizes) {
+            if (!error.empty()) {
+                skip("network.loopback", sizeLabel(size), error);
+                continue;
+            }
+
+            // The sync header is [DataId][int32 frame][uint32 size][uint32 uncompressed]
+            std::vector<char> message(Network::HeaderSize + size);
+            message[0] = Network::DataId;
+            const int32_t frame = 0;
+            const uint32_t dataSize = static_cast<uint32_t>(size);
+            std::memcpy(message.data() + 1, &frame, sizeof(int32_t));
+            std::memcpy(message.data() + 5, &dataSize, sizeof(uint32_t));
+            std::memcpy(message.data() + 9, &dataSize, sizeof(uint32_t));
+
+            // Measures the time from sending a message until the server has parsed the
+            // header and handed the payload to the decode callback
+            benchmark("network.loopback", sizeLabel(size), size, [&]() {
+                const int expected = nReceived + 1;
+                client->sendData(message.data(), static_cast<int>(message.size()));
+                while (nReceived < expected) {
+                    if (!server->isConnected()) {
+                        throw std::runtime_error("Loopback connection was lost");
+                    }
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        // Tearing down the connections causes the blocking receive calls to fail, which
+        // is expected and would only clutter the output
+        Log::instance().setLogCallback(nullptr);
+        if (client) {
+            client->initShutdown();
+            if (server) {
+                waitFor([&]() { return !server->isConnected(); });
+            }
+        }
+        if (server) {
+            server->initShutdown();
+        }
+        client = nullptr;
+        server = nullptr;
+
+#ifdef WIN32
+        WSACleanup();
+#endif // WIN32
+    }
+
+
+    //
+    // Correction meshes
+    //
+    std::string domeProjectionFile(int n) {
+        std::string res;
+        char line[128];
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                const float x = static_cast<float>(c) / (n - 1);
+                const float y = static_cast<float>(r) / (n - 1);
+                std::snprintf(
+                    line, sizeof(line), "%f;%f;%f;%f;%d;%d\n", x, y, x, y, c, r
+                );
+                res += line;
+            }
+        }
+        return res;
+    }
+
+    std::string scalableFile(int n) {
+        const int nFaces = 2 * (n - 1) * (n - 1);
+        std::string res;
+        res += "NATIVEXRES 1920\nNATIVEYRES 1080\n";
+        res += "ORTHO_LEFT -1.0\nORTHO_RIGHT 1.0\nORTHO_BOTTOM -1.0\nORTHO_TOP 1.0\n";
+        res += "VERTICES " + std::to_string(n * n) + '\n';
+        res += "FACES " + std::to_string(nFaces) + '\n';
+
+        char line[128];
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                const float s = static_cast<float>(c) / (n - 1);
+                const float t = static_cast<float>(r) / (n - 1);
+                std::snprintf(
+                    line, sizeof(line), "%f %f 255 %f %f\n",
+                    s * 1920.f, t * 1080.f, s, t
+                );
+                res += line;
+            }
+        }
+        for (int r = 0; r < n - 1; ++r) {
+            for (int c = 0; c < n - 1; ++c) {
+                const int i0 = r * n + c;
+                const int i1 = i0 + 1;
+                const int i2 = i0 + n + 1;
+                const int i3 = i0 + n;
+                std::snprintf(line, sizeof(line), "[ %d %d %d ]\n", i0, i1, i2);
+                res += line;
+                std::snprintf(line, sizeof(line), "[ %d %d %d ]\n", i0, i2, i3);
+                res += line;
+            }
+        }
+        return res;
+    }
+
+    std::string paulBourkeFile(int n) {
+        std::string res = "2\n" + std::to_string(n) + ' ' + std::to_string(n) + '\n';
+        char line[128];
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                const float s = static_cast<float>(c) / (n - 1);
+                const float t = static_cast<float>(r) / (n - 1);
+                const float x = 2.f * s - 1.f;
+                const float y = 2.f * t - 1.f;
+                std::snprintf(line, sizeof(line), "%f %f %f %f 1.0\n", x, y, s, t);
+                res += line;
+            }
+        }
+        return res;
+    }
+
+    // Generates a PFM image with one correction grid per eye placed side-by-side
+    std::string pfmFile(int n) {
+        std::string res = "PF\n" + std::to_string(2 * n) + ' ' + std::to_string(n);
+        res += "\n-1.000000\n";
+        std::vector<float> values;
+        values.reserve(3 * 2 * n * n);
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < 2 * n; ++c) {
+                values.push_back(static_cast<float>(c % n) / (n - 1));
+                values.push_back(static_cast<float>(r) / (n - 1));
+                values.push_back(0.f);
+            }
+        }
+        res.append(
+            reinterpret_cast<const char*>(values.data()),
+            values.size() * sizeof(float)
+        );
+        return res;
+    }
+
+    std::string simCADFile(int n) {
+        std::string corrections;
+        for (int i = 0; i < n * n; ++i) {
+            corrections += (i == 0 ? "" : " ");
+            corrections += std::to_string((i % 7) * 0.001f);
+        }
+
+        std::string res = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+        res += "<GeometryFile>\n<GeometryDefinition>\n";
+        res += "<X-FlatParameters range=\"1.0\">" + corrections + "</X-FlatParameters>\n";
+        res += "<Y-FlatParameters range=\"1.0\">" + corrections + "</Y-FlatParameters>\n";
+        res += "</GeometryDefinition>\n</GeometryFile>\n";
+        return res;
+    }
+
+    std::string objFile(int n) {
+        std::string res;
+        char line[128];
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                const float s = static_cast<float>(c) / (n - 1);
+                const float t = static_cast<float>(r) / (n - 1);
+                const float x = 2.f * s - 1.f;
+                const float y = 2.f * t - 1.f;
+                std::snprintf(line, sizeof(line), "v %f %f 0.0\n", x, y);
+                res += line;
+            }
+        }
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                const float s = static_cast<float>(c) / (n - 1);
+                const float t = static_cast<float>(r) / (n - 1);
+                std::snprintf(line, sizeof(line), "vt %f %f 0.0\n", s, t);
+                res += line;
+            }
+        }
+        for (int r = 0; r < n - 1; ++r) {
+            for (int c = 0; c < n - 1; ++c) {
+                // indices start at 1 in OBJ files
+                const int i0 = r * n + c + 1;
+                const int i1 = i0 + 1;
+                const int i2 = i0 + n + 1;
+                const int i3 = i0 + n;
+                std::snprintf(
+                    line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d\n",
+                    i0, i0, i0, i1, i1, i1, i2, i2, i2
+                );
+                res += line;
+                std::snprintf(
+                    line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d\n",
+                    i0, i0, i0, i2, i2, i2, i3, i3, i3
+                );
+                res += line;
+            }
+        }
+        return res;
+    }
+
+    std::vector<char> mpcdiMesh(int n) {
+        const std::string pfm = "PF\n" + std::to_string(n) + ' ' + std::to_string(n) +
+            "\n-1.000000\n";
+        std::vector<char> res(pfm.begin(), pfm.end());
+        for (int i = 0; i < n * n; ++i) {
+            const float values[3] = { 0.001f * (i % 7), 0.001f * (i % 5), 0.f };
+            const char* p = reinterpret_cast<const char*>(values);
+            res.insert(res.end(), p, p + sizeof(values));
+        }
+        return res;
+    }
+
+    void benchmarkCorrectionMeshes(const fs::path& tempFolder) {
+        using namespace correction;
+
+        const int n = options.meshSize;
+        const std::string grid = std::to_string(n) + 'x' + std::to_string(n);
+        const vec2 pos = vec2{ 0.f, 0.f };
+        const vec2 size = vec2{ 1.f, 1.f };
+
+        auto runLoader = [&](const std::string& name, const std::string& param,
+                             const fs::path& path, auto loader)
+        {
+            const std::size_t bytes = fs::file_size(path);
+            benchmark(name, param, bytes, [&]() {
+                Buffer buf = loader(path.string());
+                Sink += buf.vertices.size() + buf.indices.size();
+            });
+        };
+
+        const fs::path domeProjection = tempFolder / "domeprojection.csv";
+        writeFile(domeProjection, domeProjectionFile(n));
+        runLoader("correction.domeprojection", grid, domeProjection,
+            [&](const std::string& p) { return generateDomeProjectionMesh(p, pos, size); }
+        );
+
+        const fs::path scalable = tempFolder / "scalable.ol";
+        writeFile(scalable, scalableFile(n));
+        runLoader("correction.scalable", grid, scalable,
+            [&](const std::string& p) { return generateScalableMesh(p, pos, size); }
+        );
+
+        auto paulBourke = [&](const std::string& p) {
+            return generatePaulBourkeMesh(p, pos, size, 16.f / 9.f);
+        };
+        const fs::path paulBourkeMesh = tempFolder / "paulbourke.data";
+        writeFile(paulBourkeMesh, paulBourkeFile(n));
+        runLoader("correction.paulbourke", grid, paulBourkeMesh, paulBourke);
+        const fs::path meshFolder = fs::path(options.configFolder) / "mesh";
+        const fs::path sampleMesh = meshFolder / "standard_16x9.data";
+        if (fs::exists(sampleMesh)) {
+            const std::string param = sampleMesh.filename().string();
+            runLoader("correction.paulbourke", param, sampleMesh, paulBourke);
+        }
+
+        const fs::path pfm = tempFolder / "mesh.pfm";
+        writeFile(pfm, pfmFile(n));
+        runLoader("correction.pfm", grid, pfm,
+            [&](const std::string& p) {
+                return generatePerEyeMeshFromPFMImage(p, pos, size);
+            }
+        );
+
+        const fs::path simCAD = tempFolder / "simcad.simcad";
+        writeFile(simCAD, simCADFile(n));
+        runLoader("correction.simcad", grid, simCAD,
+            [&](const std::string& p) { return generateSimCADMesh(p, pos, size); }
+        );
+
+        const fs::path obj = tempFolder / "mesh.obj";
+        writeFile(obj, objFile(n));
+        runLoader("correction.obj", grid, obj, generateOBJMesh);
+        if (fs::is_directory(meshFolder)) {
+            std::vector<fs::path> objFiles;
+            for (const fs::directory_entry& entry : fs::directory_iterator(meshFolder)) {
+                if (entry.path().extension() == ".obj") {
+                    objFiles.push_back(entry.path());
+                }
+            }
+            std::sort(objFiles.begin(), objFiles.end());
+            for (const fs::path& p : objFiles) {
+                runLoader("correction.obj", p.filename().string(), p, generateOBJMesh);
+            }
+        }
+
+        const std::vector<char> mpcdi = mpcdiMesh(n);
+        benchmark("correction.mpcdi", grid, mpcdi.size(), [&]() {
+            // The file is handed out in chunks, the same way as it is decompressed
+            size_t offset = 0;
+            auto read = [&mpcdi, &offset](char* buffer, size_t size) -> size_t {
+                const size_t n = std::min(size, mpcdi.size() - offset);
+                std::memcpy(buffer, mpcdi.data() + offset, n);
+                offset += n;
+                return n;
+            };
+            Buffer buf = generateMpcdiMesh(read, mpcdi.size());
+            Sink += buf.vertices.size() + buf.indices.size();
+        });
+
+        // These loaders update the frustums of the viewport they belong to, which
+        // requires a fully initialized Engine
+        skip("correction.skyskan", grid, "Requires an initialized Engine");
+        skip("correction.sciss", grid, "Requires an initialized Engine");
+    }
+
+
+    //
+    // Configuration files
+    //
+    void benchmarkConfigs() {
+        const fs::path folder = options.configFolder;
+        if (!fs::is_directory(folder)) {
+            skip("readconfig", "", "Missing configuration folder " + folder.string());
+            return;
+        }
+
+        std::vector<fs::path> files;
+        for (const fs::directory_entry& entry : fs::directory_iterator(folder)) {
+            if (entry.path().extension() == ".xml") {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const fs::path& p : files) {
+            const std::size_t bytes = fs::file_size(p);
+            benchmark("readconfig", p.filename().string(), bytes, [&]() {
+                config::Cluster cluster = readConfig(p.string());
+                Sink += cluster.nodes.size();
+            });
+        }
+    }
+
+
+    //
+    // Images
+    //
+    void benchmarkImages(const fs::path& tempFolder) {
+        constexpr const ivec2 Resolution = ivec2{ 1920, 1080 };
+        const std::string res =
+            std::to_string(Resolution.x) + 'x' + std::to_string(Resolution.y);
+
+        Image image;
+        image.setSize(Resolution);
+        image.setChannels(4);
+        image.setBytesPerChannel(1);
+        image.allocateOrResizeData();
+
+        // A gradient with some noise is a more representative input for the encoders
+        // than a constant color, which would compress trivially
+        unsigned char* data = image.data();
+        const std::size_t nPixels = static_cast<std::size_t>(Resolution.x) * Resolution.y;
+        const std::size_t bytes = nPixels * 4;
+        uint32_t seed = 1;
+        for (int y = 0; y < Resolution.y; ++y) {
+            for (int x = 0; x < Resolution.x; ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                const std::size_t i = (static_cast<std::size_t>(y) * Resolution.x + x) *
+                    4;
+                data[i + 0] = static_cast<unsigned char>(x + (seed >> 28));
+                data[i + 1] = static_cast<unsigned char>(y + (seed >> 28));
+                data[i + 2] = static_cast<unsigned char>((x + y) / 2);
+                data[i + 3] = 255;
+            }
+        }
+
+        for (const char* extension : { "png", "tga", "jpg" }) {
+            const fs::path path = tempFolder / (std::string("image.") + extension);
+            const std::string param = std::string(extension) + '/' + res;
+
+            benchmark("image.save", param, bytes, [&]() { image.save(path.string()); });
+            benchmark("image.load", param, bytes, [&]() {
+                Image img;
+                img.load(path.string());
+                Sink += img.size().x;
+            });
+        }
+    }
+
+
+    //
+    // Logging
+    //
+    void benchmarkLog() {
+        Log& log = Log::instance();
+        std::atomic_int nMessages = 0;
+        log.setLogCallback([&nMessages](Log::Level, const char*) { nMessages++; });
+        log.setNotifyLevel(Log::Level::Info);
+
+        benchmark("log.printv", "short", 0, []() {
+            Log::Info("Frame %d took %f ms", 1234, 16.667);
+        });
+
+        const std::string message(1024, 'x');
+        benchmark("log.printv", "1KiB", message.size(), [&message]() {
+            Log::Info("%s", message.c_str());
+        });
+
+        // Messages below the notify level should be rejected before any formatting
+        benchmark("log.printv", "filtered", 0, []() {
+            Log::Debug("Frame %d took %f ms", 1234, 16.667);
+        });
+
+        log.setNotifyLevel(Log::Level::Warning);
+        Sink += nMessages;
+    }
+
+
+    //
+    // Projection
+    //
+    void benchmarkProjection() {
+        ProjectionPlane plane;
+        plane.setCoordinates(
+            vec3{ -1.778f, -1.f, -2.f },
+            vec3{ -1.778f, 1.f, -2.f },
+            vec3{ 1.778f, 1.f, -2.f }
+        );
+
+        Projection proj;
+        benchmark("projection.calculate", "mono", 0, [&]() {
+            proj.calculateProjection(vec3{ 0.f, 0.f, 0.f }, plane, 0.1f, 100.f);
+            Sink += static_cast<std::size_t>(proj.viewProjectionMatrix().values[0]);
+        });
+
+        const vec3 eyeOffset = vec3{ -0.0325f, 0.f, 0.f };
+        benchmark("projection.calculate", "stereo", 0, [&]() {
+            const vec3 base = vec3{ 0.f, 1.8f, 0.f };
+            proj.calculateProjection(base, plane, 0.1f, 100.f, eyeOffset);
+            Sink += static_cast<std::size_t>(proj.viewProjectionMatrix().values[0]);
+        });
+    }
+
+
+    //
+    // Output
+    //
+    std::string escapeJson(const std::string& str) {
+        std::string res;
+        for (char c : str) {
+            switch (c) {
+                case '"': res += "\\\""; break;
+                case '\\': res += "\\\\"; break;
+                case '\n': res += "\\n"; break;
+                case '\r': res += "\\r"; break;
+                case '\t': res += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        res += buf;
+                    }
+                    else {
+                        res += c;
+                    }
+            }
+        }
+        return res;
+    }
+
+    std::string escapeCsv(const std::string& str) {
+        if (str.find_first_of(",\"\n") == std::string::npos) {
+            return str;
+        }
+        std::string res = "\"";
+        for (char c : str) {
+            res += c;
+            if (c == '"') {
+                res += '"';
+            }
+        }
+        return res + '"';
+    }
+
+    double throughput(const Result& r) {
+        // MiB/s based on the median, 0 if the benchmark doesn't process a payload
+        if (r.bytes == 0 || r.median <= 0.0) {
+            return 0.0;
+        }
+        return (static_cast<double>(r.bytes) / (1024.0 * 1024.0)) / (r.median * 1e-9);
+    }
+
+    void writeJson(std::ostream& out) {
+        out << "{\n";
+        out << "  \"sgct_version\": \"" << Version << "\",\n";
+        out << "  \"samples\": " << options.nSamples << ",\n";
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            char buf[512];
+            std::snprintf(
+                buf, sizeof(buf),
+                "\"samples\": %d, \"iterations\": %d, \"min_ns\": %.1f, "
+                "\"median_ns\": %.1f, \"mean_ns\": %.1f, \"max_ns\": %.1f, "
+                "\"stddev_ns\": %.1f, \"bytes\": %zu, \"throughput_mibs\": %.2f",
+                r.nSamples, r.nIterations, r.min, r.median, r.mean, r.max, r.stddev,
+                r.bytes, throughput(r)
+            );
+            out << "    { \"name\": \"" << escapeJson(r.name) << "\", ";
+            out << "\"parameter\": \"" << escapeJson(r.parameter) << "\", ";
+            out << "\"status\": \"" << r.status << "\", ";
+            if (!r.message.empty()) {
+                out << "\"message\": \"" << escapeJson(r.message) << "\", ";
+            }
+            out << buf << " }" << (i + 1 < results.size() ? "," : "") << '\n';
+        }
+        out << "  ]\n";
+        out << "}\n";
+    }
+
+    void writeCsv(std::ostream& out) {
+        out << "name,parameter,status,samples,iterations,min_ns,median_ns,mean_ns,"
+               "max_ns,stddev_ns,bytes,throughput_mibs,message\n";
+        for (const Result& r : results) {
+            char buf[512];
+            std::snprintf(
+                buf, sizeof(buf), "%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%zu,%.2f",
+                r.nSamples, r.nIterations, r.min, r.median, r.mean, r.max, r.stddev,
+                r.bytes, throughput(r)
+            );
+            out << escapeCsv(r.name) << ',' << escapeCsv(r.parameter) << ',' <<
+                r.status << ',' << buf << ',' << escapeCsv(r.message) << '\n';
+        }
+    }
+
+    void printHelp() {
+        std::cerr <<
+            "Usage: sgct_bench [options]\n"
+            "  -format <json|csv>     Output format of the results (default: json)\n"
+            "  -output <path>         Writes the results to a file instead of stdout\n"
+            "  -filter <text>         Only runs benchmarks whose name contains <text>\n"
+            "  -samples <n>           Number of samples per benchmark (default: 15)\n"
+            "  -min-time <seconds>    Minimum duration of a sample (default: 0.01)\n"
+            "  -mesh-size <n>         Grid size of the generated correction meshes\n"
+            "  -config-folder <path>  Folder containing the sample configuration files\n"
+            "  -port <n>              Port used for the loopback network benchmark\n"
+            "  -help                  Shows this help message\n";
+    }
+
+    bool parseArguments(const std::vector<std::string>& args) {
+        size_t i = 0;
+        while (i < args.size()) {
+            const bool hasValue = i + 1 < args.size();
+            if (args[i] == "-format" && hasValue) {
+                if (args[i + 1] == "json") {
+                    options.format = Options::Format::Json;
+                }
+                else if (args[i + 1] == "csv") {
+                    options.format = Options::Format::Csv;
+                }
+                else {
+                    std::cerr << "Unknown format '" << args[i + 1] << "'\n";
+                    return false;
+                }
+                i += 2;
+            }
+            else if (args[i] == "-output" && hasValue) {
+                options.output = args[i + 1];
+                i += 2;
+            }
+            else if (args[i] == "-filter" && hasValue) {
+                options.filter = args[i + 1];
+                i += 2;
+            }
+            else if (args[i] == "-samples" && hasValue) {
+                options.nSamples = std::max(std::stoi(args[i + 1]), 1);
+                i += 2;
+            }
+            else if (args[i] == "-min-time" && hasValue) {
+                options.minSampleTime = std::stod(args[i + 1]);
+                i += 2;
+            }
+            else if (args[i] == "-mesh-size" && hasValue) {
+                options.meshSize = std::max(std::stoi(args[i + 1]), 2);
+                i += 2;
+            }
+            else if (args[i] == "-config-folder" && hasValue) {
+                options.configFolder = args[i + 1];
+                i += 2;
+            }
+            else if (args[i] == "-port" && hasValue) {
+                options.port = std::stoi(args[i + 1]);
+                i += 2;
+            }
+            else {
+                printHelp();
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    try {
+        if (!parseArguments(args)) {
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error parsing arguments: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    Log& log = Log::instance();
+    log.setLogToConsole(false);
+    log.setNotifyLevel(Log::Level::Warning);
+    auto logToStderr = [](Log::Level level, const char* message) {
+        if (level >= Log::Level::Warning) {
+            std::cerr << message << '\n';
+        }
+    };
+    log.setLogCallback(logToStderr);
+
+    const fs::path tempFolder = fs::temp_directory_path() / "sgct_bench";
+    fs::create_directories(tempFolder);
+
+    benchmarkSerialization();
+    benchmarkSharedData();
+    benchmarkNetwork();
+    log.setLogCallback(logToStderr);
+    benchmarkCorrectionMeshes(tempFolder);
+    benchmarkConfigs();
+    benchmarkImages(tempFolder);
+    benchmarkLog();
+    log.setLogCallback(logToStderr);
+    benchmarkProjection();
+
+    std::error_code ec;
+    fs::remove_all(tempFolder, ec);
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file.good()) {
+            std::cerr << "Could not open output file " << options.output << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+    if (options.format == Options::Format::Json) {
+        writeJson(out);
+    }
+    else {
+        writeCsv(out);
+    }
+
+    SharedData::destroy();
+    Log::destroy();
+    return EXIT_SUCCESS;
+}
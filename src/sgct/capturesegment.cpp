@@ -0,0 +1,174 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/capturesegment.h>
+
+#include <sgct/error.h>
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif // WIN32
+
+#define Err(code, msg) sgct::Error(sgct::Error::Component::Image, code, msg)
+
+namespace {
+    constexpr uint64_t roundUpToBlock(uint64_t size) {
+        using sgct::rawcapture::BlockSize;
+        return (size + BlockSize - 1) / BlockSize * BlockSize;
+    }
+
+    // Used as the source for the padding at the end of the blocks
+    const std::array<unsigned char, sgct::rawcapture::BlockSize> ZeroBlock = {};
+} // namespace
+
+namespace sgct::rawcapture {
+
+int bytesPerChannel(DataType type) {
+    switch (type) {
+        case DataType::UInt8: return 1;
+        case DataType::UInt16: return 2;
+        case DataType::Float16: return 2;
+        case DataType::Float32: return 4;
+        default: throw std::logic_error("Unhandled case label");
+    }
+}
+
+} // namespace sgct::rawcapture
+
+namespace sgct {
+
+CaptureSegmentWriter::CaptureSegmentWriter(std::string prefix, uint64_t segmentSize)
+    : _prefix(std::move(prefix))
+    , _segmentSize(segmentSize)
+{}
+
+CaptureSegmentWriter::~CaptureSegmentWriter() {
+    closeSegment();
+}
+
+void CaptureSegmentWriter::appendFrame(rawcapture::FrameHeader header,
+                                       const unsigned char* data)
+{
+    ZoneScoped
+
+    header.recordSize = rawcapture::BlockSize + roundUpToBlock(header.dataSize);
+
+    std::unique_lock lock(_mutex);
+    // A frame that is larger than a segment gets a segment of its own
+    const bool isEmpty = _offset == rawcapture::BlockSize;
+    if (!_file || (_offset + header.recordSize > _segmentSize && !isEmpty)) {
+        closeSegment();
+        openSegment();
+    }
+
+    std::array<unsigned char, rawcapture::BlockSize> block = {};
+    std::memcpy(block.data(), &header, sizeof(header));
+
+    const uint64_t padding = header.recordSize - rawcapture::BlockSize - header.dataSize;
+    const bool success =
+        fwrite(block.data(), 1, block.size(), _file) == block.size() &&
+        fwrite(data, 1, header.dataSize, _file) == header.dataSize &&
+        fwrite(ZeroBlock.data(), 1, padding, _file) == padding;
+    if (!success) {
+        throw Err(9015, "Could not write to capture segment '" + _filename + "'");
+    }
+    _offset += header.recordSize;
+}
+
+void CaptureSegmentWriter::write(const Image& image, const Frame& frame) {
+    rawcapture::FrameHeader header;
+    header.frameNumber = frame.frameNumber;
+    header.clusterFrameNumber = frame.clusterFrameNumber;
+    header.timestamp = frame.timestamp;
+    header.nodeId = frame.nodeId;
+    header.windowId = frame.windowId;
+    header.eye = frame.eye;
+    header.width = image.size().x;
+    header.height = image.size().y;
+    header.channels = image.channels();
+    header.dataType = frame.dataType;
+    header.dataSize = static_cast<uint64_t>(header.width) * header.height *
+        header.channels * image.bytesPerChannel();
+    appendFrame(header, image.data());
+}
+
+void CaptureSegmentWriter::openSegment() {
+    // Large enough for any int, so indices past 9999 simply get more digits
+    char index[12];
+    std::snprintf(index, sizeof(index), "%04d", _segmentIndex);
+    _filename = _prefix + "segment" + index + ".sgctraw";
+    _segmentIndex++;
+
+    _file = fopen(_filename.c_str(), "wb");
+    if (!_file) {
+        throw Err(9014, "Could not create capture segment '" + _filename + "'");
+    }
+    // The writes are already as large as possible, so buffering would only add a copy
+    setvbuf(_file, nullptr, _IONBF, 0);
+
+#ifdef __linux__
+    const int res = posix_fallocate(fileno(_file), 0, static_cast<off_t>(_segmentSize));
+    if (res != 0) {
+        Log::Warning("Could not preallocate capture segment '%s'", _filename.c_str());
+    }
+#endif // __linux__
+
+    std::array<unsigned char, rawcapture::BlockSize> block = {};
+    rawcapture::SegmentHeader header = {};
+    std::copy(
+        std::begin(rawcapture::SegmentMagic),
+        std::end(rawcapture::SegmentMagic),
+        std::begin(header.magic)
+    );
+    header.version = rawcapture::Version;
+    header.blockSize = rawcapture::BlockSize;
+    // Only the file name is stored as the segment might be moved before it is converted
+    const size_t slash = _prefix.find_last_of("/\\");
+    const std::string name = slash == std::string::npos ?
+        _prefix :
+        _prefix.substr(slash + 1);
+    std::strncpy(header.prefix, name.c_str(), sizeof(header.prefix) - 1);
+    std::memcpy(block.data(), &header, sizeof(header));
+
+    if (fwrite(block.data(), 1, block.size(), _file) != block.size()) {
+        throw Err(9015, "Could not write to capture segment '" + _filename + "'");
+    }
+    _offset = rawcapture::BlockSize;
+
+    Log::Debug("Opened capture segment '%s'", _filename.c_str());
+}
+
+void CaptureSegmentWriter::closeSegment() {
+    if (!_file) {
+        return;
+    }
+
+#ifndef WIN32
+    // Remove the unused part of the preallocated space
+    if (ftruncate(fileno(_file), static_cast<off_t>(_offset)) != 0) {
+        Log::Warning("Could not truncate capture segment '%s'", _filename.c_str());
+    }
+#endif // WIN32
+
+    fclose(_file);
+    _file = nullptr;
+    Log::Debug(
+        "Closed capture segment '%s' (%llu bytes)",
+        _filename.c_str(), static_cast<unsigned long long>(_offset)
+    );
+}
+
+} // namespace sgct
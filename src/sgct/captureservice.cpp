@@ -0,0 +1,255 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/captureservice.h>
+
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    // The service is also used without a window, so the time does not come from GLFW
+    double seconds(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+} // namespace
+
+namespace sgct {
+
+CaptureService* CaptureService::_instance = nullptr;
+
+CaptureService& CaptureService::instance() {
+    if (!_instance) {
+        _instance = new CaptureService;
+    }
+    return *_instance;
+}
+
+void CaptureService::destroy() {
+    delete _instance;
+    _instance = nullptr;
+}
+
+CaptureService::CaptureService()
+    : _policy(Settings::instance().captureQueuePolicy())
+    , _queueSize(static_cast<size_t>(Settings::instance().captureQueueSize()))
+{
+    ZoneScoped
+
+    const int nThreads = Settings::instance().numberCaptureThreads();
+    Log::Debug("Number of screencapture threads is set to %d", nThreads);
+
+    _workers.reserve(nThreads);
+    for (int i = 0; i < nThreads; ++i) {
+        _workers.emplace_back(&CaptureService::workerLoop, this);
+    }
+}
+
+CaptureService::~CaptureService() {
+    {
+        std::unique_lock lock(_mutex);
+        _isStopping = true;
+    }
+    _jobAdded.notify_all();
+
+    // The workers save all jobs that are still queued before they exit
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+
+    const Statistics& s = _statistics;
+    if (s.nDropped > 0) {
+        Log::Warning("%u captured frames were dropped as the queue was full", s.nDropped);
+    }
+    if (s.nSaved > 0) {
+        Log::Debug(
+            "Saved %llu captured frames in %.2f ms on average (max %.2f ms). Longest "
+            "queue: %zu. Waited for the queue %u times for %.2f ms (max %.2f ms)",
+            static_cast<unsigned long long>(s.nSaved), s.saveTime / s.nSaved * 1000.0,
+            s.maxSaveTime * 1000.0, s.maxQueueDepth, s.nWaits, s.waitTime * 1000.0,
+            s.maxWaitTime * 1000.0
+        );
+    }
+}
+
+std::unique_ptr<Image> CaptureService::acquireImage(ivec2 size, int channels,
+                                                    int bytesPerChannel)
+{
+    {
+        std::unique_lock lock(_mutex);
+        auto it = std::find_if(
+            _freeImages.begin(), _freeImages.end(),
+            [&](const std::unique_ptr<Image>& img) {
+                return img->size().x == size.x && img->size().y == size.y &&
+                    img->channels() == channels &&
+                    img->bytesPerChannel() == bytesPerChannel;
+            }
+        );
+        if (it != _freeImages.end()) {
+            std::unique_ptr<Image> res = std::move(*it);
+            _freeImages.erase(it);
+            return res;
+        }
+    }
+
+    auto res = std::make_unique<Image>();
+    res->setBytesPerChannel(bytesPerChannel);
+    res->setChannels(channels);
+    res->setSize(std::move(size));
+    res->allocateOrResizeData();
+    return res;
+}
+
+bool CaptureService::submit(std::unique_ptr<Image> image, std::string filename) {
+    Job job;
+    job.image = std::move(image);
+    job.filename = std::move(filename);
+    return enqueue(std::move(job));
+}
+
+bool CaptureService::submit(std::unique_ptr<Image> image,
+                            std::shared_ptr<CaptureSink> sink, CaptureSink::Frame frame)
+{
+    Job job;
+    job.image = std::move(image);
+    job.sink = std::move(sink);
+    job.frame = frame;
+    return enqueue(std::move(job));
+}
+
+bool CaptureService::enqueue(Job job) {
+    ZoneScoped
+
+    if (_workers.empty()) {
+        const double time = save(job);
+        std::unique_lock lock(_mutex);
+        recordSave(time);
+        recycleImage(std::move(job.image));
+        return true;
+    }
+
+    {
+        std::unique_lock lock(_mutex);
+        if (_jobs.size() >= _queueSize) {
+            switch (_policy) {
+                case Settings::CaptureQueuePolicy::Block:
+                {
+                    ZoneScopedN("Wait for capture queue")
+                    const auto start = std::chrono::steady_clock::now();
+                    _jobTaken.wait(lock, [this]() { return _jobs.size() < _queueSize; });
+                    const double wait = seconds(std::chrono::steady_clock::now() - start);
+                    _statistics.nWaits++;
+                    _statistics.waitTime += wait;
+                    _statistics.maxWaitTime = std::max(_statistics.maxWaitTime, wait);
+                    TracyPlot("Capture queue wait (ms)", wait * 1000.0);
+                    break;
+                }
+                case Settings::CaptureQueuePolicy::Drop:
+                {
+                    _statistics.nDropped++;
+                    TracyPlot(
+                        "Dropped captures",
+                        static_cast<int64_t>(_statistics.nDropped)
+                    );
+                    Log::Debug("Dropping captured frame");
+                    recycleImage(std::move(job.image));
+                    lock.unlock();
+                    // The sink is notified outside of the lock as it might have to wait
+                    // for locks of its own that the workers are holding
+                    if (job.sink) {
+                        job.sink->drop(job.frame);
+                    }
+                    return false;
+                }
+                case Settings::CaptureQueuePolicy::Grow:
+                    break;
+                default: throw std::logic_error("Unhandled case label");
+            }
+        }
+        _jobs.push_back(std::move(job));
+        _statistics.maxQueueDepth = std::max(_statistics.maxQueueDepth, _jobs.size());
+        TracyPlot("Capture queue", static_cast<int64_t>(_jobs.size()));
+    }
+    _jobAdded.notify_one();
+    return true;
+}
+
+unsigned int CaptureService::droppedJobs() const {
+    std::unique_lock lock(_mutex);
+    return _statistics.nDropped;
+}
+
+CaptureService::Statistics CaptureService::statistics() const {
+    std::unique_lock lock(_mutex);
+    Statistics res = _statistics;
+    res.queueDepth = _jobs.size();
+    return res;
+}
+
+void CaptureService::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(_mutex);
+            _jobAdded.wait(lock, [this]() { return _isStopping || !_jobs.empty(); });
+            if (_jobs.empty()) {
+                // We are stopping and there is nothing left to save
+                return;
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        _jobTaken.notify_one();
+
+        const double time = save(job);
+
+        std::unique_lock lock(_mutex);
+        recordSave(time);
+        recycleImage(std::move(job.image));
+    }
+}
+
+double CaptureService::save(Job& job) {
+    ZoneScoped
+
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        if (job.sink) {
+            job.sink->write(*job.image, job.frame);
+        }
+        else {
+            job.image->save(job.filename);
+        }
+    }
+    catch (const std::runtime_error& e) {
+        Log::Error("%s", e.what());
+    }
+    return seconds(std::chrono::steady_clock::now() - start);
+}
+
+void CaptureService::recordSave(double time) {
+    _statistics.nSaved++;
+    _statistics.saveTime += time;
+    _statistics.maxSaveTime = std::max(_statistics.maxSaveTime, time);
+    TracyPlot("Capture save time (ms)", time * 1000.0);
+}
+
+void CaptureService::recycleImage(std::unique_ptr<Image> image) {
+    // Every image that can be queued or in flight can be reused, any more than that
+    // would only be kept alive after a change in resolution. The oldest images are the
+    // ones that are most likely to have an outdated size, so they are removed first
+    if (_freeImages.size() >= _queueSize + _workers.size()) {
+        _freeImages.erase(_freeImages.begin());
+    }
+    _freeImages.push_back(std::move(image));
+}
+
+} // namespace sgct
@@ -176,6 +176,10 @@ User* ClusterManager::trackedUser() {
     return it != _users.cend() ? it->get() : nullptr;
 }
 
+const std::vector<std::unique_ptr<User>>& ClusterManager::users() const {
+    return _users;
+}
+
 bool ClusterManager::ignoreSync() const {
     return _ignoreSync;
 }
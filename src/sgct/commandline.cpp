@@ -73,6 +73,27 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.captureFormat = Settings::CaptureFormat::JPG;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "-capture-raw") {
+            config.captureFormat = Settings::CaptureFormat::Raw;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "-capture-video") {
+            config.captureFormat = Settings::CaptureFormat::Video;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "-capture-video-command" && arg.size() > (i + 1)) {
+            config.captureFormat = Settings::CaptureFormat::Video;
+            config.captureVideoCommand = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "-capture-shm") {
+            config.captureFormat = Settings::CaptureFormat::SharedMemory;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "-record") {
+            config.record = true;
+            arg.erase(arg.begin() + i);
+        }
         else if (arg[i] == "-number-capture-threads" && arg.size() > (i + 1)) {
             config.nCaptureThreads = std::stoi(arg[i + 1]);
             arg.erase(arg.begin() + i, arg.begin() + i + 2);
@@ -81,6 +102,22 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.exportCorrectionMeshes = true;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "-correction-mesh-cache" && arg.size() > (i + 1)) {
+            config.correctionMeshCachePath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "-no-correction-mesh-cache") {
+            config.useCorrectionMeshCache = false;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "-correction-mesh-tolerance" && arg.size() > (i + 1)) {
+            config.correctionMeshTolerance = std::stof(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "-watch-correction-files") {
+            config.watchCorrectionFiles = true;
+            arg.erase(arg.begin() + i);
+        }
         else if (arg[i] == "-screenshot-path") {
             config.screenshotPath = arg[i + 1];
             arg.erase(arg.begin() + i, arg.begin() + i + 2);
@@ -97,6 +134,18 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.omitWindowNameInScreenshot = true;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "-benchmark-frames" && arg.size() > (i + 1)) {
+            config.benchmarkFrames = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "-benchmark-seconds" && arg.size() > (i + 1)) {
+            config.benchmarkSeconds = std::stod(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "-software-gl") {
+            config.useSoftwareOpenGL = true;
+            arg.erase(arg.begin() + i);
+        }
         else {
             // Ignore unknown commands
             i++;
@@ -131,8 +180,32 @@ Parameters:
     Use jpg images for screen capture
 -capture-tga
     Use tga images for screen capture
+-capture-raw
+    Append the unencoded frames to segment files for screen capture that can be
+    converted into images with sgct-capture-convert
+-capture-video
+    Write the captured frames of each window as a continuous Y4M video file
+-capture-video-command <command>
+    Pipe the Y4M video into the standard input of <command>, for example an encoder.
+    {file} in the command is replaced by the name the video file would have had
+-capture-shm
+    Publish the captured frames of each window into a shared memory ring buffer that
+    other processes on the same computer can read from
+-record
+    Capture every frame from the start until Engine::stopRecording is called
 -export-correction-meshes
     Exports the correction warping meshes to OBJ files when loading them
+-correction-mesh-cache <path>
+    Sets the folder in which parsed correction meshes are cached, so that they are not
+    parsed again at the next start (default: a folder in the temporary directory)
+-no-correction-mesh-cache
+    Always parses the correction meshes instead of reading them from the cache
+-correction-mesh-tolerance <pixels>
+    Simplifies dense grid correction meshes as long as the texture coordinates do not
+    move by more than <pixels> (default: 0, which disables the simplification)
+-watch-correction-files
+    Reloads the correction meshes and masks of a viewport when its files are changed,
+    on all nodes in the same frame
 -screenshot-path
     Sets the file path for the screenshots location
 -screenshot-prefix
@@ -143,6 +216,14 @@ Parameters:
     If set, screenshots will not contain the name of the window if multiple windows exist
 -number-capture-threads <integer>
     Set the maximum amount of thread that should be used during framecapture
+-benchmark-frames <integer>
+    Runs the configuration with hidden windows and disabled vsync for the provided
+    number of frames, prints a timing report and exits
+-benchmark-seconds <float>
+    Runs the configuration with hidden windows and disabled vsync for the provided
+    number of seconds, prints a timing report and exits
+-software-gl
+    Request a software OpenGL implementation (currently only supported with Mesa)
 )";
 }
 
@@ -49,6 +49,33 @@ void validateCapture(const Capture& c) {
     if (c.path && c.path->empty()) {
         throw Error(1010, "Capture path must not be empty");
     }
+    if (c.readbackBuffers && *c.readbackBuffers < 1) {
+        throw Error(1011, "Number of capture readback buffers must be positive");
+    }
+    if (c.queueSize && *c.queueSize < 1) {
+        throw Error(1012, "Capture queue size must be positive");
+    }
+    if (c.segmentSize && *c.segmentSize < 1) {
+        throw Error(1014, "Capture segment size must be positive");
+    }
+    if (c.videoCommand && c.videoCommand->empty()) {
+        throw Error(1015, "Video capture command must not be empty");
+    }
+    if (c.videoFrameRate && *c.videoFrameRate <= 0.f) {
+        throw Error(1016, "Video capture frame rate must be positive");
+    }
+    if (c.sharedMemoryName && c.sharedMemoryName->empty()) {
+        throw Error(1017, "Shared memory capture name must not be empty");
+    }
+    if (c.sharedMemorySlots && *c.sharedMemorySlots < 1) {
+        throw Error(1018, "Number of shared memory capture slots must be positive");
+    }
+    if (c.pngCompression && (*c.pngCompression < -1 || *c.pngCompression > 9)) {
+        throw Error(1013, "PNG compression level must be in the range [-1, 9]");
+    }
+    if (c.jpegQuality && (*c.jpegQuality < 1 || *c.jpegQuality > 100)) {
+        throw Error(1019, "JPEG quality must be in the range [1, 100]");
+    }
 }
 
 void validateScene(const Scene&) {}
@@ -62,6 +89,32 @@ void validateSettings(const Settings& s) {
     if (s.display && s.display->refreshRate && *s.display->refreshRate < 0) {
         throw Error(1021, "Refresh rate must not be negative");
     }
+    if (s.dynamicResolution) {
+        const Settings::DynamicResolution& dr = *s.dynamicResolution;
+        if (dr.targetFrameRate && *dr.targetFrameRate <= 0.f) {
+            throw Error(1022, "Dynamic resolution target frame rate must be positive");
+        }
+        if ((dr.minScale && (*dr.minScale <= 0.f || *dr.minScale > 1.f)) ||
+            (dr.maxScale && (*dr.maxScale <= 0.f || *dr.maxScale > 1.f)))
+        {
+            throw Error(1023, "Dynamic resolution scales must be in the range (0, 1]");
+        }
+        if (dr.minScale && dr.maxScale && *dr.minScale > *dr.maxScale) {
+            throw Error(1024, "Dynamic resolution minimum scale must not exceed maximum");
+        }
+        if (dr.step && *dr.step <= 0.f) {
+            throw Error(1025, "Dynamic resolution step must be positive");
+        }
+        if (dr.hysteresis && (*dr.hysteresis < 0.f || *dr.hysteresis >= 1.f)) {
+            throw Error(
+                1026,
+                "Dynamic resolution hysteresis must be in the range [0, 1)"
+            );
+        }
+        if (dr.frames && *dr.frames < 1) {
+            throw Error(1027, "Dynamic resolution must average over at least one frame");
+        }
+    }
 }
 
 void validateDevice(const Device& d) {
@@ -11,6 +11,7 @@
 #include <sgct/error.h>
 #include <sgct/log.h>
 #include <sgct/profiling.h>
+#include <sgct/correction/textparser.h>
 #include <glm/glm.hpp>
 #include <algorithm>
 
@@ -23,65 +24,66 @@ Buffer generateDomeProjectionMesh(const std::string& path, const vec2& pos,
 
     Log::Info("Reading DomeProjection mesh data from '%s'", path.c_str());
 
-    FILE* meshFile = fopen(path.c_str(), "r");
-    bool loadSuccess = meshFile != nullptr;
-    if (!loadSuccess) {
+    const std::optional<std::string> text = readTextFile(path);
+    if (!text) {
         throw Error(Error::Component::DomeProjection, 2010, "Failed to open " + path);
     }
 
     Buffer buf;
+    // Every line except for the header contains a vertex
+    buf.vertices.reserve(countLines(*text, ""));
 
     unsigned int nCols = 0;
     unsigned int nRows = 0;
-    while (!feof(meshFile)) {
-        constexpr const int MaxLineLength = 1024;
-        char lineBuf[MaxLineLength];
-        if (fgets(lineBuf, MaxLineLength, meshFile)) {
-            float x;
-            float y;
-            float u;
-            float v;
-            unsigned int col;
-            unsigned int row;
-
-            if (sscanf(lineBuf, "%f;%f;%f;%f;%u;%u", &x, &y, &u, &v, &col, &row) == 6) {
-                // init to max intensity (opaque white)
-                CorrectionMeshVertex vertex;
-                vertex.r = 1.f;
-                vertex.g = 1.f;
-                vertex.b = 1.f;
-                vertex.a = 1.f;
-
-                // find dimensions of meshdata
-                nCols = std::max(nCols, col);
-                nRows = std::max(nRows, row);
-
-                x = std::clamp(x, 0.f, 1.f);
-                y = std::clamp(y, 0.f, 1.f);
-
-                // convert to [-1, 1]
-                vertex.x = 2.f * (pos.x + x * size.x) - 1.f;
-
-                // (abock, 2019-08-30); I'm not sure why the y inversion happens
-                // here. It seems like a mistake, but who knows
-                vertex.y = 2.f * (pos.y + (1.f - y) * size.y) - 1.f;
-
-                // scale to viewport coordinates
-                vertex.s = pos.x + u * size.x;
-                vertex.t = pos.y + (1.f - v) * size.y;
-
-                buf.vertices.push_back(std::move(vertex));
-            }
+    std::string_view remaining = *text;
+    while (!remaining.empty()) {
+        LineParser line(nextLine(remaining));
+        float x;
+        float y;
+        float u;
+        float v;
+        unsigned int col;
+        unsigned int row;
+
+        const bool success =
+            line.read(x) && line.consume(";") && line.read(y) && line.consume(";") &&
+            line.read(u) && line.consume(";") && line.read(v) && line.consume(";") &&
+            line.read(col) && line.consume(";") && line.read(row);
+        if (success) {
+            // init to max intensity (opaque white)
+            CorrectionMeshVertex vertex;
+            vertex.r = 1.f;
+            vertex.g = 1.f;
+            vertex.b = 1.f;
+            vertex.a = 1.f;
+
+            // find dimensions of meshdata
+            nCols = std::max(nCols, col);
+            nRows = std::max(nRows, row);
+
+            x = std::clamp(x, 0.f, 1.f);
+            y = std::clamp(y, 0.f, 1.f);
+
+            // convert to [-1, 1]
+            vertex.x = 2.f * (pos.x + x * size.x) - 1.f;
+
+            // (abock, 2019-08-30); I'm not sure why the y inversion happens
+            // here. It seems like a mistake, but who knows
+            vertex.y = 2.f * (pos.y + (1.f - y) * size.y) - 1.f;
+
+            // scale to viewport coordinates
+            vertex.s = pos.x + u * size.x;
+            vertex.t = pos.y + (1.f - v) * size.y;
+
+            buf.vertices.push_back(std::move(vertex));
         }
     }
 
-    if (meshFile) {
-        fclose(meshFile);
-    }
-
     nCols++;
     nRows++;
 
+    buf.indices.resize(6 * static_cast<size_t>(nCols) * nRows);
+    unsigned int* index = buf.indices.data();
     for (unsigned int c = 0; c < nCols; ++c) {
         for (unsigned int r = 0; r < nRows; ++r) {
             // 3      2
@@ -99,13 +101,13 @@ Buffer generateDomeProjectionMesh(const std::string& path, const vec2& pos,
             const unsigned int i2 = (r + 1) * (nCols + 1) + (c + 1);
             const unsigned int i3 = (r + 1) * (nCols + 1) + c;
 
-            buf.indices.push_back(i0);
-            buf.indices.push_back(i1);
-            buf.indices.push_back(i2);
+            *index++ = i0;
+            *index++ = i1;
+            *index++ = i2;
 
-            buf.indices.push_back(i0);
-            buf.indices.push_back(i2);
-            buf.indices.push_back(i3);
+            *index++ = i0;
+            *index++ = i2;
+            *index++ = i3;
         }
     }
 
@@ -0,0 +1,41 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/gridmesh.h>
+
+#include <sgct/opengl.h>
+#include <cstddef>
+
+namespace sgct::correction {
+
+void createGridIndices(Buffer& buffer, unsigned int nCols, unsigned int nRows) {
+    buffer.geometryType = GL_TRIANGLE_STRIP;
+    buffer.gridColumns = nCols;
+    buffer.gridRows = nRows;
+    buffer.indices.clear();
+    if (nCols < 2 || nRows < 2) {
+        return;
+    }
+
+    // One strip with two indices per column for every row of quads, plus the restart
+    // indices between the strips
+    const size_t nStrips = nRows - 1;
+    buffer.indices.resize(nStrips * (2 * static_cast<size_t>(nCols) + 1) - 1);
+    unsigned int* index = buffer.indices.data();
+    for (unsigned int r = 0; r < nRows - 1; ++r) {
+        if (r > 0) {
+            *index++ = PrimitiveRestartIndex;
+        }
+        for (unsigned int c = 0; c < nCols; ++c) {
+            *index++ = (r + 1) * nCols + c;
+            *index++ = r * nCols + c;
+        }
+    }
+}
+
+} // namespace sgct::correction
@@ -0,0 +1,246 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/meshcache.h>
+
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+    namespace fs = std::filesystem;
+    using sgct::correction::CorrectionMeshVertex;
+
+    constexpr const char Magic[8] = { 'S', 'G', 'C', 'T', 'M', 'S', 'H', '\0' };
+    // Has to be increased whenever the file layout or the output of a parser changes
+    constexpr const uint32_t Version = 4;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t geometryType;
+        uint32_t gridColumns;
+        uint32_t gridRows;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint32_t sourceChecksum;
+        float parameters[7];
+        uint64_t nVertices;
+        uint64_t nIndices;
+    };
+
+    struct Source {
+        uint64_t size = 0;
+        int64_t time = 0;
+    };
+
+    std::optional<Source> sourceInfo(const std::string& path) {
+        std::error_code ec;
+        const uintmax_t size = fs::file_size(path, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        const fs::file_time_type time = fs::last_write_time(path, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        Source res;
+        res.size = size;
+        res.time = time.time_since_epoch().count();
+        return res;
+    }
+
+    std::optional<uint32_t> checksum(const std::string& path) {
+        ZoneScoped
+
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return std::nullopt;
+        }
+        std::vector<unsigned char> buffer(1024 * 1024);
+        uLong crc = crc32(0, nullptr, 0);
+        size_t n = 0;
+        while ((n = fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+            crc = crc32(crc, buffer.data(), static_cast<uInt>(n));
+        }
+        const bool hasFailed = ferror(file) != 0;
+        fclose(file);
+        if (hasFailed) {
+            return std::nullopt;
+        }
+        return static_cast<uint32_t>(crc);
+    }
+
+    // FNV-1a, which is good enough to tell the cache files apart
+    uint64_t hash(const void* data, size_t size, uint64_t h = 14695981039346656037ull) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            h = (h ^ bytes[i]) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    // The same mesh file can be used by multiple viewports with different parameters,
+    // so every combination gets its own cache file
+    fs::path cachePath(const std::string& folder, const std::string& path,
+                       const float (&parameters)[7])
+    {
+        std::error_code ec;
+        const std::string absolute = fs::absolute(path, ec).string();
+        uint64_t h = hash(absolute.data(), absolute.size());
+        h = hash(parameters, sizeof(parameters), h);
+
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(h));
+        const std::string stem = fs::path(path).stem().string();
+        return fs::path(folder) / (stem + '_' + name + ".sgctmesh");
+    }
+} // namespace
+
+namespace sgct::correction {
+
+std::optional<Buffer> loadCachedMesh(const std::string& folder, const std::string& path,
+                                     const vec2& pos, const vec2& size, float aspectRatio,
+                                     const vec2& tolerance)
+{
+    ZoneScoped
+
+    const std::optional<Source> source = sourceInfo(path);
+    if (!source) {
+        return std::nullopt;
+    }
+
+    const float parameters[7] = {
+        pos.x, pos.y, size.x, size.y, aspectRatio, tolerance.x, tolerance.y
+    };
+    const fs::path cache = cachePath(folder, path, parameters);
+    FILE* file = fopen(cache.string().c_str(), "rb");
+    if (file == nullptr) {
+        return std::nullopt;
+    }
+
+    Header header = {};
+    if (fread(&header, sizeof(Header), 1, file) != 1) {
+        fclose(file);
+        return std::nullopt;
+    }
+    const bool isValid =
+        std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 &&
+        header.version == Version &&
+        std::memcmp(header.parameters, parameters, sizeof(parameters)) == 0 &&
+        header.sourceSize == source->size;
+    // A cache file that was cut short would otherwise lead to huge allocations
+    std::error_code ec;
+    const uint64_t expectedSize = sizeof(Header) +
+        header.nVertices * sizeof(CorrectionMeshVertex) +
+        header.nIndices * sizeof(unsigned int);
+    if (!isValid || fs::file_size(cache, ec) != expectedSize) {
+        fclose(file);
+        return std::nullopt;
+    }
+
+    // The checksum is only needed if the modification time changed, which also happens
+    // when an identical file is copied onto the node
+    if (header.sourceTime != source->time) {
+        const std::optional<uint32_t> crc = checksum(path);
+        if (!crc || *crc != header.sourceChecksum) {
+            fclose(file);
+            return std::nullopt;
+        }
+    }
+
+    Buffer buffer;
+    buffer.geometryType = header.geometryType;
+    buffer.gridColumns = header.gridColumns;
+    buffer.gridRows = header.gridRows;
+    buffer.vertices.resize(header.nVertices);
+    buffer.indices.resize(header.nIndices);
+    const bool success =
+        fread(buffer.vertices.data(), sizeof(CorrectionMeshVertex), header.nVertices,
+            file) == header.nVertices &&
+        fread(buffer.indices.data(), sizeof(unsigned int), header.nIndices,
+            file) == header.nIndices;
+    fclose(file);
+    if (!success) {
+        return std::nullopt;
+    }
+
+    Log::Debug(
+        "Read correction mesh '%s' from cache '%s'", path.c_str(), cache.string().c_str()
+    );
+    return buffer;
+}
+
+void cacheMesh(const std::string& folder, const std::string& path, const vec2& pos,
+               const vec2& size, float aspectRatio, const vec2& tolerance,
+               const Buffer& buffer)
+{
+    ZoneScoped
+
+    const std::optional<Source> source = sourceInfo(path);
+    const std::optional<uint32_t> crc = checksum(path);
+    if (!source || !crc) {
+        return;
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.geometryType = buffer.geometryType;
+    header.gridColumns = buffer.gridColumns;
+    header.gridRows = buffer.gridRows;
+    header.sourceSize = source->size;
+    header.sourceTime = source->time;
+    header.sourceChecksum = *crc;
+    const float parameters[7] = {
+        pos.x, pos.y, size.x, size.y, aspectRatio, tolerance.x, tolerance.y
+    };
+    std::memcpy(header.parameters, parameters, sizeof(parameters));
+    header.nVertices = buffer.vertices.size();
+    header.nIndices = buffer.indices.size();
+
+    const fs::path cache = cachePath(folder, path, parameters);
+    std::error_code ec;
+    fs::create_directories(cache.parent_path(), ec);
+
+    // Multiple nodes on the same computer might write the same cache file at the same
+    // time, so the file is written under a unique name first and then renamed
+    fs::path temporary = cache;
+    temporary += ".tmp" + std::to_string(std::random_device()());
+    FILE* file = fopen(temporary.string().c_str(), "wb");
+    if (file == nullptr) {
+        Log::Warning("Could not create mesh cache '%s'", cache.string().c_str());
+        return;
+    }
+    const bool success =
+        fwrite(&header, sizeof(Header), 1, file) == 1 &&
+        fwrite(buffer.vertices.data(), sizeof(CorrectionMeshVertex), header.nVertices,
+            file) == header.nVertices &&
+        fwrite(buffer.indices.data(), sizeof(unsigned int), header.nIndices,
+            file) == header.nIndices;
+    const bool isClosed = fclose(file) == 0;
+    if (!success || !isClosed) {
+        Log::Warning("Could not write mesh cache '%s'", cache.string().c_str());
+        fs::remove(temporary, ec);
+        return;
+    }
+    fs::rename(temporary, cache, ec);
+    if (ec) {
+        Log::Warning("Could not write mesh cache '%s'", cache.string().c_str());
+        fs::remove(temporary, ec);
+        return;
+    }
+    Log::Debug("Wrote correction mesh cache '%s'", cache.string().c_str());
+}
+
+} // namespace sgct::correction
@@ -11,129 +11,104 @@
 #include <sgct/error.h>
 #include <sgct/log.h>
 #include <sgct/profiling.h>
-#include <sgct/viewport.h>
+#include <sgct/correction/gridmesh.h>
+#include <sgct/correction/textparser.h>
+#include <algorithm>
 #include <cstring>
 
 #define Error(code, msg) sgct::Error(sgct::Error::Component::MPCDIMesh, code, msg)
 
 namespace sgct::correction {
 
-Buffer generateMpcdiMesh(const std::vector<char>& mpcdiMesh) {
+Buffer generateMpcdiMesh(const std::function<size_t(char*, size_t)>& read,
+                         uint64_t fileSize)
+{
     ZoneScoped
 
     Buffer buf;
 
-    Log::Info("Reading MPCDI mesh (PFM format) from buffer");
-
-    const char* srcBuff = mpcdiMesh.data();
-    size_t srcSizeBytes = mpcdiMesh.size();
+    Log::Info("Reading MPCDI mesh (PFM format) from archive");
 
     constexpr const int MaxHeaderLineLength = 100;
     char headerBuffer[MaxHeaderLineLength];
-    unsigned int srcIdx = 0;
-    int index = 0;
+    size_t headerLength = 0;
     int nNewlines = 0;
     do {
         char headerChar = 0;
-
-        if (srcIdx == srcSizeBytes) {
+        if (headerLength == MaxHeaderLineLength || read(&headerChar, 1) != 1) {
             throw Error(2021, "Error reading from file. Could not find lines");
         }
 
-        headerChar = srcBuff[srcIdx++];
-        headerBuffer[index++] = headerChar;
+        headerBuffer[headerLength++] = headerChar;
         if (headerChar == '\n') {
             nNewlines++;
         }
     } while (nNewlines < 3);
 
-    char fileFormatHeader[2];
+    LineParser parser(std::string_view(headerBuffer, headerLength));
+    const std::string_view fileFormatHeader = parser.readWord();
     unsigned int nCols = 0;
     unsigned int nRows = 0;
-    const int res = sscanf(headerBuffer, "%2c %u %u", fileFormatHeader, &nCols, &nRows);
-    if (res != 3) {
+    if (fileFormatHeader.size() != 2 || !parser.read(nCols) || !parser.read(nRows) ||
+        nCols < 2 || nRows < 2)
+    {
         throw Error(2022, "Invalid header information in MPCDI mesh");
     }
 
-    if (fileFormatHeader[0] != 'P' || fileFormatHeader[1] != 'F') {
+    if (fileFormatHeader != "PF") {
         //The 'Pf' header is invalid because PFM grayscale type is not supported.
         throw Error(2023, "Incorrect file type. Unknown header type");
     }
-    const int nCorrectionValues = nCols * nRows;
-    std::vector<vec2> corrGrid(nCorrectionValues);
-    for (int i = 0; i < nCorrectionValues; ++i) {
-        float x;
-        std::memcpy(&x, &srcBuff[srcIdx], sizeof(float));
-        srcIdx += sizeof(float);
-        corrGrid[i].x = x;
-
-        float y;
-        std::memcpy(&y, &srcBuff[srcIdx], sizeof(float));
-        srcIdx += sizeof(float);
-        corrGrid[i].y = y;
-
-        // error position; we skip those here
-        srcIdx += sizeof(float);
-    }
 
-    std::vector<vec2> smoothPos(nCorrectionValues);
-    std::vector<vec2> warpedPos(nCorrectionValues);
-    for (int i = 0; i < nCorrectionValues; ++i) {
-        const float gridIdxCol = static_cast<float>(i % nCols);
-        const float gridIdxRow = static_cast<float>(i / nCols);
-        // Compute XY positions for each point based on a normalized 0,0 to 1,1 grid,
-        // add the correction offsets to each warp point
-        smoothPos[i].x = gridIdxCol / static_cast<float>(nCols - 1);
-        // Reverse the y position as the values from the PFM file are given in raster-scan
-        // order, which is left to right but starts at upper-left rather than lower-left.
-        smoothPos[i].y = 1.f - (gridIdxRow / static_cast<float>(nRows - 1));
-        warpedPos[i].x = smoothPos[i].x + corrGrid[i].x;
-        warpedPos[i].y = smoothPos[i].y + corrGrid[i].y;
+    // A corrupt header must not lead to a huge allocation. The number of values fits
+    // into 64 bits, and comparing it against the number of values that the rest of the
+    // file can hold avoids an overflow when computing the size in bytes
+    const uint64_t nValues = static_cast<uint64_t>(nCols) * nRows;
+    const uint64_t valueSize = 3 * sizeof(float);
+    if (fileSize < headerLength || nValues > (fileSize - headerLength) / valueSize) {
+        throw Error(2025, "MPCDI mesh header describes more data than the file contains");
     }
 
-    corrGrid.clear();
-
-    buf.vertices.reserve(nCorrectionValues);
-    for (int i = 0; i < nCorrectionValues; ++i) {
-        CorrectionMeshVertex vertex;
-        // init to max intensity (opaque white)
-        vertex.r = 1.f;
-        vertex.g = 1.f;
-        vertex.b = 1.f;
-        vertex.a = 1.f;
-
-        vertex.s = smoothPos[i].x;
-        vertex.t = smoothPos[i].y;
+    // The correction values are decompressed in small blocks and turned into vertices
+    // right away, so the PFM data is never held in memory as a whole
+    const size_t nCorrectionValues = static_cast<size_t>(nValues);
+    buf.vertices.resize(nCorrectionValues);
+    constexpr const size_t BlockSize = 1024;
+    float block[BlockSize * 3];
+    for (size_t first = 0; first < nCorrectionValues; first += BlockSize) {
+        const size_t n = std::min(BlockSize, nCorrectionValues - first);
+        const size_t bytes = n * 3 * sizeof(float);
+        if (read(reinterpret_cast<char*>(block), bytes) != bytes) {
+            throw Error(2024, "Unexpected end of the MPCDI mesh data");
+        }
 
-        // scale to viewport coordinates
-        vertex.x = 2.f * warpedPos[i].x - 1.f;
-        vertex.y = 2.f * warpedPos[i].y - 1.f;
-        buf.vertices.push_back(vertex);
-    }
-    warpedPos.clear();
-    smoothPos.clear();
-
-    buf.indices.reserve(6u * nCorrectionValues);
-    for (unsigned int c = 0; c < (nCols - 1); ++c) {
-        for (unsigned int r = 0; r < (nRows - 1); ++r) {
-            const unsigned int i0 = r * nCols + c;
-            const unsigned int i1 = r * nCols + (c + 1);
-            const unsigned int i2 = (r + 1) * nCols + (c + 1);
-            const unsigned int i3 = (r + 1) * nCols + c;
-
-            // triangle 1
-            buf.indices.push_back(i0);
-            buf.indices.push_back(i1);
-            buf.indices.push_back(i2);
-
-            // triangle 2
-            buf.indices.push_back(i0);
-            buf.indices.push_back(i2);
-            buf.indices.push_back(i3);
+        for (size_t i = 0; i < n; ++i) {
+            const size_t idx = first + i;
+            const float gridIdxCol = static_cast<float>(idx % nCols);
+            const float gridIdxRow = static_cast<float>(idx / nCols);
+
+            CorrectionMeshVertex& vertex = buf.vertices[idx];
+            // init to max intensity (opaque white)
+            vertex.r = 1.f;
+            vertex.g = 1.f;
+            vertex.b = 1.f;
+            vertex.a = 1.f;
+
+            // Compute XY positions for each point based on a normalized 0,0 to 1,1 grid.
+            // Reverse the y position as the values from the PFM file are given in
+            // raster-scan order, which is left to right but starts at upper-left rather
+            // than lower-left.
+            vertex.s = gridIdxCol / static_cast<float>(nCols - 1);
+            vertex.t = 1.f - (gridIdxRow / static_cast<float>(nRows - 1));
+
+            // add the correction offsets to each warp point and scale to viewport
+            // coordinates. The third value is the error position, which we skip
+            vertex.x = 2.f * (vertex.s + block[i * 3]) - 1.f;
+            vertex.y = 2.f * (vertex.t + block[i * 3 + 1]) - 1.f;
         }
     }
 
-    buf.geometryType = GL_TRIANGLES;
+    createGridIndices(buf, nCols, nRows);
     return buf;
 }
 
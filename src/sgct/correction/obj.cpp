@@ -6,12 +6,14 @@
  * For conditions of distribution and use, see copyright notice in LICENSE.md            *
  ****************************************************************************************/
 
-#include <sgct/correction/skyskan.h>
+#include <sgct/correction/obj.h>
 
 #include <sgct/error.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
+#include <sgct/correction/textparser.h>
+#include <cstdio>
 
 namespace sgct::correction {
 
@@ -22,38 +24,69 @@ Buffer generateOBJMesh(const std::string& path) {
 
     Log::Info("Reading Wavefront OBJ mesh data from '%s'", path.c_str());
 
-    FILE* meshFile = fopen(path.c_str(), "r");
-    if (meshFile == nullptr) {
+    const std::optional<std::string> text = readTextFile(path);
+    if (!text) {
         throw Error(Error::Component::OBJ, 2030, "Failed to open " + path);
     }
 
+    // Counting the lines first means that the buffers never have to grow
+    buffer.vertices.reserve(countLines(*text, "v "));
+    buffer.indices.reserve(countLines(*text, "f ") * 3);
+
+    // Reads the vertex index of a face and skips the texture and normal indices
+    auto readFaceIndex = [](LineParser& line, unsigned int& index) {
+        int i = 0;
+        if (!line.read(i)) {
+            return false;
+        }
+        while (line.consume("/")) {
+            int unused = 0;
+            line.read(unused);
+        }
+        // indexes starts at 1 in OBJ
+        index = static_cast<unsigned int>(i - 1);
+        return true;
+    };
+
     unsigned int counter = 0;
-    while (!feof(meshFile)) {
-        constexpr const int MaxLineLength = 1024;
-        char buf[MaxLineLength];
-        if (fgets(buf, MaxLineLength, meshFile)) {
-            CorrectionMeshVertex tmpVert;
-            if (sscanf(buf, "v %f %f %*f", &tmpVert.x, &tmpVert.y) == 2) {
-                tmpVert.r = 1.f;
-                tmpVert.g = 1.f;
-                tmpVert.b = 1.f;
-                tmpVert.a = 1.f;
-
-                buffer.vertices.push_back(tmpVert);
-            }
-            if (sscanf(buf, "vt %f %f %*f", &tmpVert.s, &tmpVert.t) == 2) {
+    std::string_view remaining = *text;
+    while (!remaining.empty()) {
+        LineParser line(nextLine(remaining));
+        if (line.consume("vt")) {
+            float s = 0.f;
+            float t = 0.f;
+            if (line.read(s) && line.read(t)) {
                 if (counter < buffer.vertices.size()) {
-                    buffer.vertices[counter].s = tmpVert.s;
-                    buffer.vertices[counter].t = tmpVert.t;
+                    buffer.vertices[counter].s = s;
+                    buffer.vertices[counter].t = t;
                 }
                 counter++;
             }
-            int i0, i1, i2;
-            if (sscanf(buf, "f %d/%*d/%*d %d/%*d/%*d %d/%*d/%*d", &i0, &i1, &i2) == 3) {
-                // indexes starts at 1 in OBJ
-                buffer.indices.push_back(i0 - 1);
-                buffer.indices.push_back(i1 - 1);
-                buffer.indices.push_back(i2 - 1);
+        }
+        else if (line.consume("vn")) {
+            // Normals are not used for the correction
+        }
+        else if (line.consume("v")) {
+            CorrectionMeshVertex vertex;
+            if (line.read(vertex.x) && line.read(vertex.y)) {
+                vertex.r = 1.f;
+                vertex.g = 1.f;
+                vertex.b = 1.f;
+                vertex.a = 1.f;
+
+                buffer.vertices.push_back(vertex);
+            }
+        }
+        else if (line.consume("f")) {
+            unsigned int i0;
+            unsigned int i1;
+            unsigned int i2;
+            if (readFaceIndex(line, i0) && readFaceIndex(line, i1) &&
+                readFaceIndex(line, i2))
+            {
+                buffer.indices.push_back(i0);
+                buffer.indices.push_back(i1);
+                buffer.indices.push_back(i2);
             }
         }
     }
@@ -70,4 +103,99 @@ Buffer generateOBJMesh(const std::string& path) {
     return buffer;
 }
 
+void exportOBJMesh(const std::string& path, const Buffer& buffer) {
+    ZoneScoped
+
+    const bool isStrip = buffer.geometryType == GL_TRIANGLE_STRIP;
+    if (buffer.geometryType != GL_TRIANGLES && !isStrip) {
+        throw Error(
+            Error::Component::OBJ, 2032,
+            "Failed to export " + path + ". Geometry type not supported"
+        );
+    }
+
+    // Calls f with the indices of every triangle. Every other triangle of a strip is
+    // flipped, so that all triangles keep the winding of the first one
+    auto forEachTriangle = [&buffer, isStrip](auto f) {
+        const std::vector<unsigned int>& idx = buffer.indices;
+        if (!isStrip) {
+            for (size_t i = 0; i + 2 < idx.size(); i += 3) {
+                f(idx[i], idx[i + 1], idx[i + 2]);
+            }
+            return;
+        }
+
+        // Every strip starts over after a primitive restart index
+        size_t start = 0;
+        for (size_t i = 0; i < idx.size(); ++i) {
+            if (idx[i] == PrimitiveRestartIndex) {
+                start = i + 1;
+                continue;
+            }
+            if (i < start + 2) {
+                continue;
+            }
+            if ((i - start) % 2 == 0) {
+                f(idx[i - 2], idx[i - 1], idx[i]);
+            }
+            else {
+                f(idx[i - 1], idx[i - 2], idx[i]);
+            }
+        }
+    };
+    size_t nFaces = 0;
+    forEachTriangle([&nFaces](unsigned int, unsigned int, unsigned int) { nFaces++; });
+
+    // The file is formatted into memory and written at once, which is a lot faster than
+    // formatting every value through a stream
+    std::string text;
+    text.reserve(buffer.vertices.size() * 56 + nFaces * 48);
+    char line[128];
+    auto append = [&text, &line](int n) {
+        if (n > 0) {
+            text.append(line, static_cast<size_t>(n));
+        }
+    };
+
+    append(std::snprintf(
+        line, sizeof(line), "# SGCT warping mesh\n# Number of vertices: %zu\n",
+        buffer.vertices.size()
+    ));
+    for (const CorrectionMeshVertex& v : buffer.vertices) {
+        append(std::snprintf(line, sizeof(line), "v %.6f %.6f 0\n", v.x, v.y));
+    }
+    for (const CorrectionMeshVertex& v : buffer.vertices) {
+        append(std::snprintf(line, sizeof(line), "vt %.6f %.6f 0\n", v.s, v.t));
+    }
+    // All vertices share the same normal
+    text += "vn 0 0 1\n";
+
+    append(std::snprintf(line, sizeof(line), "# Number of faces: %zu\n", nFaces));
+    forEachTriangle([&](unsigned int a, unsigned int b, unsigned int c) {
+        // indexes starts at 1 in OBJ
+        append(std::snprintf(
+            line, sizeof(line), "f %u/%u/1 %u/%u/1 %u/%u/1\n",
+            a + 1, a + 1, b + 1, b + 1, c + 1, c + 1
+        ));
+    });
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw Error(
+            Error::Component::OBJ, 2033,
+            "Failed to export " + path + ". Failed to open"
+        );
+    }
+    const bool success = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    const bool isClosed = std::fclose(file) == 0;
+    if (!success || !isClosed) {
+        throw Error(
+            Error::Component::OBJ, 2033,
+            "Failed to export " + path + ". Failed to write"
+        );
+    }
+
+    Log::Info("Mesh '%s' exported successfully", path.c_str());
+}
+
 } // namespace sgct::correction
@@ -13,7 +13,10 @@
 #include <sgct/log.h>
 #include <sgct/profiling.h>
 #include <sgct/window.h>
+#include <sgct/correction/gridmesh.h>
+#include <sgct/correction/textparser.h>
 #include <glm/glm.hpp>
+#include <algorithm>
 
 namespace sgct::correction {
 
@@ -26,27 +29,26 @@ Buffer generatePaulBourkeMesh(const std::string& path, const vec2& pos, const ve
 
     Log::Info("Reading Paul Bourke spherical mirror mesh from '%s'", path.c_str());
 
-    FILE* meshFile = fopen(path.c_str(), "r");
-    if (meshFile == nullptr) {
+    const std::optional<std::string> text = readTextFile(path);
+    if (!text) {
         throw Error(Error::Component::PaulBourke, 2040, "Failed to open " + path);
     }
-
-    constexpr const int MaxLineLength = 1024;
-    char lineBuffer[MaxLineLength];
+    std::string_view remaining = *text;
 
     // get the fist line containing the mapping type _id
     int mappingType = -1;
-    if (fgets(lineBuffer, MaxLineLength, meshFile)) {
-        int r = sscanf(lineBuffer, "%d", &mappingType);
-        if (r != 1) {
+    if (!remaining.empty()) {
+        LineParser line(nextLine(remaining));
+        if (!line.read(mappingType)) {
             throw Error(Error::Component::PaulBourke, 2041, "Error reading mapping type");
         }
     }
 
     // get the mesh dimensions
     glm::ivec2 meshSize = glm::ivec2(-1, -1);
-    if (fgets(lineBuffer, MaxLineLength, meshFile)) {
-        if (sscanf(lineBuffer, "%d %d", &meshSize[0], &meshSize[1]) == 2) {
+    if (!remaining.empty()) {
+        LineParser line(nextLine(remaining));
+        if (line.read(meshSize.x) && line.read(meshSize.y)) {
             buf.vertices.reserve(meshSize.x * meshSize.y);
         }
     }
@@ -57,45 +59,32 @@ Buffer generatePaulBourkeMesh(const std::string& path, const vec2& pos, const ve
     }
 
     // get all data
-    float x, y, s, t, intensity;
-    while (!feof(meshFile)) {
-        if (fgets(lineBuffer, MaxLineLength, meshFile)) {
-            if (sscanf(lineBuffer, "%f %f %f %f %f", &x, &y, &s, &t, &intensity) == 5) {
-                CorrectionMeshVertex vertex;
-                vertex.x = x;
-                vertex.y = y;
-                vertex.s = s;
-                vertex.t = t;
-
-                vertex.r = intensity;
-                vertex.g = intensity;
-                vertex.b = intensity;
-                vertex.a = 1.f;
-
-                buf.vertices.push_back(vertex);
-            }
+    while (!remaining.empty()) {
+        LineParser line(nextLine(remaining));
+        float x, y, s, t, intensity;
+        if (line.read(x) && line.read(y) && line.read(s) && line.read(t) &&
+            line.read(intensity))
+        {
+            CorrectionMeshVertex vertex;
+            vertex.x = x;
+            vertex.y = y;
+            vertex.s = s;
+            vertex.t = t;
+
+            vertex.r = intensity;
+            vertex.g = intensity;
+            vertex.b = intensity;
+            vertex.a = 1.f;
+
+            buf.vertices.push_back(vertex);
         }
     }
 
-    // generate indices
-    for (int c = 0; c < (meshSize.x - 1); c++) {
-        for (int r = 0; r < (meshSize.y - 1); r++) {
-            const int i0 = r * meshSize.x + c;
-            const int i1 = r * meshSize.x + (c + 1);
-            const int i2 = (r + 1) * meshSize.x + (c + 1);
-            const int i3 = (r + 1) * meshSize.x + c;
-
-            // triangle 1
-            buf.indices.push_back(i0);
-            buf.indices.push_back(i1);
-            buf.indices.push_back(i2);
-
-            // triangle 2
-            buf.indices.push_back(i0);
-            buf.indices.push_back(i2);
-            buf.indices.push_back(i3);
-        }
-    }
+    createGridIndices(
+        buf,
+        static_cast<unsigned int>(meshSize.x),
+        static_cast<unsigned int>(meshSize.y)
+    );
 
     const float aspect = aspectRatio * (size.x / size.y);
     for (CorrectionMeshVertex& vertex : buf.vertices) {
@@ -113,7 +102,6 @@ Buffer generatePaulBourkeMesh(const std::string& path, const vec2& pos, const ve
         vertex.t = vertex.t * size.y + pos.y;
     }
 
-    buf.geometryType = GL_TRIANGLES;
     return buf;
 }
 
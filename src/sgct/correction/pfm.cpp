@@ -10,8 +10,8 @@
 
 #include <sgct/error.h>
 #include <sgct/log.h>
-#include <sgct/opengl.h>
 #include <sgct/profiling.h>
+#include <sgct/correction/gridmesh.h>
 #include <glm/glm.hpp>
 
 namespace sgct::correction {
@@ -140,27 +140,10 @@ Buffer generatePerEyeMeshFromPFMImage(const std::string& path, const vec2& pos,
             }
             i += nCols;
         }
-
-        // Make a triangle strip index list
-        for (unsigned int r = 0; r < nRows - 1; r++) {
-            if ((r & 1) == 0) {
-                // even rows
-                for (unsigned int c = 0; c < nCols; c++) {
-                    buf.indices.push_back(c + r * nCols);
-                    buf.indices.push_back(c + (r + 1) * nCols);
-                }
-            }
-            else {
-                // odd rows
-                for (unsigned int c = nCols - 1; c > 0; c--) {
-                    buf.indices.push_back(c + (r + 1) * nCols);
-                    buf.indices.push_back(c - 1 + r * nCols);
-                }
-            }
-        }
     }
 
-    buf.geometryType = GL_TRIANGLE_STRIP;
+    // The indices only refer to the vertices of the first eye
+    createGridIndices(buf, nCols, nRows);
     return buf;
 }
 
@@ -11,6 +11,7 @@
 #include <sgct/error.h>
 #include <sgct/log.h>
 #include <sgct/profiling.h>
+#include <sgct/correction/textparser.h>
 #include <glm/glm.hpp>
 
 namespace sgct::correction {
@@ -22,8 +23,8 @@ Buffer generateScalableMesh(const std::string& path, const vec2& pos, const vec2
 
     Log::Info("Reading scalable mesh data from '%s'", path.c_str());
 
-    FILE* meshFile = fopen(path.c_str(), "r");
-    if (meshFile == nullptr) {
+    const std::optional<std::string> text = readTextFile(path);
+    if (!text) {
         throw Error(Error::Component::Scalable, 2060, "Failed to open " + path);
     }
 
@@ -39,80 +40,86 @@ Buffer generateScalableMesh(const std::string& path, const vec2& pos, const vec2
     double topOrtho = 0.0;
     glm::ivec2 res = glm::ivec2(0);
 
-    while (!feof(meshFile)) {
-        constexpr const int MaxLineLength = 1024;
-        char lineBuffer[MaxLineLength];
-
-        if (fgets(lineBuffer, MaxLineLength, meshFile)) {
-            float x, y, s, t;
-            unsigned int a, b, c;
-            unsigned int intensity;
-            if (sscanf(lineBuffer, "%f %f %u %f %f", &x, &y, &intensity, &s, &t) == 5) {
-                if (!buf.vertices.empty() && res.x != 0 && res.y != 0) {
-                    CorrectionMeshVertex& vertex = buf.vertices[numOfVerticesRead];
-                    vertex.x = (x / static_cast<float>(res.x)) * size.x + pos.x;
-                    vertex.y = (y / static_cast<float>(res.y)) * size.y + pos.y;
-                    vertex.r = static_cast<float>(intensity) / 255.f;
-                    vertex.g = static_cast<float>(intensity) / 255.f;
-                    vertex.b = static_cast<float>(intensity) / 255.f;
-                    vertex.a = 1.f;
-                    vertex.s = (1.f - t) * size.x + pos.x;
-                    vertex.t = (1.f - s) * size.y + pos.y;
-
-                    numOfVerticesRead++;
-                }
+    std::string_view remaining = *text;
+    while (!remaining.empty()) {
+        const std::string_view lineText = nextLine(remaining);
+
+        float x, y, s, t;
+        unsigned int a, b, c;
+        unsigned int intensity;
+        LineParser vertexLine(lineText);
+        LineParser faceLine(lineText);
+        LineParser line(lineText);
+        if (vertexLine.read(x) && vertexLine.read(y) && vertexLine.read(intensity) &&
+            vertexLine.read(s) && vertexLine.read(t))
+        {
+            // The number of vertices in the header sized the buffer
+            if (numOfVerticesRead < buf.vertices.size() && res.x != 0 && res.y != 0) {
+                CorrectionMeshVertex& vertex = buf.vertices[numOfVerticesRead];
+                vertex.x = (x / static_cast<float>(res.x)) * size.x + pos.x;
+                vertex.y = (y / static_cast<float>(res.y)) * size.y + pos.y;
+                vertex.r = static_cast<float>(intensity) / 255.f;
+                vertex.g = static_cast<float>(intensity) / 255.f;
+                vertex.b = static_cast<float>(intensity) / 255.f;
+                vertex.a = 1.f;
+                vertex.s = (1.f - t) * size.x + pos.x;
+                vertex.t = (1.f - s) * size.y + pos.y;
+
+                numOfVerticesRead++;
+            }
+        }
+        else if (faceLine.consume("[") && faceLine.read(a) && faceLine.read(b) &&
+                 faceLine.read(c))
+        {
+            if (numOfFacesRead < numberOfFaces) {
+                buf.indices[numOfFacesRead * 3u] = a;
+                buf.indices[numOfFacesRead * 3u + 1u] = b;
+                buf.indices[numOfFacesRead * 3u + 2u] = c;
             }
-            else if (sscanf(lineBuffer, "[ %u %u %u ]", &a, &b, &c) == 3) {
-                if (!buf.indices.empty()) {
-                    buf.indices[numOfFacesRead * 3u] = a;
-                    buf.indices[numOfFacesRead * 3u + 1u] = b;
-                    buf.indices[numOfFacesRead * 3u + 2u] = c;
-                }
 
-                numOfFacesRead++;
+            numOfFacesRead++;
+        }
+        else if (line.consume("VERTICES")) {
+            if (line.read(numberOfVertices)) {
+                buf.vertices.assign(numberOfVertices, CorrectionMeshVertex());
             }
-            else {
-                char tmpBuf[16];
-                tmpBuf[0] = '\0';
-                double tmpD = 0.0;
-                unsigned int tmpUI = 0;
-
-                if (sscanf(lineBuffer, "VERTICES %u", &numberOfVertices) == 1) {
-                    buf.vertices.resize(numberOfVertices);
-                    std::fill(
-                        buf.vertices.begin(),
-                        buf.vertices.end(),
-                        CorrectionMeshVertex()
-                    );
-                }
-                else if (sscanf(lineBuffer, "FACES %u", &numberOfFaces) == 1) {
-                    numberOfIndices = numberOfFaces * 3;
-                    buf.indices.resize(numberOfIndices);
-                    std::fill(buf.indices.begin(), buf.indices.end(), 0);
+        }
+        else if (line.consume("FACES")) {
+            if (line.read(numberOfFaces)) {
+                numberOfIndices = numberOfFaces * 3;
+                buf.indices.assign(numberOfIndices, 0);
+            }
+        }
+        else if (line.consume("ORTHO_")) {
+            const std::string_view side = line.readWord();
+            double value = 0.0;
+            if (line.read(value)) {
+                if (side == "LEFT") {
+                    leftOrtho = value;
                 }
-                else if (sscanf(lineBuffer, "ORTHO_%s %lf", tmpBuf, &tmpD) == 2) {
-                    std::string_view tmp = tmpBuf;
-                    if (tmp == "LEFT") {
-                        leftOrtho = tmpD;
-                    }
-                    else if (tmp == "RIGHT") {
-                        rightOrtho = tmpD;
-                    }
-                    else if (tmp == "BOTTOM") {
-                        bottomOrtho = tmpD;
-                    }
-                    else if (tmp == "TOP") {
-                        topOrtho = tmpD;
-                    }
+                else if (side == "RIGHT") {
+                    rightOrtho = value;
                 }
-                else if (sscanf(lineBuffer, "NATIVEXRES %u", &tmpUI) == 1) {
-                    res.x = tmpUI;
+                else if (side == "BOTTOM") {
+                    bottomOrtho = value;
                 }
-                else if (sscanf(lineBuffer, "NATIVEYRES %u", &tmpUI) == 1) {
-                    res.y = tmpUI;
+                else if (side == "TOP") {
+                    topOrtho = value;
                 }
             }
         }
+        else if (line.consume("NATIVEXRES")) {
+            unsigned int value = 0;
+            if (line.read(value)) {
+                res.x = value;
+            }
+        }
+        else if (line.consume("NATIVEYRES")) {
+            unsigned int value = 0;
+            if (line.read(value)) {
+                res.y = value;
+            }
+        }
     }
 
     if (numberOfVertices != numOfVerticesRead || numberOfFaces != numOfFacesRead) {
@@ -135,10 +142,6 @@ Buffer generateScalableMesh(const std::string& path, const vec2& pos, const vec2
         buf.vertices[i].y = yVal * 2.f - 1.f;
     }
 
-    if (meshFile) {
-        fclose(meshFile);
-    }
-
     buf.geometryType = GL_TRIANGLES;
     return buf;
 }
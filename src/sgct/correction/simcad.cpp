@@ -12,21 +12,27 @@
 #include <sgct/log.h>
 #include <sgct/profiling.h>
 #include <sgct/viewport.h>
+#include <sgct/correction/gridmesh.h>
+#include <sgct/correction/textparser.h>
 #include <glm/glm.hpp>
 #include <tinyxml2.h>
-#include <sstream>
+#include <algorithm>
 
 #define Error(code, msg) Error(Error::Component::SimCAD, code, msg)
 
 namespace {
-    std::vector<std::string> split(std::string str, char delimiter) {
-        std::vector<std::string> res;
-        std::stringstream ss(std::move(str));
-        std::string part;
-        while (std::getline(ss, part, delimiter)) {
-            res.push_back(part);
+    void readCorrections(const char* text, float range, std::vector<float>& values) {
+        if (text == nullptr) {
+            return;
+        }
+        const std::string_view str = text;
+        // The values are separated by spaces, which gives the number of values
+        values.reserve(values.size() + std::count(str.begin(), str.end(), ' ') + 1);
+        sgct::correction::LineParser parser(str);
+        float value = 0.f;
+        while (parser.read(value)) {
+            values.push_back(value / range);
         }
-        return res;
     }
 } // namespace
 
@@ -71,21 +77,13 @@ Buffer generateSimCADMesh(const std::string& path, const vec2& pos, const vec2&
         if (childVal == "X-FlatParameters") {
             float xrange = 1.f;
             if (child->QueryFloatAttribute("range", &xrange) == XML_NO_ERROR) {
-                std::string xcoordstr(child->GetText());
-                std::vector<std::string> xcoords = split(xcoordstr, ' ');
-                for (const std::string& x : xcoords) {
-                    xcorrections.push_back(std::stof(x) / xrange);
-                }
+                readCorrections(child->GetText(), xrange, xcorrections);
             }
         }
         else if (childVal == "Y-FlatParameters") {
             float yrange = 1.f;
             if (child->QueryFloatAttribute("range", &yrange) == XML_NO_ERROR) {
-                std::string ycoordstr(child->GetText());
-                std::vector<std::string> ycoords = split(ycoordstr, ' ');
-                for (const std::string& y : ycoords) {
-                    ycorrections.push_back(std::stof(y) / yrange);
-                }
+                readCorrections(child->GetText(), yrange, ycorrections);
             }
         }
 
@@ -113,6 +111,7 @@ Buffer generateSimCADMesh(const std::string& path, const vec2& pos, const vec2&
     vertex.b = 1.f;
     vertex.a = 1.f;
 
+    buf.vertices.reserve(static_cast<size_t>(nRows) * nCols);
     size_t i = 0;
     for (unsigned int r = 0; r < nRows; r++) {
         for (unsigned int c = 0; c < nCols; c++) {
@@ -140,26 +139,7 @@ Buffer generateSimCADMesh(const std::string& path, const vec2& pos, const vec2&
         }
     }
 
-    // Make a triangle strip index list
-    buf.indices.reserve(4u * nRows * nCols);
-    for (unsigned int r = 0; r < nRows - 1; r++) {
-        if ((r % 2) == 0) {
-            // even rows
-            for (unsigned int c = 0; c < nCols; c++) {
-                buf.indices.push_back(c + r * nCols);
-                buf.indices.push_back(c + (r + 1) * nCols);
-            }
-        }
-        else {
-            // odd rows
-            for (unsigned int c = nCols - 1; c > 0; c--) {
-                buf.indices.push_back(c + (r + 1) * nCols);
-                buf.indices.push_back(c - 1 + r * nCols);
-            }
-        }
-    }
-
-    buf.geometryType = GL_TRIANGLE_STRIP;
+    createGridIndices(buf, nCols, nRows);
     return buf;
 }
 
@@ -0,0 +1,286 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/simplify.h>
+
+#include <sgct/log.h>
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    using sgct::correction::CorrectionMeshVertex;
+
+    // Colors are uploaded with 8 bits per channel, so half a step is not visible
+    constexpr const float ColorTolerance = 0.5f / 255.f;
+
+    struct Grid {
+        const CorrectionMeshVertex& at(unsigned int c, unsigned int r) const {
+            return vertices[static_cast<size_t>(r) * nCols + c];
+        }
+
+        const std::vector<CorrectionMeshVertex>& vertices;
+        unsigned int nCols;
+        unsigned int nRows;
+        // +1 if the cells are counter-clockwise on the screen and -1 if not
+        float orientation;
+    };
+
+    // A rectangular block of cells, given by the grid coordinates of its corner vertices
+    struct Block {
+        unsigned int c0;
+        unsigned int r0;
+        unsigned int c1;
+        unsigned int r1;
+    };
+
+    float cross(const CorrectionMeshVertex& a, const CorrectionMeshVertex& b,
+                const CorrectionMeshVertex& c)
+    {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+
+    bool isWithinTolerance(const CorrectionMeshVertex& v, const CorrectionMeshVertex& a,
+                           const CorrectionMeshVertex& b, const CorrectionMeshVertex& c,
+                           const sgct::vec2& tolerance)
+    {
+        // Barycentric coordinates of v on the screen, which might lie slightly outside of
+        // the triangle for vertices on the curved border of a block
+        const float area = cross(a, b, c);
+        const float la = cross(v, b, c) / area;
+        const float lb = cross(a, v, c) / area;
+        const float lc = 1.f - la - lb;
+        auto interpolate = [&](float CorrectionMeshVertex::* m) {
+            return la * a.*m + lb * b.*m + lc * c.*m;
+        };
+
+        using V = CorrectionMeshVertex;
+        return
+            std::abs(interpolate(&V::s) - v.s) <= tolerance.x &&
+            std::abs(interpolate(&V::t) - v.t) <= tolerance.y &&
+            std::abs(interpolate(&V::r) - v.r) <= ColorTolerance &&
+            std::abs(interpolate(&V::g) - v.g) <= ColorTolerance &&
+            std::abs(interpolate(&V::b) - v.b) <= ColorTolerance &&
+            std::abs(interpolate(&V::a) - v.a) <= ColorTolerance;
+    }
+
+    /**
+     * Checks whether the block can be replaced by the four triangles between its center
+     * vertex and its corners. Every vertex of the block is compared against the triangle
+     * that contains it on the screen
+     */
+    bool isMergeable(const Grid& grid, const Block& block, const sgct::vec2& tolerance) {
+        const unsigned int w = block.c1 - block.c0;
+        const unsigned int h = block.r1 - block.r0;
+        if (w < 2 || h < 2 || w % 2 != 0 || h % 2 != 0) {
+            // The block needs a vertex in its center
+            return false;
+        }
+
+        const CorrectionMeshVertex& m = grid.at(block.c0 + w / 2, block.r0 + h / 2);
+        const CorrectionMeshVertex* corners[] = {
+            &grid.at(block.c0, block.r0),
+            &grid.at(block.c1, block.r0),
+            &grid.at(block.c1, block.r1),
+            &grid.at(block.c0, block.r1)
+        };
+        for (int i = 0; i < 4; ++i) {
+            if (cross(m, *corners[i], *corners[(i + 1) % 4]) * grid.orientation <= 0.f) {
+                return false;
+            }
+        }
+
+        for (unsigned int r = block.r0; r <= block.r1; ++r) {
+            for (unsigned int c = block.c0; c <= block.c1; ++c) {
+                const CorrectionMeshVertex& v = grid.at(c, r);
+
+                // Folded or collapsed cells have to stay as they are
+                if (c < block.c1 && r < block.r1) {
+                    const CorrectionMeshVertex& v1 = grid.at(c + 1, r);
+                    const CorrectionMeshVertex& v2 = grid.at(c + 1, r + 1);
+                    const CorrectionMeshVertex& v3 = grid.at(c, r + 1);
+                    if (cross(v, v1, v2) * grid.orientation <= 0.f ||
+                        cross(v, v2, v3) * grid.orientation <= 0.f)
+                    {
+                        return false;
+                    }
+                }
+
+                // Find the triangle of the fan that contains the vertex, which is the one
+                // for which the vertex is on the inner side of both fan edges
+                int triangle = 0;
+                float best = -std::numeric_limits<float>::max();
+                for (int i = 0; i < 4; ++i) {
+                    const CorrectionMeshVertex& a = *corners[i];
+                    const CorrectionMeshVertex& b = *corners[(i + 1) % 4];
+                    const float inside = std::min(
+                        cross(m, a, v) * grid.orientation,
+                        cross(m, v, b) * grid.orientation
+                    );
+                    if (inside > best) {
+                        best = inside;
+                        triangle = i;
+                    }
+                }
+
+                const CorrectionMeshVertex& a = *corners[triangle];
+                const CorrectionMeshVertex& b = *corners[(triangle + 1) % 4];
+                if (!isWithinTolerance(v, m, a, b, tolerance)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void subdivide(const Grid& grid, unsigned int c0, unsigned int r0, unsigned int size,
+                   const sgct::vec2& tolerance, std::vector<Block>& leaves)
+    {
+        if (c0 >= grid.nCols - 1 || r0 >= grid.nRows - 1) {
+            return;
+        }
+
+        Block block;
+        block.c0 = c0;
+        block.r0 = r0;
+        block.c1 = std::min(c0 + size, grid.nCols - 1);
+        block.r1 = std::min(r0 + size, grid.nRows - 1);
+        const bool isCell = block.c1 - block.c0 == 1 && block.r1 - block.r0 == 1;
+        if (isCell || isMergeable(grid, block, tolerance)) {
+            leaves.push_back(block);
+            return;
+        }
+
+        const unsigned int half = size / 2;
+        subdivide(grid, c0, r0, half, tolerance, leaves);
+        subdivide(grid, c0 + half, r0, half, tolerance, leaves);
+        subdivide(grid, c0, r0 + half, half, tolerance, leaves);
+        subdivide(grid, c0 + half, r0 + half, half, tolerance, leaves);
+    }
+} // namespace
+
+namespace sgct::correction {
+
+void simplifyGridMesh(Buffer& buffer, const vec2& tolerance) {
+    ZoneScoped
+
+    const unsigned int nCols = buffer.gridColumns;
+    const unsigned int nRows = buffer.gridRows;
+    if (nCols < 3 || nRows < 3 ||
+        buffer.vertices.size() < static_cast<size_t>(nCols) * nRows)
+    {
+        return;
+    }
+
+    // The orientation of the whole grid decides which cells count as folded
+    const std::vector<CorrectionMeshVertex>& vertices = buffer.vertices;
+    auto at = [&](unsigned int c, unsigned int r) -> const CorrectionMeshVertex& {
+        return vertices[static_cast<size_t>(r) * nCols + c];
+    };
+    float area = 0.f;
+    for (unsigned int r = 0; r < nRows - 1; ++r) {
+        for (unsigned int c = 0; c < nCols - 1; ++c) {
+            area += cross(at(c, r), at(c + 1, r), at(c + 1, r + 1));
+        }
+    }
+    const Grid grid = { vertices, nCols, nRows, area >= 0.f ? 1.f : -1.f };
+
+    unsigned int size = 1;
+    while (size < std::max(nCols, nRows) - 1) {
+        size *= 2;
+    }
+    std::vector<Block> leaves;
+    subdivide(grid, 0, 0, size, tolerance, leaves);
+
+    // The vertices that are kept are the corners and centers of all blocks and the
+    // vertices on the border of the grid. A block has to include the corners of its
+    // smaller neighbors that lie on its edges, or the mesh would have cracks
+    std::vector<bool> isUsed(static_cast<size_t>(nCols) * nRows, false);
+    auto use = [&](unsigned int c, unsigned int r) {
+        isUsed[static_cast<size_t>(r) * nCols + c] = true;
+    };
+    for (unsigned int c = 0; c < nCols; ++c) {
+        use(c, 0);
+        use(c, nRows - 1);
+    }
+    for (unsigned int r = 0; r < nRows; ++r) {
+        use(0, r);
+        use(nCols - 1, r);
+    }
+    for (const Block& b : leaves) {
+        use(b.c0, b.r0);
+        use(b.c1, b.r0);
+        use(b.c1, b.r1);
+        use(b.c0, b.r1);
+        use((b.c0 + b.c1) / 2, (b.r0 + b.r1) / 2);
+    }
+
+    Buffer res;
+    std::vector<unsigned int> newIndex(isUsed.size(), 0);
+    for (size_t i = 0; i < isUsed.size(); ++i) {
+        if (isUsed[i]) {
+            newIndex[i] = static_cast<unsigned int>(res.vertices.size());
+            res.vertices.push_back(vertices[i]);
+        }
+    }
+    auto index = [&](unsigned int c, unsigned int r) {
+        return newIndex[static_cast<size_t>(r) * nCols + c];
+    };
+
+    std::vector<unsigned int> border;
+    for (const Block& b : leaves) {
+        if (b.c1 - b.c0 == 1 && b.r1 - b.r0 == 1) {
+            // Single cells are split along the same diagonal as in the grid
+            const unsigned int i0 = index(b.c0, b.r0);
+            const unsigned int i1 = index(b.c1, b.r0);
+            const unsigned int i2 = index(b.c1, b.r1);
+            const unsigned int i3 = index(b.c0, b.r1);
+            res.indices.insert(res.indices.end(), { i0, i1, i2, i0, i2, i3 });
+            continue;
+        }
+
+        // Walk around the block in the same direction as the cells and connect every
+        // kept vertex on the way to the center
+        border.clear();
+        auto add = [&](unsigned int c, unsigned int r) {
+            if (isUsed[static_cast<size_t>(r) * nCols + c]) {
+                border.push_back(index(c, r));
+            }
+        };
+        for (unsigned int c = b.c0; c < b.c1; ++c) {
+            add(c, b.r0);
+        }
+        for (unsigned int r = b.r0; r < b.r1; ++r) {
+            add(b.c1, r);
+        }
+        for (unsigned int c = b.c1; c > b.c0; --c) {
+            add(c, b.r1);
+        }
+        for (unsigned int r = b.r1; r > b.r0; --r) {
+            add(b.c0, r);
+        }
+
+        const unsigned int center = index((b.c0 + b.c1) / 2, (b.r0 + b.r1) / 2);
+        for (size_t i = 0; i < border.size(); ++i) {
+            const unsigned int next = border[(i + 1) % border.size()];
+            res.indices.insert(res.indices.end(), { center, border[i], next });
+        }
+    }
+    res.geometryType = GL_TRIANGLES;
+
+    Log::Info(
+        "Simplified correction mesh from %zu to %zu vertices and from %zu to %zu indices",
+        buffer.vertices.size(), res.vertices.size(),
+        buffer.indices.size(), res.indices.size()
+    );
+    buffer = std::move(res);
+}
+
+} // namespace sgct::correction
@@ -14,6 +14,7 @@
 #include <sgct/profiling.h>
 #include <sgct/viewport.h>
 #include <sgct/user.h>
+#include <sgct/correction/textparser.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -39,8 +40,8 @@ Buffer generateSkySkanMesh(const std::string& path, BaseViewport& parent) {
 
     Log::Info("Reading SkySkan mesh data from '%s'", path.c_str());
 
-    FILE* meshFile = fopen(path.c_str(), "r");
-    if (meshFile == nullptr) {
+    const std::optional<std::string> text = readTextFile(path);
+    if (!text) {
         throw Error(2090, "Failed to open file " + path);
     }
 
@@ -56,36 +57,48 @@ Buffer generateSkySkanMesh(const std::string& path, BaseViewport& parent) {
     unsigned int sizeY = 0;
     unsigned int counter = 0;
 
-    while (!feof(meshFile)) {
-        constexpr const int MaxLineLength = 1024;
-        char lineBuffer[MaxLineLength];
-        char* res = fgets(lineBuffer, MaxLineLength, meshFile);
-        if (res == nullptr) {
-            continue;
-        }
+    std::string_view remaining = *text;
+    while (!remaining.empty()) {
+        const std::string_view lineText = nextLine(remaining);
+
+        // Reads the value of a line like 'Dome Azimuth=45'
+        auto readSetting = [&lineText](std::string_view first, std::string_view second,
+                                       float& value)
+        {
+            LineParser line(lineText);
+            return line.consume(first) && line.consume(second) && line.read(value);
+        };
 
         float x, y, u, v;
-        if (sscanf(lineBuffer, "Dome Azimuth=%f", &v) == 1) {
+        LineParser dimsLine(lineText);
+        LineParser vertexLine(lineText);
+        if (readSetting("Dome", "Azimuth=", v)) {
             azimuth = v;
         }
-        else if (sscanf(lineBuffer, "Dome Elevation=%f", &v) == 1) {
+        else if (readSetting("Dome", "Elevation=", v)) {
             elevation = v;
         }
-        else if (sscanf(lineBuffer, "Horizontal FOV=%f", &v) == 1) {
+        else if (readSetting("Horizontal", "FOV=", v)) {
             hFov = v;
         }
-        else if (sscanf(lineBuffer, "Vertical FOV=%f", &v) == 1) {
+        else if (readSetting("Vertical", "FOV=", v)) {
             vFov = v;
         }
-        else if (sscanf(lineBuffer, "Horizontal Tweak=%f", &fovTweaks.x) == 1) {}
-        else if (sscanf(lineBuffer, "Vertical Tweak=%f", &fovTweaks.y) == 1) {}
-        else if (sscanf(lineBuffer, "U Tweak=%f", &uvTweaks.x) == 1) {}
-        else if (sscanf(lineBuffer, "V Tweak=%f", &uvTweaks.y) == 1) {}
-        else if (!areDimsSet && sscanf(lineBuffer, "%u %u", &sizeX, &sizeY) == 2) {
+        else if (readSetting("Horizontal", "Tweak=", fovTweaks.x)) {}
+        else if (readSetting("Vertical", "Tweak=", fovTweaks.y)) {}
+        else if (readSetting("U", "Tweak=", uvTweaks.x)) {}
+        else if (readSetting("V", "Tweak=", uvTweaks.y)) {}
+        else if (!areDimsSet && dimsLine.read(sizeX) && dimsLine.read(sizeY)) {
             areDimsSet = true;
             buf.vertices.resize(sizeX * sizeY);
         }
-        else if (areDimsSet && sscanf(lineBuffer, "%f %f %f %f", &x, &y, &u, &v) == 4) {
+        else if (areDimsSet && vertexLine.read(x) && vertexLine.read(y) &&
+                 vertexLine.read(u) && vertexLine.read(v))
+        {
+            if (counter >= buf.vertices.size()) {
+                continue;
+            }
+
             if (uvTweaks.x > -1.f) {
                 u *= uvTweaks.x;
             }
@@ -107,8 +120,6 @@ Buffer generateSkySkanMesh(const std::string& path, BaseViewport& parent) {
         }
     }
 
-    fclose(meshFile);
-
     if (!areDimsSet || !azimuth.has_value() || !elevation.has_value() ||
         !hFov.has_value() || *hFov <= 0.f)
     {
@@ -149,6 +160,9 @@ Buffer generateSkySkanMesh(const std::string& path, BaseViewport& parent) {
     );
     Engine::instance().updateFrustums();
 
+    if (sizeX > 1 && sizeY > 1) {
+        buf.indices.reserve(6 * (sizeX - 1) * (sizeY - 1));
+    }
     for (unsigned int c = 0; c < (sizeX - 1); c++) {
         for (unsigned int r = 0; r < (sizeY - 1); r++) {
             const unsigned int i0 = r * sizeX + c;
@@ -0,0 +1,287 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/textparser.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace {
+    bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+    }
+
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // The largest mantissa and power of ten that are exactly representable in a type, so
+    // that a number within these limits is correctly rounded by a single multiplication
+    // or division. Every power of ten in the tables is exact as well
+    template <typename T> struct Exact;
+
+    template <> struct Exact<float> {
+        static constexpr uint64_t MaxMantissa = uint64_t(1) << 24;
+        static constexpr int MaxExponent = 10;
+        static constexpr float PowersOfTen[] = {
+            1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+        };
+        static float convert(const char* str, char** end) {
+            return std::strtof(str, end);
+        }
+    };
+
+    template <> struct Exact<double> {
+        static constexpr uint64_t MaxMantissa = uint64_t(1) << 53;
+        static constexpr int MaxExponent = 22;
+        static constexpr double PowersOfTen[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+            1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        static double convert(const char* str, char** end) {
+            return std::strtod(str, end);
+        }
+    };
+
+    /**
+     * Converts the number at the start of [begin, end) with strtof or strtod, which also
+     * handles the nan, inf, and hexadecimal notations. Returns the end of the number, or
+     * nullptr if there is no number
+     */
+    template <typename T>
+    const char* parseFallback(const char* begin, const char* end, T& value) {
+        char buffer[128];
+        const size_t available = static_cast<size_t>(end - begin);
+        const size_t length = std::min(available, sizeof(buffer) - 1);
+        std::memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+        char* last = nullptr;
+        const T v = Exact<T>::convert(buffer, &last);
+        if (last == buffer) {
+            return nullptr;
+        }
+        value = v;
+        return begin + (last - buffer);
+    }
+
+    /**
+     * Parses a floating point number in [begin, end) and returns the end of the number,
+     * or nullptr if there is no number. Decimal numbers with a short mantissa and a small
+     * exponent, which covers all mesh files, are converted directly in the requested
+     * type; the rest are passed on to strtof or strtod, so the result is the same as with
+     * sscanf. std::from_chars would do the same, but its floating point overloads are not
+     * available in all standard libraries that we support.
+     */
+    template <typename T>
+    const char* parseFloatingPoint(const char* begin, const char* end, T& value) {
+        const char* p = begin;
+        const bool isNegative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) {
+            p++;
+        }
+        if (end - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+            return parseFallback(begin, end, value);
+        }
+
+        uint64_t mantissa = 0;
+        int nDigits = 0;
+        int exponent = 0;
+        bool hasDigits = false;
+        for (; p != end && isDigit(*p); ++p) {
+            hasDigits = true;
+            if (nDigits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                nDigits += mantissa > 0 ? 1 : 0;
+            }
+            else {
+                exponent++;
+            }
+        }
+        if (p != end && *p == '.') {
+            for (p++; p != end && isDigit(*p); ++p) {
+                hasDigits = true;
+                if (nDigits < 19) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    nDigits += mantissa > 0 ? 1 : 0;
+                    exponent--;
+                }
+            }
+        }
+        if (!hasDigits) {
+            // Either not a number at all or one of nan, inf, or infinity
+            return parseFallback(begin, end, value);
+        }
+
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            // The exponent is only part of the number if it contains digits
+            const char* e = p + 1;
+            if (e != end && (*e == '-' || *e == '+')) {
+                e++;
+            }
+            int exp = 0;
+            const std::from_chars_result res = std::from_chars(e, end, exp);
+            if (e != end && isDigit(*e) && res.ec == std::errc()) {
+                exponent += (p[1] == '-') ? -exp : exp;
+                p = res.ptr;
+            }
+            else if (res.ec == std::errc::result_out_of_range) {
+                // Something like 1e99999, which is left to strtof or strtod
+                exponent = std::numeric_limits<int>::max();
+                p = res.ptr;
+            }
+        }
+
+        if (exponent < -Exact<T>::MaxExponent || exponent > Exact<T>::MaxExponent ||
+            mantissa > Exact<T>::MaxMantissa)
+        {
+            // Longer numbers are cut off by the fallback, so they are rejected instead
+            if (static_cast<size_t>(p - begin) >= 128) {
+                return nullptr;
+            }
+            return parseFallback(begin, p, value);
+        }
+
+        const T m = static_cast<T>(mantissa);
+        const T* powers = Exact<T>::PowersOfTen;
+        value = exponent < 0 ? m / powers[-exponent] : m * powers[exponent];
+        value = isNegative ? -value : value;
+        return p;
+    }
+} // namespace
+
+namespace sgct::correction {
+
+std::optional<std::string> readTextFile(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return std::nullopt;
+    }
+
+    std::string res;
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size > 0) {
+        res.resize(static_cast<size_t>(size));
+        res.resize(fread(res.data(), 1, res.size(), file));
+    }
+    const bool hasFailed = ferror(file) != 0;
+    fclose(file);
+    if (hasFailed) {
+        return std::nullopt;
+    }
+    return res;
+}
+
+size_t countLines(std::string_view text, std::string_view prefix) {
+    size_t res = 0;
+    while (!text.empty()) {
+        const std::string_view line = nextLine(text);
+        if (line.substr(0, prefix.size()) == prefix) {
+            res++;
+        }
+    }
+    return res;
+}
+
+std::string_view nextLine(std::string_view& text) {
+    const void* newline = std::memchr(text.data(), '\n', text.size());
+    const size_t length = newline ?
+        static_cast<size_t>(static_cast<const char*>(newline) - text.data()) :
+        text.size();
+    const std::string_view line = text.substr(0, length);
+    text.remove_prefix(std::min(length + 1, text.size()));
+    return line;
+}
+
+LineParser::LineParser(std::string_view line)
+    : _pos(line.data())
+    , _end(line.data() + line.size())
+{}
+
+bool LineParser::consume(std::string_view literal) {
+    skipWhitespace();
+    const size_t available = static_cast<size_t>(_end - _pos);
+    if (available < literal.size() ||
+        std::memcmp(_pos, literal.data(), literal.size()) != 0)
+    {
+        return false;
+    }
+    _pos += literal.size();
+    return true;
+}
+
+bool LineParser::read(float& value) {
+    skipWhitespace();
+    const char* end = parseFloatingPoint(_pos, _end, value);
+    if (end == nullptr) {
+        return false;
+    }
+    _pos = end;
+    return true;
+}
+
+bool LineParser::read(double& value) {
+    skipWhitespace();
+    const char* end = parseFloatingPoint(_pos, _end, value);
+    if (end == nullptr) {
+        return false;
+    }
+    _pos = end;
+    return true;
+}
+
+bool LineParser::read(int& value) {
+    skipWhitespace();
+    // std::from_chars does not accept a leading plus sign
+    const char* begin = (_pos != _end && *_pos == '+') ? _pos + 1 : _pos;
+    const std::from_chars_result res = std::from_chars(begin, _end, value);
+    if (res.ec != std::errc()) {
+        return false;
+    }
+    _pos = res.ptr;
+    return true;
+}
+
+bool LineParser::read(unsigned int& value) {
+    skipWhitespace();
+    const char* begin = (_pos != _end && *_pos == '+') ? _pos + 1 : _pos;
+    const std::from_chars_result res = std::from_chars(begin, _end, value);
+    if (res.ec != std::errc()) {
+        return false;
+    }
+    _pos = res.ptr;
+    return true;
+}
+
+std::string_view LineParser::readWord() {
+    skipWhitespace();
+    const char* begin = _pos;
+    while (_pos != _end && !isWhitespace(*_pos)) {
+        _pos++;
+    }
+    return std::string_view(begin, static_cast<size_t>(_pos - begin));
+}
+
+bool LineParser::isEmpty() {
+    skipWhitespace();
+    return _pos == _end;
+}
+
+void LineParser::skipWhitespace() {
+    while (_pos != _end && isWhitespace(*_pos)) {
+        _pos++;
+    }
+}
+
+} // namespace sgct::correction
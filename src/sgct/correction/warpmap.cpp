@@ -0,0 +1,161 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/warpmap.h>
+
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    struct Point {
+        float x;
+        float y;
+    };
+
+    float edge(const Point& a, const Point& b, float x, float y) {
+        return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+    }
+} // namespace
+
+namespace sgct::correction {
+
+WarpMap createWarpMap(const Buffer& buffer, const ivec2& resolution) {
+    ZoneScoped
+
+    WarpMap res;
+    if (buffer.vertices.empty() || resolution.x <= 0 || resolution.y <= 0) {
+        return res;
+    }
+
+    // The map is aligned to the pixels of the window, so that every texel is read by
+    // exactly one pixel and nothing is lost by interpolating between texels
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = -std::numeric_limits<float>::max();
+    float maxY = -std::numeric_limits<float>::max();
+    for (const CorrectionMeshVertex& v : buffer.vertices) {
+        minX = std::min(minX, v.x);
+        minY = std::min(minY, v.y);
+        maxX = std::max(maxX, v.x);
+        maxY = std::max(maxY, v.y);
+    }
+    const float w = static_cast<float>(resolution.x);
+    const float h = static_cast<float>(resolution.y);
+    const int x0 = std::clamp(static_cast<int>(std::floor((minX + 1.f) * 0.5f * w)), 0,
+        resolution.x);
+    const int y0 = std::clamp(static_cast<int>(std::floor((minY + 1.f) * 0.5f * h)), 0,
+        resolution.y);
+    const int x1 = std::clamp(static_cast<int>(std::ceil((maxX + 1.f) * 0.5f * w)), x0,
+        resolution.x);
+    const int y1 = std::clamp(static_cast<int>(std::ceil((maxY + 1.f) * 0.5f * h)), y0,
+        resolution.y);
+    if (x1 == x0 || y1 == y0) {
+        return res;
+    }
+
+    res.position = { 2.f * x0 / w - 1.f, 2.f * y0 / h - 1.f };
+    res.size = { 2.f * (x1 - x0) / w, 2.f * (y1 - y0) / h };
+    res.resolution = { x1 - x0, y1 - y0 };
+    const size_t nTexels = static_cast<size_t>(res.resolution.x) * res.resolution.y;
+    res.texels.resize(nTexels * 3, 0.f);
+    res.colors.resize(nTexels * 4, 0.f);
+
+    // Vertex position in pixels of the map
+    auto toPixel = [&](const CorrectionMeshVertex& v) {
+        return Point{
+            (v.x + 1.f) * 0.5f * w - static_cast<float>(x0),
+            (v.y + 1.f) * 0.5f * h - static_cast<float>(y0)
+        };
+    };
+
+    auto rasterize = [&](const CorrectionMeshVertex& a, const CorrectionMeshVertex& b,
+                         const CorrectionMeshVertex& c)
+    {
+        const Point pa = toPixel(a);
+        const Point pb = toPixel(b);
+        const Point pc = toPixel(c);
+        const float area = edge(pa, pb, pc.x, pc.y);
+        if (area == 0.f) {
+            return;
+        }
+
+        // Pixels whose center is within the triangle or on one of its edges. Pixels on
+        // an edge that is shared by two triangles get the same values from both
+        const int i0 = std::max(
+            static_cast<int>(std::ceil(std::min({ pa.x, pb.x, pc.x }) - 0.5f)), 0
+        );
+        const int j0 = std::max(
+            static_cast<int>(std::ceil(std::min({ pa.y, pb.y, pc.y }) - 0.5f)), 0
+        );
+        const int i1 = std::min(
+            static_cast<int>(std::floor(std::max({ pa.x, pb.x, pc.x }) - 0.5f)),
+            res.resolution.x - 1
+        );
+        const int j1 = std::min(
+            static_cast<int>(std::floor(std::max({ pa.y, pb.y, pc.y }) - 0.5f)),
+            res.resolution.y - 1
+        );
+
+        for (int j = j0; j <= j1; ++j) {
+            const float y = static_cast<float>(j) + 0.5f;
+            for (int i = i0; i <= i1; ++i) {
+                const float x = static_cast<float>(i) + 0.5f;
+                const float la = edge(pb, pc, x, y) / area;
+                const float lb = edge(pc, pa, x, y) / area;
+                const float lc = edge(pa, pb, x, y) / area;
+                if (la < 0.f || lb < 0.f || lc < 0.f) {
+                    continue;
+                }
+
+                const size_t n = static_cast<size_t>(j) * res.resolution.x + i;
+                float* texel = &res.texels[n * 3];
+                texel[0] = la * a.s + lb * b.s + lc * c.s;
+                texel[1] = la * a.t + lb * b.t + lc * c.t;
+                texel[2] = 1.f;
+
+                float* color = &res.colors[n * 4];
+                color[0] = la * a.r + lb * b.r + lc * c.r;
+                color[1] = la * a.g + lb * b.g + lc * c.g;
+                color[2] = la * a.b + lb * b.b + lc * c.b;
+                color[3] = la * a.a + lb * b.a + lc * c.a;
+            }
+        }
+    };
+
+    const std::vector<CorrectionMeshVertex>& v = buffer.vertices;
+    const std::vector<unsigned int>& idx = buffer.indices;
+    if (buffer.geometryType == GL_TRIANGLE_STRIP) {
+        // Every strip starts over after a primitive restart index
+        size_t start = 0;
+        for (size_t i = 0; i < idx.size(); ++i) {
+            if (idx[i] == PrimitiveRestartIndex) {
+                start = i + 1;
+                continue;
+            }
+            if (i >= start + 2) {
+                rasterize(v[idx[i - 2]], v[idx[i - 1]], v[idx[i]]);
+            }
+        }
+    }
+    else {
+        for (size_t i = 0; i + 2 < idx.size(); i += 3) {
+            rasterize(v[idx[i]], v[idx[i + 1]], v[idx[i + 2]]);
+        }
+    }
+
+    auto isNormalized = [](float t) { return t >= 0.f && t <= 1.f; };
+    res.isNormalized = std::all_of(res.texels.cbegin(), res.texels.cend(), isNormalized);
+    res.isColorNormalized =
+        std::all_of(res.colors.cbegin(), res.colors.cend(), isNormalized);
+    return res;
+}
+
+} // namespace sgct::correction
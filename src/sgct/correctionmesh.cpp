@@ -11,23 +11,27 @@
 #include <sgct/error.h>
 #include <sgct/log.h>
 #include <sgct/math.h>
+#include <sgct/memory.h>
 #include <sgct/profiling.h>
 #include <sgct/settings.h>
 #include <sgct/viewport.h>
 #include <sgct/window.h>
 #include <sgct/correction/domeprojection.h>
-#include <sgct/correction/mpcdimesh.h>
+#include <sgct/correction/meshcache.h>
 #include <sgct/correction/obj.h>
 #include <sgct/correction/paulbourke.h>
 #include <sgct/correction/pfm.h>
 #include <sgct/correction/scalable.h>
 #include <sgct/correction/sciss.h>
 #include <sgct/correction/simcad.h>
+#include <sgct/correction/simplify.h>
 #include <sgct/correction/skyskan.h>
 #include <sgct/projection/fisheye.h>
 #include <algorithm>
-#include <fstream>
-#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 #define Error(c, msg) sgct::Error(sgct::Error::Component::CorrectionMesh, c, msg)
 
@@ -92,70 +96,146 @@ correction::Buffer setupSimpleMesh(const vec2& pos, const vec2& size) {
     return buff;
 }
 
-void exportMesh(GLenum type, const std::string& path, const correction::Buffer& buf) {
-    if (type != GL_TRIANGLES && type != GL_TRIANGLE_STRIP) {
-        throw Error(2000, "Failed to export " + path + ". Geometry type not supported");
-    }
+template <typename T>
+unsigned char* write(unsigned char* p, T value) {
+    std::memcpy(p, &value, sizeof(T));
+    return p + sizeof(T);
+}
 
-    std::ofstream file(path, std::ios::out);
-    if (!file.is_open()) {
-        throw Error(2001, "Failed to export " + path + ". Failed to open");
-    }
+// Conversions to the normalized integer formats that the shaders read back as floats
+int16_t toSnorm16(float v) {
+    return static_cast<int16_t>(std::lround(std::clamp(v, -1.f, 1.f) * 32767.f));
+}
 
-    file << std::fixed;
-    file << std::setprecision(6);
-    file << "# SGCT warping mesh\n# Number of vertices: " << buf.vertices.size() << "\n";
+uint16_t toUnorm16(float v) {
+    return static_cast<uint16_t>(std::lround(std::clamp(v, 0.f, 1.f) * 65535.f));
+}
 
-    // export vertices
-    for (const sgct::correction::CorrectionMeshVertex& vertex : buf.vertices) {
-        file << "v " << vertex.x << ' ' << vertex.y << " 0\n";
-    }
+uint8_t toUnorm8(float v) {
+    return static_cast<uint8_t>(std::lround(std::clamp(v, 0.f, 1.f) * 255.f));
+}
 
-    // export texture coords
-    for (const sgct::correction::CorrectionMeshVertex& vertex : buf.vertices) {
-        file << "vt " << vertex.s << ' ' << vertex.t << " 0\n";
-    }
+std::string extension(const std::string& path) {
+    return path.substr(path.rfind('.') + 1);
+}
+
+// SCISS and SkySkan meshes also change the projection of the viewport and update the
+// frustums of all windows while they are parsed
+bool changesProjection(const std::string& ext) {
+    return ext == "sgc" || ext == "skyskan" || ext == "txt";
+}
 
-    // export generated normals
-    file.write("vn 0 0 1\n", buf.vertices.size());
+correction::Buffer parseMesh(const std::string& path, BaseViewport& parent,
+                             const CorrectionMesh::WindowState& window)
+{
+    ZoneScoped
 
-    file << "# Number of faces: " << buf.indices.size() / 3 << '\n';
+    using namespace correction;
+    const vec2& parentPos = parent.position();
+    const vec2& parentSize = parent.size();
+    const std::string ext = extension(path);
+
+    // Meshes that change the projection of the viewport need to be parsed every time and
+    // MPCDI meshes are not read from a file, so these are never cached
+    const bool isCacheable = !changesProjection(ext) && ext != "mpcdi";
+    const std::string cacheFolder =
+        isCacheable ? Settings::instance().warpingMeshCachePath() : "";
+    const float aspectRatio = window.aspectRatio;
+
+    // The tolerance is given in pixels of the window, which is turned into an error of
+    // the texture coordinates that cover the whole framebuffer
+    const float pixels = Settings::instance().warpingMeshTolerance();
+    const ivec2 res = window.framebufferResolution;
+    const vec2 tolerance = {
+        pixels / static_cast<float>(std::max(res.x, 1)),
+        pixels / static_cast<float>(std::max(res.y, 1))
+    };
 
-    // export face indices
-    if (type == GL_TRIANGLES) {
-        for (unsigned int i = 0; i < buf.indices.size(); i += 3) {
-            file << "f " << buf.indices[i] + 1 << '/' << buf.indices[i] + 1 << '/'
-                 << buf.indices[i] + 1 << ' ';
-            file << buf.indices[i + 1u] + 1 << '/' << buf.indices[i + 1u] + 1 << '/'
-                 << buf.indices[i + 1u] + 1 << ' ';
-            file << buf.indices[i + 2u] + 1 << '/' << buf.indices[i + 2u] + 1 << '/'
-                 << buf.indices[i + 2u] + 1 << '\n';
+    if (!cacheFolder.empty()) {
+        std::optional<Buffer> cached = loadCachedMesh(
+            cacheFolder, path, parentPos, parentSize, aspectRatio, tolerance
+        );
+        if (cached) {
+            return std::move(*cached);
         }
     }
-    else {
-        // first base triangle
-        file << "f " << buf.indices[0] + 1 << '/' << buf.indices[0] + 1 << '/'
-             << buf.indices[0] + 1 << ' ';
-        file << buf.indices[1] + 1 << '/' << buf.indices[1] + 1 << '/'
-             << buf.indices[1] + 1 << ' ';
-        file << buf.indices[2] + 1 << '/' << buf.indices[2] + 1 << '/'
-             << buf.indices[2] + 1 << '\n';
-
-        for (unsigned int i = 2; i < buf.indices.size(); i++) {
-            file << "f " << buf.indices[i] + 1 << '/' << buf.indices[i] + 1 << '/'
-                 << buf.indices[i] + 1 << ' ';
-            file << buf.indices[i - 1] + 1 << '/' << buf.indices[i - 1] + 1 << '/'
-                 << buf.indices[i - 1] + 1 << ' ';
-            file << buf.indices[i - 2] + 1 << '/' << buf.indices[i - 2] + 1 << '/'
-                 << buf.indices[i - 2] + 1 << '\n';
+
+    // find a suitable format
+    Buffer buf;
+    if (ext == "sgc") {
+        buf = generateScissMesh(path, parent);
+    }
+    else if (ext == "ol") {
+        buf = generateScalableMesh(path, parentPos, parentSize);
+    }
+    else if (ext == "skyskan") {
+        buf = generateSkySkanMesh(path, parent);
+    }
+    else if (ext == "txt") {
+        buf = generateSkySkanMesh(path, parent);
+    }
+    else if (ext == "csv") {
+        buf = generateDomeProjectionMesh(path, parentPos, parentSize);
+    }
+    else if (ext == "data") {
+        buf = generatePaulBourkeMesh(path, parentPos, parentSize, aspectRatio);
+    }
+    else if (ext == "obj") {
+        buf = generateOBJMesh(path);
+    }
+    else if (ext == "pfm") {
+        buf = generatePerEyeMeshFromPFMImage(path, parentPos, parentSize);
+    }
+    else if (ext == "mpcdi") {
+        // The mesh was already built while the MPCDI file was read
+        Viewport* vp = dynamic_cast<Viewport*>(&parent);
+        std::optional<Buffer> mesh = vp ? vp->takeMpcdiWarpMesh() : std::nullopt;
+        if (!mesh) {
+            throw Error(2020, "Configuration error. Trying load MPCDI to wrong viewport");
         }
+        buf = std::move(*mesh);
+    }
+    else if (ext == "simcad") {
+        buf = generateSimCADMesh(path, parentPos, parentSize);
+    }
+    else {
+        throw Error(2002, "Could not determine format for warping mesh");
+    }
+
+    if (pixels > 0.f) {
+        simplifyGridMesh(buf, tolerance);
     }
 
-    Log::Info("Mesh '%s' exported successfully", path.c_str());
+    if (!cacheFolder.empty()) {
+        cacheMesh(cacheFolder, path, parentPos, parentSize, aspectRatio, tolerance, buf);
+    }
+    return buf;
 }
 
 } // namespace
 
+CorrectionMesh::WindowState CorrectionMesh::windowState(const Window& window) {
+    WindowState res;
+    res.aspectRatio = window.aspectRatio();
+    res.framebufferResolution = window.framebufferResolution();
+    // The warp map is drawn directly to the window, so it uses the window's resolution
+    // on the screen rather than the resolution of the frame buffer
+    res.outputResolution = ivec2{
+        static_cast<int>(std::ceil(window.scale().x * window.resolution().x)),
+        static_cast<int>(std::ceil(window.scale().y * window.resolution().y))
+    };
+    return res;
+}
+
+CorrectionMesh::~CorrectionMesh() {
+    for (unsigned int tex : { _warpMap, _warpMapColor }) {
+        if (tex) {
+            memory::untrackTexture(tex);
+            glDeleteTextures(1, &tex);
+        }
+    }
+}
+
 CorrectionMesh::CorrectionMeshGeometry::~CorrectionMeshGeometry() {
     // Yes, glDeleteVertexArrays and glDeleteBuffers work when passing 0, but this check
     // is a standin for whether they were created in the first place. This would only fail
@@ -169,10 +249,45 @@ CorrectionMesh::CorrectionMeshGeometry::~CorrectionMeshGeometry() {
     if (ibo) {
         glDeleteBuffers(1, &ibo);
     }
+    memory::track(memory::Subsystem::CorrectionMesh, bytes, 0);
+}
+
+void CorrectionMesh::CorrectionMeshGeometry::render() const {
+    if (!hasVertexColors) {
+        // The constant vertex attribute is not part of the vertex array object
+        glVertexAttrib4fv(2, color);
+    }
+    // Triangle strips can contain multiple strips that are separated by the largest
+    // value of the index type, which is never a valid index
+    const bool hasRestart = type == GL_TRIANGLE_STRIP;
+    if (hasRestart) {
+        glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(indexType == GL_UNSIGNED_SHORT ? 0xFFFF : 0xFFFFFFFF);
+    }
+    glBindVertexArray(vao);
+    glDrawElements(type, nIndices, indexType, nullptr);
+    glBindVertexArray(0);
+    if (hasRestart) {
+        glDisable(GL_PRIMITIVE_RESTART);
+    }
+}
+
+void CorrectionMesh::readMesh(const std::string& path, BaseViewport& parent,
+                              const WindowState& window, bool useWarpMap)
+{
+    ZoneScoped
+
+    if (path.empty() || changesProjection(extension(path))) {
+        return;
+    }
+    _buffer = parseMesh(path, parent, window);
+    if (useWarpMap) {
+        _warpMapData = correction::createWarpMap(*_buffer, window.outputResolution);
+    }
 }
 
 void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
-                              bool needsMaskGeometry)
+                              bool needsMaskGeometry, bool useWarpMap)
 {
     ZoneScoped
 
@@ -203,30 +318,12 @@ void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
         return;
     }
 
-    Buffer buf;
-
-    std::string ext = path.substr(path.rfind('.') + 1);
-
-    // find a suitable format
-    if (ext == "sgc") {
-        buf = generateScissMesh(path, parent);
-    }
-    else if (ext == "ol") {
-        buf = generateScalableMesh(path, parentPos, parentSize);
-    }
-    else if (ext == "skyskan") {
-        buf = generateSkySkanMesh(path, parent);
-    }
-    else if (ext == "txt") {
-        buf = generateSkySkanMesh(path, parent);
-    }
-    else if (ext == "csv") {
-        buf = generateDomeProjectionMesh(path, parentPos, parentSize);
-    }
-    else if (ext == "data") {
-        const float aspectRatio = parent.window().aspectRatio();
-        buf = generatePaulBourkeMesh(path, parentPos, parentSize, aspectRatio);
+    // use the mesh from readMesh if it was already parsed
+    const WindowState window = windowState(parent.window());
+    Buffer buf = _buffer ? std::move(*_buffer) : parseMesh(path, parent, window);
+    _buffer = std::nullopt;
 
+    if (extension(path) == "data") {
         // force regeneration of dome render quad
         if (Viewport* vp = dynamic_cast<Viewport*>(&parent); vp) {
             auto fishPrj = dynamic_cast<FisheyeProjection*>(vp->nonLinearProjection());
@@ -236,28 +333,19 @@ void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
             }
         }
     }
-    else if (ext == "obj") {
-        buf = generateOBJMesh(path);
-    }
-    else if (ext == "pfm") {
-        buf = generatePerEyeMeshFromPFMImage(path, parentPos, parentSize);
-    }
-    else if (ext == "mpcdi") {
-        const Viewport* vp = dynamic_cast<const Viewport*>(&parent);
-        if (vp == nullptr) {
-            throw Error(2020, "Configuration error. Trying load MPCDI to wrong viewport");
-        }
-        buf = generateMpcdiMesh(vp->mpcdiWarpMesh());
-    }
-    else if (ext == "simcad") {
-        buf = generateSimCADMesh(path, parentPos, parentSize);
-    }
-    else {
-        throw Error(2002, "Could not determine format for warping mesh");
-    }
 
     createMesh(_warpGeometry, buf);
 
+    // The mesh is kept even if there is a warp map, as the stereo modes that combine
+    // both eyes in their own shader can only render the mesh
+    if (useWarpMap) {
+        if (!_warpMapData) {
+            _warpMapData = correction::createWarpMap(buf, window.outputResolution);
+        }
+        createWarpMap(*_warpMapData);
+        _warpMapData = std::nullopt;
+    }
+
     Log::Debug(
         "CorrectionMesh read successfully. Vertices=%u, Indices=%u",
         static_cast<int>(buf.vertices.size()), static_cast<int>(buf.indices.size())
@@ -265,33 +353,45 @@ void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
 
     if (Settings::instance().exportWarpingMeshes()) {
         const size_t found = path.find_last_of('.');
-        std::string filename = path.substr(0, found) + "_export.obj";
-        exportMesh(_warpGeometry.type, std::move(filename), buf);
+        const std::string filename = path.substr(0, found) + "_export.obj";
+        exportOBJMesh(filename, buf);
     }
 }
 
 void CorrectionMesh::renderQuadMesh() const {
     TracyGpuZone("Render Quad mesh")
 
-    glBindVertexArray(_quadGeometry.vao);
-    glDrawElements(_quadGeometry.type, _quadGeometry.nIndices, GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
+    _quadGeometry.render();
 }
 
 void CorrectionMesh::renderWarpMesh() const {
     TracyGpuZone("Render Warp mesh")
 
-    glBindVertexArray(_warpGeometry.vao);
-    glDrawElements(_warpGeometry.type, _warpGeometry.nIndices, GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
+    _warpGeometry.render();
 }
 
 void CorrectionMesh::renderMaskMesh() const {
     TracyGpuZone("Render Mask mesh")
 
-    glBindVertexArray(_maskGeometry.vao);
-    glDrawElements(_maskGeometry.type, _maskGeometry.nIndices, GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
+    _maskGeometry.render();
+}
+
+void CorrectionMesh::renderWarpMap() const {
+    TracyGpuZone("Render Warp map")
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, _warpMap);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, _warpMapColor);
+    _warpMapGeometry.render();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+bool CorrectionMesh::hasWarpMap() const {
+    return _warpMap != 0;
 }
 
 void CorrectionMesh::createMesh(CorrectionMeshGeometry& geom,
@@ -300,41 +400,228 @@ void CorrectionMesh::createMesh(CorrectionMeshGeometry& geom,
     ZoneScoped
     TracyGpuZone("createMesh")
 
-    glGenVertexArrays(1, &geom.vao);
+    using correction::CorrectionMeshVertex;
+    const std::vector<CorrectionMeshVertex>& vertices = buffer.vertices;
+
+    // The vertex layout is picked per mesh. Positions in [-1, 1] and texture coordinates
+    // in [0, 1], which covers almost all meshes, are stored as normalized 16-bit integers
+    // instead of floats. Vertex colors are only stored if they differ between vertices,
+    // and then as RGBA8. The shaders read all of these formats as floats
+    const bool packPositions = std::all_of(
+        vertices.cbegin(),
+        vertices.cend(),
+        [](const CorrectionMeshVertex& v) {
+            return std::abs(v.x) <= 1.f && std::abs(v.y) <= 1.f;
+        }
+    );
+    const bool packTexCoords = std::all_of(
+        vertices.cbegin(),
+        vertices.cend(),
+        [](const CorrectionMeshVertex& v) {
+            return v.s >= 0.f && v.s <= 1.f && v.t >= 0.f && v.t <= 1.f;
+        }
+    );
+    const bool hasUniformColor = std::all_of(
+        vertices.cbegin(),
+        vertices.cend(),
+        [&vertices](const CorrectionMeshVertex& v) {
+            const CorrectionMeshVertex& f = vertices.front();
+            return v.r == f.r && v.g == f.g && v.b == f.b && v.a == f.a;
+        }
+    );
+
+    const size_t positionSize = packPositions ? 2 * sizeof(int16_t) : 2 * sizeof(float);
+    const size_t texCoordSize = packTexCoords ? 2 * sizeof(uint16_t) : 2 * sizeof(float);
+    const size_t colorSize = hasUniformColor ? 0 : 4 * sizeof(uint8_t);
+    const size_t stride = positionSize + texCoordSize + colorSize;
+
+    std::vector<unsigned char> data(vertices.size() * stride);
+    unsigned char* p = data.data();
+    for (const CorrectionMeshVertex& v : vertices) {
+        if (packPositions) {
+            p = write(write(p, toSnorm16(v.x)), toSnorm16(v.y));
+        }
+        else {
+            p = write(write(p, v.x), v.y);
+        }
+        if (packTexCoords) {
+            p = write(write(p, toUnorm16(v.s)), toUnorm16(v.t));
+        }
+        else {
+            p = write(write(p, v.s), v.t);
+        }
+        if (!hasUniformColor) {
+            p = write(write(write(write(p, toUnorm8(v.r)), toUnorm8(v.g)), toUnorm8(v.b)),
+                toUnorm8(v.a));
+        }
+    }
+
+    // A mesh that is loaded again keeps its objects and only replaces their storage. As
+    // the size and layout of the vertices can change, the buffers are specified anew with
+    // glBufferData, which orphans the old storage instead of waiting for frames in flight
+    if (geom.vao == 0) {
+        glGenVertexArrays(1, &geom.vao);
+        glGenBuffers(1, &geom.vbo);
+        glGenBuffers(1, &geom.ibo);
+    }
     glBindVertexArray(geom.vao);
 
-    glGenBuffers(1, &geom.vbo);
     glBindBuffer(GL_ARRAY_BUFFER, geom.vbo);
-    constexpr const int s = sizeof(correction::CorrectionMeshVertex);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        buffer.vertices.size() * s,
-        buffer.vertices.data(),
-        GL_STATIC_DRAW
-    );
+    glBufferData(GL_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
 
+    const GLsizei s = static_cast<GLsizei>(stride);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, s, nullptr);
+    if (packPositions) {
+        glVertexAttribPointer(0, 2, GL_SHORT, GL_TRUE, s, nullptr);
+    }
+    else {
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, s, nullptr);
+    }
 
+    void* texCoordOffset = reinterpret_cast<void*>(positionSize);
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, s, reinterpret_cast<void*>(8));
+    if (packTexCoords) {
+        glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, s, texCoordOffset);
+    }
+    else {
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, s, texCoordOffset);
+    }
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, s, reinterpret_cast<void*>(16));
+    if (hasUniformColor) {
+        glDisableVertexAttribArray(2);
+        geom.hasVertexColors = false;
+        if (!vertices.empty()) {
+            geom.color[0] = vertices.front().r;
+            geom.color[1] = vertices.front().g;
+            geom.color[2] = vertices.front().b;
+            geom.color[3] = vertices.front().a;
+        }
+    }
+    else {
+        void* colorOffset = reinterpret_cast<void*>(positionSize + texCoordSize);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, s, colorOffset);
+        geom.hasVertexColors = true;
+    }
 
-    glGenBuffers(1, &geom.ibo);
+    // 16-bit indices are enough for any mesh with at most 65535 vertices, which leaves
+    // 0xFFFF for the PrimitiveRestartIndex
+    const bool hasShortIndices = vertices.size() <= std::numeric_limits<uint16_t>::max();
+    size_t indexBytes = 0;
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom.ibo);
-    glBufferData(
-        GL_ELEMENT_ARRAY_BUFFER,
-        buffer.indices.size() * sizeof(unsigned int),
-        buffer.indices.data(),
-        GL_STATIC_DRAW
-    );
+    if (hasShortIndices) {
+        std::vector<uint16_t> indices(buffer.indices.size());
+        std::transform(
+            buffer.indices.cbegin(),
+            buffer.indices.cend(),
+            indices.begin(),
+            [](unsigned int i) { return static_cast<uint16_t>(i); }
+        );
+        indexBytes = indices.size() * sizeof(uint16_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices.data(), GL_STATIC_DRAW);
+    }
+    else {
+        indexBytes = buffer.indices.size() * sizeof(unsigned int);
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            indexBytes,
+            buffer.indices.data(),
+            GL_STATIC_DRAW
+        );
+    }
     glBindVertexArray(0);
 
-    geom.nVertices = static_cast<int>(buffer.vertices.size());
+    geom.nVertices = static_cast<int>(vertices.size());
     geom.nIndices = static_cast<int>(buffer.indices.size());
     geom.type = buffer.geometryType;
+    geom.indexType = hasShortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    memory::track(
+        memory::Subsystem::CorrectionMesh,
+        geom.bytes,
+        data.size() + indexBytes
+    );
+
+    Log::Debug(
+        "Correction mesh uses %d bytes per vertex and %d bit indices",
+        static_cast<int>(stride), hasShortIndices ? 16 : 32
+    );
+}
+
+void CorrectionMesh::createWarpMap(const correction::WarpMap& map) {
+    ZoneScoped
+    TracyGpuZone("createWarpMap")
+
+    if (map.resolution.x == 0 || map.resolution.y == 0) {
+        Log::Warning("Correction mesh does not cover any pixels. Using the mesh instead");
+        // A reloaded mesh replaces the warp map of the previous one
+        for (unsigned int* tex : { &_warpMap, &_warpMapColor }) {
+            if (*tex) {
+                memory::untrackTexture(*tex);
+                glDeleteTextures(1, tex);
+                *tex = 0;
+            }
+        }
+        return;
+    }
+
+    auto upload = [&map](unsigned int& texture, GLenum format, GLenum pixelFormat,
+                         const std::vector<float>& data)
+    {
+        if (texture == 0) {
+            glGenTextures(1, &texture);
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            format,
+            map.resolution.x,
+            map.resolution.y,
+            0,
+            pixelFormat,
+            GL_FLOAT,
+            data.data()
+        );
+        // Every texel belongs to exactly one pixel and interpolating the coverage along
+        // the outline of the mesh would mix in texture coordinates of uncovered texels
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        memory::trackTexture(
+            memory::Subsystem::CorrectionMesh,
+            texture,
+            memory::estimateImageBytes(format, map.resolution.x, map.resolution.y)
+        );
+    };
+
+    // Half floats are not precise enough for the texture coordinates of large windows,
+    // so they are stored as normalized 16-bit integers unless they are outside [0, 1]
+    upload(_warpMap, map.isNormalized ? GL_RGB16 : GL_RGB32F, GL_RGB, map.texels);
+    // The colors are kept per channel, as the mesh can blend each channel differently
+    const GLenum colorFormat = map.isColorNormalized ? GL_RGBA16 : GL_RGBA16F;
+    upload(_warpMapColor, colorFormat, GL_RGBA, map.colors);
+
+    const float x0 = map.position.x;
+    const float y0 = map.position.y;
+    const float x1 = map.position.x + map.size.x;
+    const float y1 = map.position.y + map.size.y;
+    correction::Buffer buf;
+    buf.geometryType = GL_TRIANGLE_STRIP;
+    buf.indices = { 0, 3, 1, 2 };
+    buf.vertices = {
+        { x0, y0, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f },
+        { x1, y0, 1.f, 0.f, 1.f, 1.f, 1.f, 1.f },
+        { x1, y1, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f },
+        { x0, y1, 0.f, 1.f, 1.f, 1.f, 1.f, 1.f }
+    };
+    createMesh(_warpMapGeometry, buf);
+
+    Log::Debug(
+        "Correction mesh rasterized into a %dx%d warp map",
+        map.resolution.x, map.resolution.y
+    );
 }
 
 } // namespace sgct
@@ -0,0 +1,79 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/dynamicresolution.h>
+
+#include <sgct/log.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // A new scale is distributed with the next frame's synchronization and applied at the
+    // end of that frame. That frame is still rendered with the old scale and the frame
+    // after it pays for reallocating the framebuffers, so neither is representative
+    constexpr const int SettleFrames = 2;
+} // namespace
+
+namespace sgct {
+
+DynamicResolution::DynamicResolution(Settings::DynamicResolution settings)
+    : _settings(std::move(settings))
+    , _scale(_settings.maxScale)
+{}
+
+bool DynamicResolution::addFrameTime(double frameTime) {
+    if (_nFramesToSkip > 0) {
+        _nFramesToSkip--;
+        return false;
+    }
+
+    _accumulatedTime += frameTime;
+    _nFrames++;
+    if (_nFrames < _settings.frames) {
+        return false;
+    }
+
+    const double average = _accumulatedTime / _nFrames;
+    _accumulatedTime = 0.0;
+    _nFrames = 0;
+
+    const double target = 1.0 / _settings.targetFrameRate;
+    float scale = _scale;
+    if (average > target) {
+        // Jump directly to the scale that is predicted to meet the target, but always
+        // move by at least one step
+        const float predicted = _scale * static_cast<float>(std::sqrt(target / average));
+        scale = std::min(predicted, _scale - _settings.step);
+    }
+    else {
+        const float next = std::min(_scale + _settings.step, _settings.maxScale);
+        const double ratio = static_cast<double>(next) / static_cast<double>(_scale);
+        if (average * ratio * ratio < target * (1.0 - _settings.hysteresis)) {
+            scale = next;
+        }
+    }
+    scale = std::clamp(scale, _settings.minScale, _settings.maxScale);
+
+    if (scale == _scale) {
+        return false;
+    }
+
+    Log::Debug(
+        "Resolution scale changed from %.2f to %.2f (average frame time %.2f ms)",
+        _scale, scale, average * 1000.0
+    );
+    _scale = scale;
+    _nFramesToSkip = SettleFrames;
+    return true;
+}
+
+float DynamicResolution::scale() const {
+    return _scale;
+}
+
+} // namespace sgct
@@ -8,13 +8,17 @@
 
 #include <sgct/engine.h>
 
+#include <sgct/captureservice.h>
 #include <sgct/clustermanager.h>
 #include <sgct/commandline.h>
 #include <sgct/error.h>
+#include <sgct/filewatcher.h>
 #include <sgct/font.h>
 #include <sgct/fontmanager.h>
 #include <sgct/freetype.h>
 #include <sgct/internalshaders.h>
+#include <sgct/memory.h>
+#include <sgct/mutexes.h>
 #include <sgct/networkmanager.h>
 #include <sgct/node.h>
 #include <sgct/offscreenbuffer.h>
@@ -30,6 +34,9 @@
 #include <sgct/version.h>
 #include <sgct/projection/nonlinearprojection.h>
 #include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <future>
 #include <iostream>
 #include <numeric>
 
@@ -100,6 +107,176 @@ namespace {
         }
     }
 
+    template <typename T>
+    bool contains(const std::vector<T>& values, const T& value) {
+        return std::find(values.cbegin(), values.cend(), value) != values.cend();
+    }
+
+    template <typename T>
+    void addUnique(std::vector<T>& values, const T& value) {
+        if (!contains(values, value)) {
+            values.push_back(value);
+        }
+    }
+
+    std::vector<Viewport*> allViewports(const std::vector<std::unique_ptr<Window>>& ws) {
+        std::vector<Viewport*> res;
+        for (const std::unique_ptr<Window>& win : ws) {
+            for (const std::unique_ptr<Viewport>& vp : win->viewports()) {
+                res.push_back(vp.get());
+            }
+        }
+        return res;
+    }
+
+    /// A viewport whose data is read together with the state of its window
+    struct ViewportRead {
+        Viewport* viewport = nullptr;
+        CorrectionMesh::WindowState window;
+    };
+
+    /**
+     * Copies the state of the windows that the viewports belong to. This has to happen on
+     * the render thread, as it can change the windows while the data is read
+     */
+    std::vector<ViewportRead> prepareRead(const std::vector<Viewport*>& viewports) {
+        std::vector<ViewportRead> res;
+        res.reserve(viewports.size());
+        for (Viewport* vp : viewports) {
+            res.push_back({ vp, CorrectionMesh::windowState(vp->window()) });
+        }
+        return res;
+    }
+
+    /**
+     * Reads the correction meshes and mask images of the viewports on a pool of worker
+     * threads. An exception that is thrown for one of the viewports is rethrown after all
+     * threads are finished
+     */
+    void readViewportData(const std::vector<ViewportRead>& reads) {
+        ZoneScoped
+
+        struct Task {
+            Viewport* viewport = nullptr;
+            CorrectionMesh::WindowState windowState;
+            int window = 0;
+            int index = 0;
+            double duration = 0.0;
+            std::exception_ptr error;
+        };
+        std::vector<Task> tasks;
+        for (const ViewportRead& read : reads) {
+            Viewport* vp = read.viewport;
+            const std::vector<std::unique_ptr<Viewport>>& vps = vp->window().viewports();
+            const auto it = std::find_if(
+                vps.cbegin(),
+                vps.cend(),
+                [vp](const std::unique_ptr<Viewport>& v) { return v.get() == vp; }
+            );
+            Task task;
+            task.viewport = vp;
+            task.windowState = read.window;
+            task.window = vp->window().id();
+            task.index = static_cast<int>(std::distance(vps.cbegin(), it));
+            tasks.push_back(task);
+        }
+        if (tasks.empty()) {
+            return;
+        }
+
+        std::atomic<size_t> next = 0;
+        auto work = [&]() {
+            for (size_t i = next++; i < tasks.size(); i = next++) {
+                const double t = Engine::getTime();
+                try {
+                    tasks[i].viewport->readData(tasks[i].windowState);
+                }
+                catch (...) {
+                    tasks[i].error = std::current_exception();
+                }
+                tasks[i].duration = Engine::getTime() - t;
+            }
+        };
+
+        const int nCores = static_cast<int>(std::thread::hardware_concurrency());
+        const int nThreads = std::clamp(nCores, 1, static_cast<int>(tasks.size()));
+        const double t0 = Engine::getTime();
+        std::vector<std::future<void>> workers;
+        for (int i = 1; i < nThreads; ++i) {
+            workers.push_back(std::async(std::launch::async, work));
+        }
+        work();
+        for (std::future<void>& worker : workers) {
+            worker.get();
+        }
+        const double duration = Engine::getTime() - t0;
+
+        double total = 0.0;
+        for (const Task& task : tasks) {
+            Log::Debug(
+                "Window %d, viewport %d: Read correction data in %.1f ms",
+                task.window, task.index, task.duration * 1000.0
+            );
+            total += task.duration;
+        }
+        Log::Info(
+            "Read correction data of %d viewports in %.1f ms on %d threads (%.1f ms when "
+            "read one after another)",
+            static_cast<int>(tasks.size()), duration * 1000.0, nThreads, total * 1000.0
+        );
+
+        for (const Task& task : tasks) {
+            if (task.error) {
+                std::rethrow_exception(task.error);
+            }
+        }
+    }
+
+    // 64-bit FNV-1a, which is sufficient to detect changes between consecutive frames
+    constexpr const uint64_t HashOffset = 14695981039346656037ull;
+
+    void hashBytes(uint64_t& hash, const void* data, size_t size) {
+        constexpr const uint64_t Prime = 1099511628211ull;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * Prime;
+        }
+    }
+
+    uint64_t sceneStateHash() {
+        ZoneScoped
+
+        uint64_t hash = HashOffset;
+        {
+            // The master's data block starts with the network header, which contains
+            // the frame number and thus changes every frame. The same is true for the
+            // cluster frame number at the start of SGCT's own state
+            std::unique_lock lk(mutex::DataSync);
+            SharedData& sd = SharedData::instance();
+            const int header = NetworkManager::instance().isComputerServer() ?
+                static_cast<int>(Network::HeaderSize) :
+                0;
+            const int offset =
+                header + static_cast<int>(sizeof(uint32_t) + sizeof(unsigned int));
+            if (sd.dataSize() > offset) {
+                hashBytes(hash, sd.dataBlock() + offset, sd.dataSize() - offset);
+            }
+        }
+
+        for (const std::unique_ptr<User>& user : ClusterManager::instance().users()) {
+            hashBytes(hash, &user->posMono(), sizeof(vec3));
+            hashBytes(hash, &user->posLeftEye(), sizeof(vec3));
+            hashBytes(hash, &user->posRightEye(), sizeof(vec3));
+        }
+
+        const Node& thisNode = ClusterManager::instance().thisNode();
+        for (const std::unique_ptr<Window>& win : thisNode.windows()) {
+            const Window::StereoMode sm = win->stereoMode();
+            hashBytes(hash, &sm, sizeof(sm));
+        }
+        return hash;
+    }
+
     void addValue(std::array<double, Engine::Statistics::HistoryLength>& a, double v) {
         std::rotate(std::rbegin(a), std::rbegin(a) + 1, std::rend(a));
         a[0] = v;
@@ -330,6 +507,48 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
 
     SharedData::instance().setEncodeFunction(std::move(callbacks.encode));
     SharedData::instance().setDecodeFunction(std::move(callbacks.decode));
+    SharedData::instance().setInternalEncodeFunction(
+        [this](std::vector<std::byte>& data) {
+            // The frame number has to come first as it is excluded from sceneStateHash
+            serializeObject(data, _capture.frameNumber);
+            serializeObject(data, _capture.shotNumber);
+            serializeObject(data, _capture.takeScreenshot);
+            serializeObject(data, _capture.isRecording);
+            const float scale = _resolutionScale;
+            serializeObject(data, scale);
+            serializeObject(data, _correction.generation);
+            serializeObject(data, static_cast<uint32_t>(_correction.files.size()));
+            for (const std::string& file : _correction.files) {
+                serializeObject(data, file);
+            }
+        }
+    );
+    SharedData::instance().setInternalDecodeFunction(
+        [this](const std::vector<std::byte>& data, unsigned int pos) {
+            CaptureState capture;
+            deserializeObject(data, pos, capture.frameNumber);
+            deserializeObject(data, pos, capture.shotNumber);
+            deserializeObject(data, pos, capture.takeScreenshot);
+            deserializeObject(data, pos, capture.isRecording);
+            {
+                std::unique_lock lk(mutex::DataSync);
+                _receivedCapture = capture;
+            }
+            float scale;
+            deserializeObject(data, pos, scale);
+            _resolutionScale = scale;
+            CorrectionState correction;
+            deserializeObject(data, pos, correction.generation);
+            uint32_t nFiles = 0;
+            deserializeObject(data, pos, nFiles);
+            correction.files.resize(nFiles);
+            for (std::string& file : correction.files) {
+                deserializeObject(data, pos, file);
+            }
+            std::unique_lock lk(mutex::DataSync);
+            _receivedCorrection = std::move(correction);
+        }
+    );
 
     gKeyboardCallback = std::move(callbacks.keyboard);
     gCharCallback = std::move(callbacks.character);
@@ -360,12 +579,30 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
     if (config.captureFormat) {
         Settings::instance().setCaptureFormat(*config.captureFormat);
     }
+    if (config.captureVideoCommand) {
+        Settings::instance().setCaptureVideoCommand(*config.captureVideoCommand);
+    }
+    if (config.record) {
+        _isRecording = *config.record;
+    }
     if (config.nCaptureThreads) {
         Settings::instance().setNumberOfCaptureThreads(*config.nCaptureThreads);
     }
     if (config.exportCorrectionMeshes) {
         Settings::instance().setExportWarpingMeshes(*config.exportCorrectionMeshes);
     }
+    if (config.useCorrectionMeshCache) {
+        Settings::instance().setUseWarpingMeshCache(*config.useCorrectionMeshCache);
+    }
+    if (config.correctionMeshCachePath) {
+        Settings::instance().setWarpingMeshCachePath(*config.correctionMeshCachePath);
+    }
+    if (config.correctionMeshTolerance) {
+        Settings::instance().setWarpingMeshTolerance(*config.correctionMeshTolerance);
+    }
+    if (config.watchCorrectionFiles) {
+        _watchCorrectionFiles = *config.watchCorrectionFiles;
+    }
     if (config.useOpenGLDebugContext) {
         _createDebugContext = *config.useOpenGLDebugContext;
     }
@@ -383,6 +620,19 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
             !*config.omitWindowNameInScreenshot
         );
     }
+    if (config.benchmarkFrames || config.benchmarkSeconds) {
+        _benchmark = Benchmark();
+        _benchmark->nFrames = config.benchmarkFrames;
+        _benchmark->duration = config.benchmarkSeconds;
+    }
+    if (config.useSoftwareOpenGL && *config.useSoftwareOpenGL) {
+#ifdef WIN32
+        Log::Warning("Software OpenGL is not supported on this operating system");
+#else // WIN32
+        // Mesa reads this variable when the first OpenGL context is created
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+#endif // WIN32
+    }
     if (cluster.setThreadAffinity) {
 #ifdef WIN32
         SetThreadAffinityMask(GetCurrentThread(), *cluster.setThreadAffinity);
@@ -471,7 +721,7 @@ void Engine::initialize() {
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
         glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
     #endif
-        glfwWindowHint(GLFW_VISIBLE, static_cast<int>(GL_FALSE));
+        glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
         GLFWwindow* offscreen = glfwCreateWindow(128, 128, "", nullptr, nullptr);
         glfwMakeContextCurrent(offscreen);
         gladLoadGL();
@@ -482,16 +732,47 @@ void Engine::initialize() {
 
         // And get rid of the window again
         glfwDestroyWindow(offscreen);
-        glfwWindowHint(GLFW_VISIBLE, static_cast<int>(GL_TRUE));
+        glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
     }
     Log::Info("Detected OpenGL version: %i.%i", major, minor);
 
+    if (_benchmark) {
+        // The windows are still rendered to while hidden and vsync is disabled so that
+        // the measured frame times reflect the work of the whole frame
+        Settings::instance().setSwapInterval(0);
+        const Node& node = ClusterManager::instance().thisNode();
+        for (const std::unique_ptr<Window>& w : node.windows()) {
+            w->setVisible(false);
+            w->setRenderWhileHidden(true);
+        }
+
+        if (_benchmark->nFrames) {
+            Log::Info("Running benchmark for %d frames", *_benchmark->nFrames);
+        }
+        if (_benchmark->duration) {
+            Log::Info("Running benchmark for %.2f seconds", *_benchmark->duration);
+        }
+    }
+
+    const Settings::DynamicResolution& dr = Settings::instance().dynamicResolution();
+    if (dr.isEnabled) {
+        _dynamicResolution.emplace(dr);
+        _resolutionScale = _dynamicResolution->scale();
+        Log::Info(
+            "Dynamic resolution targeting %.1f Hz with a scale between %.2f and %.2f",
+            dr.targetFrameRate, dr.minScale, dr.maxScale
+        );
+    }
+
     initWindows(major, minor);
 
     // Window resolution may have been set by the config. However, it only sets a pending
     // resolution, so it needs to apply it using the same routine as in the end of a frame
     const Node& thisNode = ClusterManager::instance().thisNode();
     const std::vector<std::unique_ptr<Window>>& wins = thisNode.windows();
+    for (const std::unique_ptr<Window>& window : wins) {
+        window->setResolutionScale(_resolutionScale);
+    }
     std::for_each(wins.begin(), wins.end(), std::mem_fn(&Window::updateResolutions));
 
     // if a single node, skip syncing
@@ -612,6 +893,15 @@ void Engine::initialize() {
         _overlay.bind();
         glUniform1i(glGetUniformLocation(_overlay.id(), "tex"), 0);
         ShaderProgram::unbind();
+
+        _warpMap = ShaderProgram("WarpMapShader");
+        _warpMap.addShaderSource(shaders::BaseVert, shaders::WarpMapFrag);
+        _warpMap.createAndLinkProgram();
+        _warpMap.bind();
+        glUniform1i(glGetUniformLocation(_warpMap.id(), "tex"), 0);
+        glUniform1i(glGetUniformLocation(_warpMap.id(), "warpMap"), 1);
+        glUniform1i(glGetUniformLocation(_warpMap.id(), "warpColor"), 2);
+        ShaderProgram::unbind();
     }
 
     if (_initOpenGLFn) {
@@ -629,6 +919,14 @@ void Engine::initialize() {
 
     updateFrustums();
 
+    // Reading the correction meshes and masks does not need an OpenGL context, so it
+    // happens on worker threads while the rest of the windows are initialized. Only the
+    // upload is left for initContextSpecificOGL
+    std::future<void> viewportData = std::async(
+        std::launch::async,
+        [reads = prepareRead(allViewports(wins))]() { readViewportData(reads); }
+    );
+
 #ifdef SGCT_HAS_TEXT
 #ifdef WIN32
     constexpr const char* FontName = "verdanab.ttf";
@@ -651,7 +949,24 @@ void Engine::initialize() {
     Window::setBarrier(true);
     Window::resetSwapGroupFrameNumber();
 
+    viewportData.get();
+    const double uploadStart = getTime();
     std::for_each(wins.begin(), wins.end(), std::mem_fn(&Window::initContextSpecificOGL));
+    Log::Info(
+        "Uploaded correction data in %.1f ms", (getTime() - uploadStart) * 1000.0
+    );
+
+    if (_watchCorrectionFiles) {
+        std::vector<std::string> files;
+        for (Viewport* vp : allViewports(wins)) {
+            std::vector<std::string> f = vp->dataFiles();
+            files.insert(files.end(), f.begin(), f.end());
+        }
+        _correctionReload.watcher = std::make_unique<FileWatcher>(files);
+        Log::Info(
+            "Watching %d correction files for changes", static_cast<int>(files.size())
+        );
+    }
 
     // start sampling tracking data
     if (isMaster()) {
@@ -661,6 +976,7 @@ void Engine::initialize() {
 
 Engine::~Engine() {
     Log::Info("Cleaning up");
+    Log::Debug("%s", memory::report().c_str());
 
     // First check whether we ever created a node for ourselves.  This might have failed
     // if the configuration was illformed
@@ -695,6 +1011,12 @@ Engine::~Engine() {
         Log::Debug("Done");
     }
 
+    // The correction data that is read in the background belongs to the windows
+    if (_correctionReload.task.valid()) {
+        Log::Debug("Waiting for correction data to be read");
+        _correctionReload.task.wait();
+    }
+
     // de-init window and unbind swapgroups
     // There might not be any thisNode as its creation might have failed
     if (hasNode) {
@@ -702,6 +1024,10 @@ Engine::~Engine() {
         std::for_each(windows.begin(), windows.end(), std::mem_fn(&Window::close));
     }
 
+    // The windows have handed their last captured frames to the capture service
+    Log::Debug("Waiting for capture threads to finish");
+    CaptureService::destroy();
+
     // close TCP connections
     Log::Debug("Destroying network manager");
     NetworkManager::destroy();
@@ -720,6 +1046,7 @@ Engine::~Engine() {
             _fxaa->shader.deleteProgram();
         }
         _overlay.deleteProgram();
+        _warpMap.deleteProgram();
     }
 
     _statisticsRenderer = nullptr;
@@ -920,6 +1247,17 @@ void Engine::render() {
     while (!(_shouldTerminate || thisNode.closeAllWindows() ||
            !NetworkManager::instance().isRunning()))
     {
+        // Durations of the individual stages that are recorded in benchmark mode
+        Benchmark::Frame frame;
+        const double frameStart = glfwGetTime();
+        const uint64_t allocationsStart = memory::totalAllocations();
+        double stageStart = frameStart;
+        auto endStage = [&stageStart](double& duration) {
+            const double now = glfwGetTime();
+            duration += now - stageStart;
+            stageStart = now;
+        };
+
         if (isMaster()) {
             TrackingManager::instance().updateTrackingDevices();
         }
@@ -934,7 +1272,16 @@ void Engine::render() {
             _preSyncFn();
         }
 
+        updateCorrectionReload();
+
+        const bool wasRecording = _capture.isRecording;
         if (NetworkManager::instance().isComputerServer()) {
+            // Captures that are requested after this point are taken in the next frame,
+            // as the clients are only told about them with the next synchronization
+            _capture.frameNumber = _frameCounter;
+            _capture.shotNumber = _shotCounter;
+            _capture.takeScreenshot = std::exchange(_takeScreenshot, false);
+            _capture.isRecording = _isRecording;
             SharedData::instance().encode();
         }
         else if (!NetworkManager::instance().isRunning()) {
@@ -942,9 +1289,38 @@ void Engine::render() {
             Log::Error("Network disconnected. Exiting");
             break;
         }
+        endStage(frame.preSync);
 
         frameLockPreStage();
-        std::for_each(windows.begin(), windows.end(), std::mem_fn(&Window::update));
+        endStage(frame.sync);
+
+        if (!NetworkManager::instance().isComputerServer()) {
+            // Every received request is only executed once, even if the same data is
+            // used for multiple frames because synchronization is disabled. Screenshots
+            // are numbered by the master, so local requests on a client are ignored
+            std::unique_lock lk(mutex::DataSync);
+            _takeScreenshot = false;
+            _capture = _receivedCapture;
+            _receivedCapture.takeScreenshot = false;
+            _shotCounter = _capture.shotNumber;
+            _isRecording = _capture.isRecording;
+            if (_receivedCorrection.generation != _correction.generation) {
+                _correction = _receivedCorrection;
+            }
+        }
+
+        if (_dynamicResolution) {
+            // The scale is applied by all nodes at the end of the frame it was received
+            for (const std::unique_ptr<Window>& window : windows) {
+                window->setResolutionScale(_resolutionScale);
+            }
+        }
+
+        bool hasWindowChanged = false;
+        for (const std::unique_ptr<Window>& window : windows) {
+            hasWindowChanged |= window->update();
+        }
+        hasWindowChanged |= applyCorrectionReload();
         Window::makeSharedContextCurrent();
 
         if (_postSyncPreDrawFn) {
@@ -959,10 +1335,14 @@ void Engine::render() {
             addValue(_statistics.frametimes, ft);
             _statsPrevTimestamp = startFrameTime;
 
-            if (_statisticsRenderer) {
+            if (_statisticsRenderer || _benchmark || _dynamicResolution) {
                 glQueryCounter(timeQueryBegin, GL_TIMESTAMP);
             }
         }
+        // Has to be decided after the PostSyncPreDraw callback as the application might
+        // mark the scene as changed in there
+        const bool shouldRender = isRenderingRequired(hasWindowChanged);
+        endStage(frame.preDraw);
 
         // Render Viewports / Draw
         for (const std::unique_ptr<Window>& win : windows) {
@@ -971,6 +1351,10 @@ void Engine::render() {
             if (!(win->isVisible() || win->isRenderingWhileHidden())) {
                 continue;
             }
+            if (!shouldRender) {
+                // The framebuffers still contain the rendering of the last changed frame
+                continue;
+            }
 
             Window::StereoMode sm = win->stereoMode();
 
@@ -1044,15 +1428,19 @@ void Engine::render() {
             }
         }
 
-        // Render to screen
+        endStage(frame.draw);
+
+        // Render to screen. In benchmark mode the hidden windows are composited as well
+        // as that pass is part of the cost of a frame
         for (const std::unique_ptr<Window>& window : windows) {
-            if (window->isVisible()) {
+            if (window->isVisible() || _benchmark) {
                 renderFBOTexture(*window);
             }
         }
         Window::makeSharedContextCurrent();
+        endStage(frame.composite);
 
-        if (_statisticsRenderer) {
+        if (_statisticsRenderer || _benchmark || _dynamicResolution) {
             ZoneScopedN("glQueryCounter")
             glQueryCounter(timeQueryEnd, GL_TIMESTAMP);
         }
@@ -1062,7 +1450,7 @@ void Engine::render() {
             _postDrawFn();
         }
 
-        if (_statisticsRenderer) {
+        if (_statisticsRenderer || _benchmark || _dynamicResolution) {
             ZoneScopedN("Statistics Update")
             // wait until the query results are available
             GLint done = GL_FALSE;
@@ -1078,15 +1466,28 @@ void Engine::render() {
 
             const double t = static_cast<double>(timerEnd - timerStart) / 1000000000.0;
             addValue(_statistics.drawTimes, t);
+            frame.gpuDraw = t;
 
-            _statisticsRenderer->update();
+            if (_statisticsRenderer) {
+                _statisticsRenderer->update();
+            }
         }
+        endStage(frame.postDraw);
 
         // master will wait for nodes render before swapping
         frameLockPostStage();
+        endStage(frame.sync);
+
         // Swap front and back rendering buffers
+        const bool isCapturing = _capture.takeScreenshot || _capture.isRecording;
         for (const std::unique_ptr<Window>& window : windows) {
-            window->swap(_takeScreenshot);
+            window->swap(isCapturing);
+        }
+        if (wasRecording && !_capture.isRecording) {
+            std::for_each(
+                windows.begin(), windows.end(),
+                std::mem_fn(&Window::finishRecording)
+            );
         }
 
         TracyGpuCollect;
@@ -1096,18 +1497,297 @@ void Engine::render() {
             windows.begin(), windows.end(),
             std::mem_fn(&Window::updateResolutions)
         );
+        endStage(frame.swap);
+
+        if (_dynamicResolution) {
+            // Time spent waiting for the other nodes or for the swap does not get shorter
+            // by rendering fewer pixels, so only the work of this node is considered
+            const double busy = (stageStart - frameStart) - frame.sync - frame.swap;
+            const float frameTime = static_cast<float>(std::max(busy, frame.gpuDraw));
+            NetworkManager& nm = NetworkManager::instance();
+            nm.setFrameTime(frameTime);
+
+            if (isMaster()) {
+                const float slowest = std::max(frameTime, nm.maxClientFrameTime());
+                if (_dynamicResolution->addFrameTime(slowest)) {
+                    _resolutionScale = _dynamicResolution->scale();
+                }
+            }
+        }
+
+        // The first frame is not recorded as it contains one-time initializations
+        if (_benchmark && _frameCounter > 0) {
+            frame.total = stageStart - frameStart;
+            frame.allocations = memory::totalAllocations() - allocationsStart;
+            if (_benchmark->frames.empty()) {
+                _benchmark->startTime = frameStart;
+            }
+            _benchmark->frames.push_back(frame);
+
+            const int nFrames = static_cast<int>(_benchmark->frames.size());
+            const bool reachedFrames =
+                _benchmark->nFrames && nFrames >= *_benchmark->nFrames;
+            const bool reachedDuration = _benchmark->duration &&
+                stageStart - _benchmark->startTime >= *_benchmark->duration;
+            if (reachedFrames || reachedDuration) {
+                _shouldTerminate = true;
+            }
+        }
 
         // for all windows
         _frameCounter++;
-        if (_takeScreenshot) {
+        if (isCapturing) {
             _shotCounter++;
         }
-        _takeScreenshot = false;
     }
 
     Window::makeSharedContextCurrent();
     glDeleteQueries(1, &timeQueryBegin);
     glDeleteQueries(1, &timeQueryEnd);
+
+    if (_benchmark) {
+        printBenchmarkReport();
+    }
+}
+
+bool Engine::isRenderingRequired(bool hasWindowChanged) {
+    if (!_skipUnchangedFrames) {
+        return true;
+    }
+
+    const uint64_t hash = sceneStateHash();
+    // The statistics graph is drawn into the framebuffers and changes every frame
+    const bool isChanged = _isSceneChanged || hasWindowChanged || _statisticsRenderer ||
+        hash != _sceneStateHash;
+    _sceneStateHash = hash;
+    _isSceneChanged = false;
+    return isChanged;
+}
+
+void Engine::updateCorrectionReload() {
+    ZoneScoped
+
+    CorrectionReload& reload = _correctionReload;
+    if (!reload.watcher) {
+        return;
+    }
+
+    const std::vector<std::string> files = reload.watcher->changedFiles();
+    if (!files.empty()) {
+        Node& thisNode = ClusterManager::instance().thisNode();
+        for (Viewport* vp : allViewports(thisNode.windows())) {
+            bool isChanged = false;
+            for (const std::string& file : vp->dataFiles()) {
+                if (contains(files, file)) {
+                    addUnique(reload.changedFiles, file);
+                    isChanged = true;
+                }
+            }
+            if (isChanged) {
+                addUnique(reload.changed, vp);
+            }
+        }
+    }
+
+    // The clients keep their data until the master has read its own, so that all nodes
+    // replace the data in the same frame
+    const bool isRead = finishCorrectionRead(false);
+    if (isRead && isMaster() && !reload.stagedFiles.empty()) {
+        // A generation that was started in this frame but not sent yet is extended, and
+        // one that reloads all viewports already contains the files
+        const bool isPending = _correction.generation != _appliedCorrectionGeneration;
+        if (!isPending) {
+            _correction.generation++;
+        }
+        if (!isPending || !_correction.files.empty()) {
+            _correction.files = reload.stagedFiles;
+        }
+    }
+
+    // Only one set of viewports is read at a time, as the data of a viewport must not be
+    // read by two threads at once
+    if (!reload.task.valid() && !reload.changed.empty()) {
+        reload.reading = std::move(reload.changed);
+        reload.readingFiles = std::move(reload.changedFiles);
+        reload.changed.clear();
+        reload.changedFiles.clear();
+        reload.task = std::async(
+            std::launch::async,
+            [reads = prepareRead(reload.reading)]() { readViewportData(reads); }
+        );
+    }
+}
+
+bool Engine::finishCorrectionRead(bool wait) {
+    CorrectionReload& reload = _correctionReload;
+    if (!reload.task.valid()) {
+        return false;
+    }
+    if (!wait &&
+        reload.task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return false;
+    }
+
+    try {
+        reload.task.get();
+        for (Viewport* vp : reload.reading) {
+            addUnique(reload.staged, vp);
+        }
+        for (const std::string& file : reload.readingFiles) {
+            addUnique(reload.stagedFiles, file);
+        }
+    }
+    catch (const std::runtime_error& e) {
+        // The file is most likely read while it is being written, so the data is read
+        // again once the writing has finished
+        Log::Error("Could not read changed correction data: %s", e.what());
+    }
+    reload.reading.clear();
+    reload.readingFiles.clear();
+    return true;
+}
+
+bool Engine::applyCorrectionReload() {
+    ZoneScoped
+
+    if (_correction.generation == _appliedCorrectionGeneration) {
+        return false;
+    }
+    _appliedCorrectionGeneration = _correction.generation;
+
+    // Only the viewports that use one of the changed files are replaced. An empty list
+    // is sent by reloadCorrectionData and replaces all viewports
+    const std::vector<std::string>& files = _correction.files;
+    auto isAffected = [&files](const std::string& file) {
+        return files.empty() || contains(files, file);
+    };
+    const std::vector<std::unique_ptr<Window>>& windows =
+        ClusterManager::instance().thisNode().windows();
+    std::vector<Viewport*> viewports;
+    for (Viewport* vp : allViewports(windows)) {
+        const std::vector<std::string> vpFiles = vp->dataFiles();
+        if (files.empty() || std::any_of(vpFiles.cbegin(), vpFiles.cend(), isAffected)) {
+            viewports.push_back(vp);
+        }
+    }
+
+    CorrectionReload& reload = _correctionReload;
+    auto isReload = [&viewports](Viewport* vp) { return contains(viewports, vp); };
+
+    // A viewport must not be uploaded while its data is still read in the background.
+    // Files on a shared drive change for all nodes at once, so such a read has most
+    // likely been started at the same time as the one on the master and is about to end
+    if (std::any_of(reload.reading.cbegin(), reload.reading.cend(), isReload)) {
+        finishCorrectionRead(true);
+    }
+
+    // Viewports whose change was not noticed by this node yet or whose background read
+    // failed are read now
+    std::vector<Viewport*> unread;
+    for (Viewport* vp : viewports) {
+        if (!contains(reload.staged, vp)) {
+            unread.push_back(vp);
+        }
+    }
+    if (!unread.empty()) {
+        try {
+            readViewportData(prepareRead(unread));
+        }
+        catch (const std::runtime_error& e) {
+            Log::Error("Could not reload correction data: %s", e.what());
+            return false;
+        }
+    }
+
+    // The data that is uploaded now contains all changes of these viewports and files
+    // that have been noticed so far
+    auto removeIf = [](auto& v, auto pred) {
+        v.erase(std::remove_if(v.begin(), v.end(), pred), v.end());
+    };
+    removeIf(reload.staged, isReload);
+    removeIf(reload.changed, isReload);
+    removeIf(reload.stagedFiles, isAffected);
+    removeIf(reload.changedFiles, isAffected);
+    if (viewports.empty()) {
+        return false;
+    }
+
+    const double t0 = getTime();
+    for (const std::unique_ptr<Window>& win : windows) {
+        win->reloadViewportData(viewports);
+    }
+    Log::Info(
+        "Reloaded correction data of %d viewports in %.1f ms",
+        static_cast<int>(viewports.size()), (getTime() - t0) * 1000.0
+    );
+    return true;
+}
+
+void Engine::printBenchmarkReport() const {
+    const std::vector<Benchmark::Frame>& frames = _benchmark->frames;
+    if (frames.empty()) {
+        Log::Warning("Benchmark finished before any frame was recorded");
+        return;
+    }
+
+    const double n = static_cast<double>(frames.size());
+    auto average = [&frames, n](double Benchmark::Frame::* member) {
+        double sum = 0.0;
+        for (const Benchmark::Frame& f : frames) {
+            sum += f.*member;
+        }
+        return sum / n;
+    };
+
+    std::vector<double> totals(frames.size());
+    std::transform(
+        frames.cbegin(), frames.cend(),
+        totals.begin(),
+        [](const Benchmark::Frame& f) { return f.total; }
+    );
+    std::sort(totals.begin(), totals.end());
+    auto percentile = [&totals](double p) {
+        const double idx = p * static_cast<double>(totals.size() - 1);
+        return totals[static_cast<size_t>(idx + 0.5)];
+    };
+
+    const double duration = std::accumulate(totals.cbegin(), totals.cend(), 0.0);
+    const double avg = duration / n;
+    double variance = 0.0;
+    for (double t : totals) {
+        variance += (t - avg) * (t - avg);
+    }
+    const double stddev = std::sqrt(variance / n);
+
+    uint64_t allocations = 0;
+    for (const Benchmark::Frame& f : frames) {
+        allocations += f.allocations;
+    }
+
+    constexpr const double ms = 1000.0;
+    const double sync = average(&Benchmark::Frame::sync);
+    Log::Info(
+        "Benchmark results for node %d: %d frames in %.3f s (%.2f fps)\n"
+        "  Frame time (ms): min %.3f, avg %.3f, median %.3f, p95 %.3f, p99 %.3f, "
+        "max %.3f, stddev %.3f\n"
+        "  Stages (avg ms): pre-sync %.3f, sync %.3f, pre-draw %.3f, draw %.3f, "
+        "composite %.3f, post-draw %.3f, swap %.3f\n"
+        "  GPU draw time (avg ms): %.3f\n"
+        "  Sync overhead: %.3f ms (%.1f%% of the frame time)\n"
+        "  SGCT allocations per frame: %.2f",
+        ClusterManager::instance().thisNodeId(), static_cast<int>(frames.size()),
+        duration, n / duration,
+        totals.front() * ms, avg * ms, percentile(0.5) * ms, percentile(0.95) * ms,
+        percentile(0.99) * ms, totals.back() * ms, stddev * ms,
+        average(&Benchmark::Frame::preSync) * ms, sync * ms,
+        average(&Benchmark::Frame::preDraw) * ms, average(&Benchmark::Frame::draw) * ms,
+        average(&Benchmark::Frame::composite) * ms,
+        average(&Benchmark::Frame::postDraw) * ms, average(&Benchmark::Frame::swap) * ms,
+        average(&Benchmark::Frame::gpuDraw) * ms,
+        sync * ms, sync / avg * 100.0,
+        static_cast<double>(allocations) / n
+    );
 }
 
 void Engine::drawOverlays(const Window& window, Frustum::Mode frustum) {
@@ -1163,6 +1843,19 @@ void Engine::renderFBOTexture(Window& window) {
         //std::for_each(vps.begin(), vps.end(), std::mem_fn(&Viewport::renderQuadMesh));
     }
     else {
+        // Viewports with a warp map need their own shader, which is only possible if the
+        // stereo mode does not combine the eyes in a shader
+        auto renderWarp = [this](const std::unique_ptr<Viewport>& vp) {
+            if (vp->hasWarpMap()) {
+                _warpMap.bind();
+                vp->renderWarpMap();
+                _fboQuad.bind();
+            }
+            else {
+                vp->renderWarpMesh();
+            }
+        };
+
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(
             GL_TEXTURE_2D,
@@ -1172,7 +1865,7 @@ void Engine::renderFBOTexture(Window& window) {
         _fboQuad.bind();
         maskShaderSet = true;
 
-        std::for_each(vps.begin(), vps.end(), std::mem_fn(&Viewport::renderWarpMesh));
+        std::for_each(vps.begin(), vps.end(), renderWarp);
         //std::for_each(vps.begin(), vps.end(), std::mem_fn(&Viewport::renderQuadMesh));
 
         // render right eye in active stereo mode
@@ -1190,7 +1883,7 @@ void Engine::renderFBOTexture(Window& window) {
                 GL_TEXTURE_2D,
                 window.frameBufferTexture(Window::TextureIndex::RightEye)
             );
-            std::for_each(vps.begin(), vps.end(), std::mem_fn(&Viewport::renderWarpMesh));
+            std::for_each(vps.begin(), vps.end(), renderWarp);
             //std::for_each(vps.begin(), vps.end(), std::mem_fn(&Viewport::renderQuadMesh));
         }
     }
@@ -1642,6 +2335,7 @@ void Engine::setNearAndFarClippingPlanes(float nearClip, float farClip) {
     _nearClipPlane = nearClip;
     _farClipPlane = farClip;
     updateFrustums();
+    _isSceneChanged = true;
 }
 
 void Engine::setEyeSeparation(float eyeSeparation) {
@@ -1656,6 +2350,7 @@ void Engine::setEyeSeparation(float eyeSeparation) {
 
 void Engine::setClearColor(vec4 color) {
     _clearColor = std::move(color);
+    _isSceneChanged = true;
 }
 
 const Window* Engine::focusedWindow() const {
@@ -1673,13 +2368,43 @@ void Engine::setStatsGraphVisibility(bool state) {
     }
     if (!state && _statisticsRenderer) {
         _statisticsRenderer = nullptr;
+        // Remove the last graph from the framebuffers
+        _isSceneChanged = true;
     }
 }
 
+void Engine::setSkipUnchangedFrames(bool state) {
+    _skipUnchangedFrames = state;
+    _isSceneChanged = true;
+}
+
+void Engine::setSceneChanged() {
+    _isSceneChanged = true;
+}
+
 void Engine::takeScreenshot() {
     _takeScreenshot = true;
 }
 
+void Engine::startRecording() {
+    _isRecording = true;
+}
+
+void Engine::stopRecording() {
+    _isRecording = false;
+}
+
+bool Engine::isRecording() const {
+    return _isRecording;
+}
+
+void Engine::reloadCorrectionData() {
+    if (isMaster()) {
+        _correction.generation++;
+        _correction.files.clear();
+    }
+}
+
 const std::function<void(const RenderData&)>& Engine::drawFunction() const {
     return _drawFn;
 }
@@ -1713,4 +2438,8 @@ unsigned int Engine::screenShotNumber() const {
     return _shotCounter;
 }
 
+unsigned int Engine::clusterFrameNumber() const {
+    return _capture.frameNumber;
+}
+
 } // namespace sgct
@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/filewatcher.h>
+
+#include <sgct/log.h>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace fs = std::filesystem;
+
+namespace sgct {
+
+FileWatcher::FileWatcher(const std::vector<std::string>& files) {
+    for (const std::string& path : files) {
+        std::error_code ec;
+        const fs::path absolute = fs::absolute(path, ec).lexically_normal();
+        File file;
+        file.path = path;
+        file.folder = absolute.parent_path();
+        file.name = absolute.filename();
+        file.time = fs::last_write_time(absolute, ec);
+        file.size = fs::file_size(absolute, ec);
+        _files.push_back(std::move(file));
+    }
+
+#ifdef __linux__
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotify == -1) {
+        Log::Warning("Could not watch files for changes");
+        return;
+    }
+
+    // Many tools write a temporary file and move it onto the old one, which is only seen
+    // when watching the folder instead of the file itself
+    for (const File& file : _files) {
+        const bool isWatched = std::any_of(
+            _folders.cbegin(),
+            _folders.cend(),
+            [&file](const std::pair<int, fs::path>& f) { return f.second == file.folder; }
+        );
+        if (isWatched) {
+            continue;
+        }
+
+        const int wd = inotify_add_watch(
+            _inotify,
+            file.folder.c_str(),
+            IN_CLOSE_WRITE | IN_MOVED_TO
+        );
+        if (wd == -1) {
+            Log::Warning("Could not watch folder '%s'", file.folder.c_str());
+            continue;
+        }
+        _folders.emplace_back(wd, file.folder);
+    }
+#else // __linux__
+    _lastCheck = std::chrono::steady_clock::now();
+#endif // __linux__
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (_inotify != -1) {
+        close(_inotify);
+    }
+#endif // __linux__
+}
+
+std::vector<std::string> FileWatcher::changedFiles() {
+    std::vector<std::string> res;
+    auto addChanged = [&res](const File& file) {
+        if (std::find(res.cbegin(), res.cend(), file.path) == res.cend()) {
+            res.push_back(file.path);
+        }
+    };
+
+#ifdef __linux__
+    if (_inotify == -1) {
+        return res;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length = 0;
+    while ((length = read(_inotify, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t i = 0; i < length;) {
+            const inotify_event* event = reinterpret_cast<inotify_event*>(buffer + i);
+            i += sizeof(inotify_event) + event->len;
+            if (event->len == 0) {
+                continue;
+            }
+
+            const auto folder = std::find_if(
+                _folders.cbegin(),
+                _folders.cend(),
+                [event](const std::pair<int, fs::path>& f) {
+                    return f.first == event->wd;
+                }
+            );
+            if (folder == _folders.cend()) {
+                continue;
+            }
+            const fs::path name = event->name;
+            for (const File& file : _files) {
+                if (file.folder == folder->second && file.name == name) {
+                    addChanged(file);
+                }
+            }
+        }
+    }
+#else // __linux__
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - _lastCheck < std::chrono::seconds(1)) {
+        return res;
+    }
+    _lastCheck = now;
+
+    for (File& file : _files) {
+        std::error_code ec;
+        const fs::path path = file.folder / file.name;
+        const fs::file_time_type time = fs::last_write_time(path, ec);
+        if (ec) {
+            // The file might be replaced right now, so it is checked again next time
+            continue;
+        }
+        const uintmax_t size = fs::file_size(path, ec);
+        if (!ec && (time != file.time || size != file.size)) {
+            file.time = time;
+            file.size = size;
+            addChanged(file);
+        }
+    }
+#endif // __linux__
+
+    return res;
+}
+
+} // namespace sgct
@@ -11,6 +11,7 @@
 #include <sgct/font.h>
 
 #include <sgct/log.h>
+#include <sgct/memory.h>
 #include <sgct/opengl.h>
 #include <freetype/ftstroke.h>
 #include <array>
@@ -135,6 +136,11 @@ namespace {
             GL_UNSIGNED_BYTE,
             buffer.data()
         );
+        sgct::memory::trackTexture(
+            sgct::memory::Subsystem::Font,
+            tex,
+            sgct::memory::estimateImageBytes(GL_COMPRESSED_RG, w, h)
+        );
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
@@ -236,6 +242,7 @@ Font::~Font() {
     glDeleteVertexArrays(1, &_vao);
     glDeleteBuffers(1, &_vbo);
     for (const std::pair<const char, FontFaceData>& n : _fontFaceData) {
+        memory::untrackTexture(n.second.texId);
         glDeleteTextures(1, &(n.second.texId));
         FT_Done_Glyph(n.second.glyph);
     }
@@ -11,12 +11,16 @@
 #include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/log.h>
+#include <sgct/memory.h>
+#include <sgct/pixelkernels.h>
+#include <sgct/profiling.h>
+#include <algorithm>
 #include <chrono>
+#include <future>
 #include <png.h>
-#include <pngpriv.h>
-
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include <stb_image_write.h>
+#include <thread>
+#include <vector>
+#include <zlib.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -26,7 +30,7 @@
 #pragma warning(disable : 4611)
 #endif // WIN32
 
-#define Err(code, msg) Error(Error::Component::Image, code, msg)
+#define Err(code, msg) sgct::Error(sgct::Error::Component::Image, code, msg)
 
 namespace {
     sgct::Image::FormatType getFormatType(std::string filename) {
@@ -51,11 +55,621 @@ namespace {
         }
         return sgct::Image::FormatType::Unknown;
     }
+
+    using PngFilter = sgct::Settings::PngFilter;
+
+    // Stripes with fewer rows than this are not worth the overhead of an extra thread
+    constexpr const int MinRowsPerPngStripe = 64;
+
+    /// A horizontal stripe of a PNG file that is filtered and compressed independently
+    struct PngStripe {
+        /// Raw deflate data that ends on a byte boundary
+        std::vector<unsigned char> compressed;
+        size_t nCompressed = 0;
+        /// Adler-32 checksum of the uncompressed, filtered rows of this stripe
+        uLong adler = 1;
+        size_t nUncompressed = 0;
+    };
+
+    unsigned char paethPredictor(int a, int b, int c) {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) {
+            return static_cast<unsigned char>(a);
+        }
+        return static_cast<unsigned char>(pb <= pc ? b : c);
+    }
+
+    // Writes the filter type byte followed by the filtered row into dst
+    void filterRow(PngFilter filter, const unsigned char* row, const unsigned char* prev,
+                   size_t rowBytes, int bpp, unsigned char* dst)
+    {
+        unsigned char* out = dst + 1;
+        switch (filter) {
+            case PngFilter::None:
+                dst[0] = 0;
+                std::copy(row, row + rowBytes, out);
+                break;
+            case PngFilter::Sub:
+                dst[0] = 1;
+                for (size_t i = 0; i < rowBytes; ++i) {
+                    const int left = i >= size_t(bpp) ? row[i - bpp] : 0;
+                    out[i] = static_cast<unsigned char>(row[i] - left);
+                }
+                break;
+            case PngFilter::Up:
+                dst[0] = 2;
+                for (size_t i = 0; i < rowBytes; ++i) {
+                    out[i] = static_cast<unsigned char>(row[i] - prev[i]);
+                }
+                break;
+            case PngFilter::Average:
+                dst[0] = 3;
+                for (size_t i = 0; i < rowBytes; ++i) {
+                    const int left = i >= size_t(bpp) ? row[i - bpp] : 0;
+                    out[i] = static_cast<unsigned char>(row[i] - ((left + prev[i]) >> 1));
+                }
+                break;
+            case PngFilter::Paeth:
+                dst[0] = 4;
+                for (size_t i = 0; i < rowBytes; ++i) {
+                    const int left = i >= size_t(bpp) ? row[i - bpp] : 0;
+                    const int upLeft = i >= size_t(bpp) ? prev[i - bpp] : 0;
+                    const unsigned char p = paethPredictor(left, prev[i], upLeft);
+                    out[i] = static_cast<unsigned char>(row[i] - p);
+                }
+                break;
+            default: throw std::logic_error("Unhandled case label");
+        }
+    }
+
+    // Picks the filter with the smallest sum of absolute differences, which is the
+    // heuristic that is recommended by the PNG specification
+    void filterRowAdaptive(const unsigned char* row, const unsigned char* prev,
+                           size_t rowBytes, int bpp, unsigned char* dst,
+                           std::vector<unsigned char>& scratch)
+    {
+        uint64_t bestSum = std::numeric_limits<uint64_t>::max();
+        for (PngFilter f : { PngFilter::None, PngFilter::Sub, PngFilter::Up,
+                             PngFilter::Average, PngFilter::Paeth })
+        {
+            filterRow(f, row, prev, rowBytes, bpp, scratch.data());
+            uint64_t sum = 0;
+            for (size_t i = 1; i <= rowBytes; ++i) {
+                sum += std::abs(static_cast<signed char>(scratch[i]));
+            }
+            if (sum < bestSum) {
+                bestSum = sum;
+                std::swap_ranges(scratch.begin(), scratch.end(), dst);
+            }
+        }
+    }
+
+    void deflateStripe(z_stream& stream, PngStripe& stripe, unsigned char* data,
+                       size_t size, int flush)
+    {
+        stream.next_in = data;
+        stream.avail_in = static_cast<uInt>(size);
+        do {
+            if (stripe.compressed.size() - stripe.nCompressed < 64 * 1024) {
+                stripe.compressed.resize(stripe.compressed.size() * 2 + 64 * 1024);
+            }
+            const size_t available = stripe.compressed.size() - stripe.nCompressed;
+            stream.next_out = stripe.compressed.data() + stripe.nCompressed;
+            stream.avail_out = static_cast<uInt>(available);
+            if (deflate(&stream, flush) == Z_STREAM_ERROR) {
+                throw Err(9013, "Failed to compress PNG data");
+            }
+            stripe.nCompressed += available - stream.avail_out;
+        } while (stream.avail_out == 0);
+    }
+
+    /**
+     * Filters and compresses the rows [firstRow, lastRow) of the image, where row 0 is
+     * the top row of the PNG file. The compressed data does not depend on any other
+     * stripe, so all stripes can be encoded at the same time and concatenated. All
+     * stripes except the last end with a sync flush and the last one finishes the stream.
+     */
+    PngStripe encodePngStripe(const sgct::Image& image, int firstRow, int lastRow,
+                              bool isLast, int level, PngFilter filter)
+    {
+        ZoneScoped
+
+        const int width = image.size().x;
+        const int height = image.size().y;
+        const int bpp = image.channels() * image.bytesPerChannel();
+        const size_t rowBytes = static_cast<size_t>(width) * bpp;
+
+        // The image data is stored bottom-up, but PNG rows are top-down
+        auto sourceRow = [&](int row) {
+            return image.data() + static_cast<size_t>(height - 1 - row) * rowBytes;
+        };
+
+        std::vector<unsigned char> prev(rowBytes, 0);
+        std::vector<unsigned char> curr(rowBytes);
+        std::vector<unsigned char> filtered(rowBytes + 1);
+        std::vector<unsigned char> scratch;
+        if (filter == PngFilter::Adaptive) {
+            scratch.resize(rowBytes + 1);
+        }
+        // PNG stores RGB(A) instead of BGR(A) and 16-bit values as big-endian
+        auto convertRow = [&](int row, unsigned char* dst) {
+            const int bpc = image.bytesPerChannel();
+            sgct::pixelkernels::swapRedBlue(
+                sourceRow(row), dst, width, image.channels(), bpc, bpc == 2
+            );
+        };
+        if (firstRow > 0) {
+            convertRow(firstRow - 1, prev.data());
+        }
+
+        z_stream stream = {};
+        const int strategy = filter == PngFilter::None ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+        // Negative window bits produce raw deflate data without zlib header and checksum
+        if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, strategy) != Z_OK) {
+            throw Err(9013, "Failed to compress PNG data");
+        }
+
+        PngStripe stripe;
+        const size_t nBytes = (rowBytes + 1) * (lastRow - firstRow);
+        stripe.compressed.resize(deflateBound(&stream, static_cast<uLong>(nBytes)) + 16);
+        for (int row = firstRow; row < lastRow; ++row) {
+            convertRow(row, curr.data());
+            if (filter == PngFilter::Adaptive) {
+                filterRowAdaptive(
+                    curr.data(), prev.data(), rowBytes, bpp, filtered.data(), scratch
+                );
+            }
+            else {
+                filterRow(
+                    filter, curr.data(), prev.data(), rowBytes, bpp, filtered.data()
+                );
+            }
+
+            stripe.adler = adler32(
+                stripe.adler,
+                filtered.data(),
+                static_cast<uInt>(filtered.size())
+            );
+            stripe.nUncompressed += filtered.size();
+
+            const bool isLastRow = row == lastRow - 1;
+            const int flush = isLastRow ? (isLast ? Z_FINISH : Z_SYNC_FLUSH) : Z_NO_FLUSH;
+            try {
+                deflateStripe(stream, stripe, filtered.data(), filtered.size(), flush);
+            }
+            catch (...) {
+                deflateEnd(&stream);
+                throw;
+            }
+            std::swap(prev, curr);
+        }
+        deflateEnd(&stream);
+        return stripe;
+    }
+
+    void writeBigEndian(unsigned char* dst, uint32_t value) {
+        dst[0] = static_cast<unsigned char>(value >> 24);
+        dst[1] = static_cast<unsigned char>(value >> 16);
+        dst[2] = static_cast<unsigned char>(value >> 8);
+        dst[3] = static_cast<unsigned char>(value);
+    }
+
+    bool writePngChunk(FILE* fp, const char* type, const unsigned char* data, size_t size)
+    {
+        unsigned char header[8];
+        writeBigEndian(header, static_cast<uint32_t>(size));
+        std::copy(type, type + 4, header + 4);
+
+        uLong crc = crc32(0, header + 4, 4);
+        if (size > 0) {
+            crc = crc32(crc, data, static_cast<uInt>(size));
+        }
+        unsigned char footer[4];
+        writeBigEndian(footer, static_cast<uint32_t>(crc));
+
+        return fwrite(header, 1, 8, fp) == 8 &&
+            (size == 0 || fwrite(data, 1, size, fp) == size) &&
+            fwrite(footer, 1, 4, fp) == 4;
+    }
+
+    /// Returns 8-bit pixels of the image; 16-bit values are converted into \p buffer
+    const unsigned char* pixels8Bit(const sgct::Image& image,
+                                    std::vector<unsigned char>& buffer)
+    {
+        if (image.bytesPerChannel() == 1) {
+            return image.data();
+        }
+        const sgct::ivec2 size = image.size();
+        buffer.resize(static_cast<size_t>(size.x) * size.y * image.channels());
+        sgct::pixelkernels::uint16ToUInt8(image.data(), buffer.data(), buffer.size());
+        return buffer.data();
+    }
+
+    using JpegSubsampling = sgct::Settings::JpegSubsampling;
+
+    // Stripes with fewer rows than this are not worth the overhead of an extra thread
+    constexpr const int MinRowsPerJpegStripe = 64;
+
+    // The position of every coefficient of an 8x8 block in the zigzag order of the file
+    constexpr const unsigned char JpegZigzag[64] = {
+         0,  1,  5,  6, 14, 15, 27, 28,  2,  4,  7, 13, 16, 26, 29, 42,
+         3,  8, 12, 17, 25, 30, 41, 43,  9, 11, 18, 24, 31, 40, 44, 53,
+        10, 19, 23, 32, 39, 45, 52, 54, 20, 22, 33, 38, 46, 51, 55, 60,
+        21, 34, 37, 47, 50, 56, 59, 61, 35, 36, 48, 49, 57, 58, 62, 63
+    };
+
+    // The example tables from Annex K of the JPEG specification, which are used by
+    // virtually every encoder. The quantization tables correspond to a quality of 50
+    constexpr const unsigned char JpegLumaQuantization[64] = {
+        16, 11, 10, 16,  24,  40,  51,  61, 12, 12, 14, 19,  26,  58,  60,  55,
+        14, 13, 16, 24,  40,  57,  69,  56, 14, 17, 22, 29,  51,  87,  80,  62,
+        18, 22, 37, 56,  68, 109, 103,  77, 24, 35, 55, 64,  81, 104, 113,  92,
+        49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103,  99
+    };
+    constexpr const unsigned char JpegChromaQuantization[64] = {
+        17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+        24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99
+    };
+
+    // Number of Huffman codes of each length from 1 to 16, followed by the symbols
+    constexpr const unsigned char JpegLumaDC[] = {
+        0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11
+    };
+    constexpr const unsigned char JpegChromaDC[] = {
+        0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11
+    };
+    constexpr const unsigned char JpegLumaAC[] = {
+        0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d,
+        0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13,
+        0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42,
+        0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a,
+        0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35,
+        0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a,
+        0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67,
+        0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84,
+        0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98,
+        0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3,
+        0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+        0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1,
+        0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4,
+        0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa
+    };
+    constexpr const unsigned char JpegChromaAC[] = {
+        0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77,
+        0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51,
+        0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1,
+        0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24,
+        0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a,
+        0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+        0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66,
+        0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82,
+        0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96,
+        0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa,
+        0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+        0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9,
+        0xda, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4,
+        0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa
+    };
+
+    struct JpegHuffmanTable {
+        uint16_t code[256] = {};
+        uint8_t length[256] = {};
+    };
+
+    /// Derives the codes from a table in the format of the DHT segment (Annex C)
+    JpegHuffmanTable buildHuffmanTable(const unsigned char* spec) {
+        JpegHuffmanTable table;
+        const unsigned char* symbol = spec + 16;
+        uint16_t code = 0;
+        for (int length = 1; length <= 16; ++length) {
+            for (int i = 0; i < spec[length - 1]; ++i) {
+                table.code[*symbol] = code;
+                table.length[*symbol] = static_cast<uint8_t>(length);
+                code++;
+                symbol++;
+            }
+            code <<= 1;
+        }
+        return table;
+    }
+
+    /// Everything that the stripes of one image share
+    struct JpegTables {
+        /// The quantization tables in zigzag order, as they are written to the file
+        unsigned char luma[64];
+        unsigned char chroma[64];
+        /// The reciprocals of the quantization tables with the scale factors of the DCT
+        float lumaScale[64];
+        float chromaScale[64];
+        JpegHuffmanTable lumaDC;
+        JpegHuffmanTable lumaAC;
+        JpegHuffmanTable chromaDC;
+        JpegHuffmanTable chromaAC;
+    };
+
+    JpegTables createJpegTables(int quality) {
+        // The scaling of the quantization tables that is used by the IJG library, so
+        // that a quality setting results in the same tables as in most other encoders
+        const int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+        // Scale factors of the AAN DCT that are folded into the quantization
+        constexpr const float Aan[8] = {
+            1.f, 1.387039845f, 1.306562965f, 1.175875602f,
+            1.f, 0.785694958f, 0.541196100f, 0.275899379f
+        };
+
+        JpegTables tables;
+        for (int i = 0; i < 64; ++i) {
+            const int luma = (JpegLumaQuantization[i] * scale + 50) / 100;
+            const int chroma = (JpegChromaQuantization[i] * scale + 50) / 100;
+            tables.luma[JpegZigzag[i]] =
+                static_cast<unsigned char>(std::clamp(luma, 1, 255));
+            tables.chroma[JpegZigzag[i]] =
+                static_cast<unsigned char>(std::clamp(chroma, 1, 255));
+        }
+        for (int i = 0; i < 64; ++i) {
+            const float aan = Aan[i / 8] * Aan[i % 8] * 8.f;
+            tables.lumaScale[i] = 1.f / (tables.luma[JpegZigzag[i]] * aan);
+            tables.chromaScale[i] = 1.f / (tables.chroma[JpegZigzag[i]] * aan);
+        }
+        tables.lumaDC = buildHuffmanTable(JpegLumaDC);
+        tables.lumaAC = buildHuffmanTable(JpegLumaAC);
+        tables.chromaDC = buildHuffmanTable(JpegChromaDC);
+        tables.chromaAC = buildHuffmanTable(JpegChromaAC);
+        return tables;
+    }
+
+    /// Writes the entropy-coded data of a JPEG file, which escapes every 0xFF byte
+    class JpegBitWriter {
+    public:
+        explicit JpegBitWriter(std::vector<unsigned char>& out) : _out(out) {}
+
+        void write(uint32_t bits, int nBits) {
+            _buffer = (_buffer << nBits) | (bits & ((1u << nBits) - 1));
+            _nBits += nBits;
+            while (_nBits >= 8) {
+                _nBits -= 8;
+                const unsigned char c = static_cast<unsigned char>(_buffer >> _nBits);
+                _out.push_back(c);
+                if (c == 0xff) {
+                    _out.push_back(0);
+                }
+            }
+        }
+
+        void write(const JpegHuffmanTable& table, int symbol) {
+            write(table.code[symbol], table.length[symbol]);
+        }
+
+        /// Pads the last byte with 1-bits, as required before a marker
+        void flush() {
+            if (_nBits > 0) {
+                write(0x7f, 8 - _nBits);
+            }
+        }
+
+    private:
+        std::vector<unsigned char>& _out;
+        uint32_t _buffer = 0;
+        int _nBits = 0;
+    };
+
+    /// One dimensional AAN DCT of the 8 values that are \p stride values apart
+    void dct8(float* d, int stride) {
+        float* p[8];
+        for (int i = 0; i < 8; ++i) {
+            p[i] = d + i * stride;
+        }
+
+        const float tmp0 = *p[0] + *p[7];
+        const float tmp7 = *p[0] - *p[7];
+        const float tmp1 = *p[1] + *p[6];
+        const float tmp6 = *p[1] - *p[6];
+        const float tmp2 = *p[2] + *p[5];
+        const float tmp5 = *p[2] - *p[5];
+        const float tmp3 = *p[3] + *p[4];
+        const float tmp4 = *p[3] - *p[4];
+
+        // Even part
+        const float tmp10 = tmp0 + tmp3;
+        const float tmp13 = tmp0 - tmp3;
+        const float tmp11 = tmp1 + tmp2;
+        const float tmp12 = tmp1 - tmp2;
+        *p[0] = tmp10 + tmp11;
+        *p[4] = tmp10 - tmp11;
+        const float z1 = (tmp12 + tmp13) * 0.707106781f;
+        *p[2] = tmp13 + z1;
+        *p[6] = tmp13 - z1;
+
+        // Odd part
+        const float odd10 = tmp4 + tmp5;
+        const float odd11 = tmp5 + tmp6;
+        const float odd12 = tmp6 + tmp7;
+        const float z5 = (odd10 - odd12) * 0.382683433f;
+        const float z2 = odd10 * 0.541196100f + z5;
+        const float z4 = odd12 * 1.306562965f + z5;
+        const float z3 = odd11 * 0.707106781f;
+        const float z11 = tmp7 + z3;
+        const float z13 = tmp7 - z3;
+        *p[5] = z13 + z2;
+        *p[3] = z13 - z2;
+        *p[1] = z11 + z4;
+        *p[7] = z11 - z4;
+    }
+
+    void writeJpegValue(JpegBitWriter& writer, const JpegHuffmanTable& table, int run,
+                        int value)
+    {
+        // Values are stored as their number of bits followed by the bits themselves,
+        // where negative values are stored as their one's complement
+        const int magnitude = std::abs(value);
+        int nBits = 0;
+        while ((magnitude >> nBits) != 0) {
+            nBits++;
+        }
+        writer.write(table, (run << 4) | nBits);
+        if (nBits > 0) {
+            writer.write(static_cast<uint32_t>(value < 0 ? value - 1 : value), nBits);
+        }
+    }
+
+    /// Transforms, quantizes, and writes one 8x8 block and returns its DC coefficient
+    int encodeJpegBlock(JpegBitWriter& writer, float* block, const float* scale,
+                        int previousDC, const JpegHuffmanTable& dc,
+                        const JpegHuffmanTable& ac)
+    {
+        for (int i = 0; i < 8; ++i) {
+            dct8(block + i * 8, 1);
+        }
+        for (int i = 0; i < 8; ++i) {
+            dct8(block + i, 8);
+        }
+
+        int coefficients[64];
+        for (int i = 0; i < 64; ++i) {
+            // Rounding by hand is a lot faster than std::lround in this loop
+            const float v = block[i] * scale[i];
+            coefficients[JpegZigzag[i]] = static_cast<int>(v < 0.f ? v - 0.5f : v + 0.5f);
+        }
+
+        writeJpegValue(writer, dc, 0, coefficients[0] - previousDC);
+
+        int last = 63;
+        while (last > 0 && coefficients[last] == 0) {
+            last--;
+        }
+        int run = 0;
+        for (int i = 1; i <= last; ++i) {
+            if (coefficients[i] == 0) {
+                run++;
+                continue;
+            }
+            while (run >= 16) {
+                // Sixteen zeros
+                writer.write(ac, 0xf0);
+                run -= 16;
+            }
+            writeJpegValue(writer, ac, run, coefficients[i]);
+            run = 0;
+        }
+        if (last < 63) {
+            // End of block
+            writer.write(ac, 0x00);
+        }
+        return coefficients[0];
+    }
+
+    /**
+     * Encodes the MCU rows [firstRow, lastRow) of 8-bit BGR(A) or grayscale pixels that
+     * are stored from bottom to top, where row 0 is the top MCU row of the JPEG file.
+     * Every MCU row is a restart interval, so the rows do not depend on each other and
+     * all stripes can be encoded at the same time and concatenated. Every stripe ends
+     * with a restart marker, except for the one that contains the last row.
+     */
+    std::vector<unsigned char> encodeJpegStripe(const unsigned char* data,
+                                                sgct::ivec2 size, int channels,
+                                                int firstRow, int lastRow, int nRows,
+                                                const JpegTables& tables,
+                                                JpegSubsampling subsampling)
+    {
+        ZoneScoped
+
+        // The chroma is averaged over blocks of h x v pixels
+        const int h = subsampling == JpegSubsampling::Chroma444 ? 1 : 2;
+        const int v = subsampling == JpegSubsampling::Chroma420 ? 2 : 1;
+        const int mcuWidth = 8 * h;
+        const int mcuHeight = 8 * v;
+        const int nColumns = (size.x + mcuWidth - 1) / mcuWidth;
+        const size_t rowBytes = static_cast<size_t>(size.x) * channels;
+
+        std::vector<unsigned char> res;
+        res.reserve(rowBytes * mcuHeight * (lastRow - firstRow) / 4);
+        JpegBitWriter writer(res);
+
+        float y[256];
+        float cb[256];
+        float cr[256];
+        float block[64];
+        for (int row = firstRow; row < lastRow; ++row) {
+            int dcY = 0;
+            int dcCb = 0;
+            int dcCr = 0;
+            for (int column = 0; column < nColumns; ++column) {
+                // Pixels outside of the image repeat the last row and column
+                for (int py = 0; py < mcuHeight; ++py) {
+                    const int imageRow = std::min(row * mcuHeight + py, size.y - 1);
+                    const unsigned char* src =
+                        data + static_cast<size_t>(size.y - 1 - imageRow) * rowBytes;
+                    for (int px = 0; px < mcuWidth; ++px) {
+                        const int x = std::min(column * mcuWidth + px, size.x - 1);
+                        const unsigned char* p = src + static_cast<size_t>(x) * channels;
+                        const float r = channels >= 3 ? p[2] : p[0];
+                        const float g = channels >= 3 ? p[1] : p[0];
+                        const float b = p[0];
+                        const int i = py * mcuWidth + px;
+                        y[i] = 0.299f * r + 0.587f * g + 0.114f * b - 128.f;
+                        cb[i] = -0.168736f * r - 0.331264f * g + 0.5f * b;
+                        cr[i] = 0.5f * r - 0.418688f * g - 0.081312f * b;
+                    }
+                }
+
+                for (int by = 0; by < v; ++by) {
+                    for (int bx = 0; bx < h; ++bx) {
+                        for (int i = 0; i < 64; ++i) {
+                            block[i] = y[(by * 8 + i / 8) * mcuWidth + bx * 8 + i % 8];
+                        }
+                        dcY = encodeJpegBlock(
+                            writer, block, tables.lumaScale, dcY, tables.lumaDC,
+                            tables.lumaAC
+                        );
+                    }
+                }
+
+                auto encodeChroma = [&](const float* values, int previousDC) {
+                    const float factor = 1.f / (h * v);
+                    for (int i = 0; i < 64; ++i) {
+                        float sum = 0.f;
+                        for (int sy = 0; sy < v; ++sy) {
+                            for (int sx = 0; sx < h; ++sx) {
+                                const int py = (i / 8) * v + sy;
+                                const int px = (i % 8) * h + sx;
+                                sum += values[py * mcuWidth + px];
+                            }
+                        }
+                        block[i] = sum * factor;
+                    }
+                    return encodeJpegBlock(
+                        writer, block, tables.chromaScale, previousDC, tables.chromaDC,
+                        tables.chromaAC
+                    );
+                };
+                dcCb = encodeChroma(cb, dcCb);
+                dcCr = encodeChroma(cr, dcCr);
+            }
+
+            writer.flush();
+            if (row < nRows - 1) {
+                // The restart markers cycle through RST0 to RST7
+                res.push_back(0xff);
+                res.push_back(static_cast<unsigned char>(0xd0 + row % 8));
+            }
+        }
+        return res;
+    }
 } // namespace
 
 namespace sgct {
 
 Image::~Image() {
+    if (_data) {
+        memory::deallocate(memory::Subsystem::Image, _dataSize);
+    }
     delete[] _data;
 }
 
@@ -64,37 +678,27 @@ void Image::load(const std::string& filename) {
         throw Err(9000, "Cannot load empty filepath");
     }
 
-    stbi_set_flip_vertically_on_load(1);
     _data = stbi_load(filename.c_str(), &_size.x, &_size.y, &_nChannels, 0);
     if (_data == nullptr) {
         throw Err(9001, "Could not open file '" + filename + "' for loading image");
     }
     _bytesPerChannel = 1;
     _dataSize = _size.x * _size.y * _nChannels * _bytesPerChannel;
-
-    // Convert BGR to RGB
-    if (_nChannels >= 3) {
-        for (size_t i = 0; i < _dataSize; i += _nChannels) {
-            std::swap(_data[i], _data[i + 2]);
-        }
-    }
+    memory::allocate(memory::Subsystem::Image, _dataSize);
+    convertLoadedData();
 }
 
 void Image::load(unsigned char* data, int length) {
-    stbi_set_flip_vertically_on_load(1);
     _data = stbi_load_from_memory(data, length, &_size.x, &_size.y, &_nChannels, 0);
     _bytesPerChannel = 1;
     _dataSize = _size.x * _size.y * _nChannels * _bytesPerChannel;
-
-    // Convert BGR to RGB
-    if (_nChannels >= 3) {
-        for (size_t i = 0; i < _dataSize; i += _nChannels) {
-            std::swap(_data[i], _data[i + 2]);
-        }
+    if (_data) {
+        memory::allocate(memory::Subsystem::Image, _dataSize);
+        convertLoadedData();
     }
 }
 
-void Image::save(const std::string& file) {
+void Image::save(const std::string& file) const {
     if (file.empty()) {
         throw Err(9002, "Filename not set for saving image");
     }
@@ -103,40 +707,34 @@ void Image::save(const std::string& file) {
     if (type == FormatType::Unknown) {
         throw Err(9003, "Cannot save file " + file);
     }
+
+    const Settings& settings = Settings::instance();
     if (type == FormatType::PNG) {
-        // We use libPNG instead of stb as libPNG is faster and we care about how fast
-        // PNGs are written to disk in production
-        savePNG(file);
+        // We use our own PNG writer instead of stb as it compresses the image on
+        // multiple threads and we care about how fast PNGs are written to disk in
+        // production
+        savePNG(file, settings.pngCompressionLevel(), settings.pngFilter());
         return;
     }
-
-    if (_nChannels >= 3) {
-        for (size_t i = 0; i < _dataSize; i += _nChannels) {
-            std::swap(_data[i], _data[i + 2]);
-        }
-    }
-
-    stbi_flip_vertically_on_write(1);
+    // The same is true for JPEG and TGA files, which are also written directly from the
+    // BGR(A) rows in bottom-up order without converting the whole image first
     if (type == FormatType::JPEG) {
-        int r = stbi_write_jpg(file.c_str(), _size.x, _size.y, _nChannels, _data, 100);
-        if (r == 0) {
-            throw Err(9004, "Could not save file '" + file + "' as JPG");
-        }
+        saveJPEG(file, settings.jpegQuality(), settings.jpegSubsampling());
         return;
     }
     if (type == FormatType::TGA) {
-        int r = stbi_write_tga(file.c_str(), _size.x, _size.y, _nChannels, _data);
-        if (r == 0) {
-            throw Err(9005, "Could not save file '" + file + "' as TGA");
-
-        }
+        saveTGA(file);
         return;
     }
 
     throw std::logic_error("We should never get here");
 }
 
-void Image::savePNG(std::string filename, int compressionLevel) {
+void Image::savePNG(std::string filename, int compressionLevel,
+                    PngFilter filter) const
+{
+    ZoneScoped
+
     if (_data == nullptr) {
         throw Err(9006, "Missing image data to save PNG");
     }
@@ -147,44 +745,47 @@ void Image::savePNG(std::string filename, int compressionLevel) {
 
     double t0 = Engine::getTime();
 
-    FILE* fp = fopen(filename.c_str(), "wb");
-    if (fp == nullptr) {
-        throw Err(9008, "Can't create PNG file '" + filename + "'");
-    }
+    // Each stripe is filtered and compressed on its own thread; the compressed stripes
+    // are concatenated into a single zlib stream. As every stripe starts with an empty
+    // dictionary, the file is slightly larger than one that is compressed in one go
+    const int nCores = static_cast<int>(std::thread::hardware_concurrency());
+    const int nThreads = std::max(nCores, 1);
+    const int nStripes = std::clamp(_size.y / MinRowsPerPngStripe, 1, nThreads);
 
-    // initialize stuff
-    png_structp png_ptr = png_create_write_struct(
-        PNG_LIBPNG_VER_STRING,
-        nullptr,
-        nullptr,
-        nullptr
-    );
-    if (!png_ptr) {
-        throw Err(9009, "Failed to create PNG struct");
-    }
-
-    // set compression
-    png_set_compression_level(png_ptr, compressionLevel);
-    png_set_filter(png_ptr, 0, PNG_FILTER_NONE);
-    png_set_compression_mem_level(png_ptr, 8);
-    png_set_compression_strategy(png_ptr, Z_DEFAULT_STRATEGY);
-    png_set_compression_window_bits(png_ptr, 15);
-    png_set_compression_method(png_ptr, 8);
-    png_set_compression_buffer_size(png_ptr, 8192);
+    std::vector<PngStripe> stripes(nStripes);
+    {
+        auto encode = [&](int i) {
+            const int first = _size.y * i / nStripes;
+            const int last = _size.y * (i + 1) / nStripes;
+            const bool isLast = i == nStripes - 1;
+            const int level = compressionLevel;
+            stripes[i] = encodePngStripe(*this, first, last, isLast, level, filter);
+        };
 
-    png_infop info_ptr = png_create_info_struct(png_ptr);
-    if (!info_ptr) {
-        throw Err(9010, "Failed to create PNG info struct");
+        std::vector<std::future<void>> futures;
+        futures.reserve(nStripes - 1);
+        for (int i = 1; i < nStripes; ++i) {
+            futures.push_back(std::async(std::launch::async, encode, i));
+        }
+        encode(0);
+        for (std::future<void>& f : futures) {
+            // Rethrows the exceptions that occurred while encoding the stripe
+            f.get();
+        }
     }
 
-    if (setjmp(png_jmpbuf(png_ptr))) {
-        png_destroy_write_struct(&png_ptr, &info_ptr);
-        throw Err(9011, "One of the called PNG functions failed");
+    uLong adler = stripes[0].adler;
+    for (int i = 1; i < nStripes; ++i) {
+        const z_off_t length = static_cast<z_off_t>(stripes[i].nUncompressed);
+        adler = adler32_combine(adler, stripes[i].adler, length);
     }
 
-    png_init_io(png_ptr, fp);
+    FILE* fp = fopen(filename.c_str(), "wb");
+    if (fp == nullptr) {
+        throw Err(9008, "Can't create PNG file '" + filename + "'");
+    }
 
-    const int colorType = [](int channels) {
+    const unsigned char colorType = [](int channels) {
         switch (channels) {
             case 1: return PNG_COLOR_TYPE_GRAY;
             case 2: return PNG_COLOR_TYPE_GRAY_ALPHA;
@@ -194,43 +795,219 @@ void Image::savePNG(std::string filename, int compressionLevel) {
         }
     }(_nChannels);
 
-    // write header
-    png_set_IHDR(
-        png_ptr,
-        info_ptr,
-        _size.x,
-        _size.y,
-        _bytesPerChannel * 8,
-        colorType,
-        PNG_INTERLACE_NONE,
-        PNG_COMPRESSION_TYPE_BASE,
-        PNG_FILTER_TYPE_BASE
-    );
+    unsigned char ihdr[13];
+    writeBigEndian(ihdr, static_cast<uint32_t>(_size.x));
+    writeBigEndian(ihdr + 4, static_cast<uint32_t>(_size.y));
+    ihdr[8] = static_cast<unsigned char>(_bytesPerChannel * 8);
+    ihdr[9] = colorType;
+    ihdr[10] = PNG_COMPRESSION_TYPE_BASE;
+    ihdr[11] = PNG_FILTER_TYPE_BASE;
+    ihdr[12] = PNG_INTERLACE_NONE;
+
+    // zlib header for a deflate stream with a 32K window. The level in the header is
+    // only informational and -1 is zlib's default level of 6
+    const int levelFlag = [](int level) {
+        if (level == -1 || level == 6) {
+            return 2;
+        }
+        return level < 2 ? 0 : (level < 6 ? 1 : 3);
+    }(compressionLevel);
+    unsigned char zlibHeader[2] = { 0x78, static_cast<unsigned char>(levelFlag << 6) };
+    zlibHeader[1] += static_cast<unsigned char>(31 - ((0x78 << 8 | zlibHeader[1]) % 31));
 
-    if (colorType == PNG_COLOR_TYPE_RGB || colorType == PNG_COLOR_TYPE_RGB_ALPHA) {
-        png_set_bgr(png_ptr);
+    unsigned char checksum[4];
+    writeBigEndian(checksum, static_cast<uint32_t>(adler));
+
+    // The zlib stream can be split over any number of IDAT chunks, so the header and the
+    // checksum are written in separate chunks to avoid copying the stripes
+    constexpr const unsigned char Signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    bool success = fwrite(Signature, 1, 8, fp) == 8;
+    success &= writePngChunk(fp, "IHDR", ihdr, sizeof(ihdr));
+    success &= writePngChunk(fp, "IDAT", zlibHeader, sizeof(zlibHeader));
+    for (const PngStripe& stripe : stripes) {
+        const unsigned char* data = stripe.compressed.data();
+        success &= writePngChunk(fp, "IDAT", data, stripe.nCompressed);
     }
-    png_write_info(png_ptr, info_ptr);
+    success &= writePngChunk(fp, "IDAT", checksum, sizeof(checksum));
+    success &= writePngChunk(fp, "IEND", nullptr, 0);
+    fclose(fp);
 
-    // swap big-endian to little endian
-    if (_bytesPerChannel == 2) {
-        png_set_swap(png_ptr);
+    if (!success) {
+        throw Err(9008, "Can't write PNG file '" + filename + "'");
     }
 
-    std::vector<png_bytep> rowPtrs(_size.y);
+    const double time = (Engine::getTime() - t0) * 1000.0;
+    Log::Debug(
+        "'%s' was saved successfully in %d stripes (%.2f ms)",
+        filename.c_str(), nStripes, time
+    );
+}
 
-    for (int y = 0; y < _size.y; y++) {
-        rowPtrs[(_size.y - 1u) - y] = &_data[y * _size.x * _nChannels * _bytesPerChannel];
+void Image::saveJPEG(std::string filename, int quality,
+                     Settings::JpegSubsampling subsampling) const
+{
+    ZoneScoped
+
+    if (_bytesPerChannel > 2) {
+        throw Err(9007, "Can't save " + std::to_string(_bytesPerChannel * 8) + " bit");
+    }
+    if (_data == nullptr || _size.x > 65535 || _size.y > 65535) {
+        throw Err(9004, "Could not save file '" + filename + "' as JPG");
+    }
+
+    double t0 = Engine::getTime();
+
+    std::vector<unsigned char> buffer;
+    const unsigned char* pixels = pixels8Bit(*this, buffer);
+    const JpegTables tables = createJpegTables(std::clamp(quality, 1, 100));
+    const int mcuWidth = subsampling == JpegSubsampling::Chroma444 ? 8 : 16;
+    const int mcuHeight = subsampling == JpegSubsampling::Chroma420 ? 16 : 8;
+    const int nColumns = (_size.x + mcuWidth - 1) / mcuWidth;
+    const int nRows = (_size.y + mcuHeight - 1) / mcuHeight;
+
+    // Each stripe of MCU rows is encoded on its own thread. As every MCU row is its own
+    // restart interval, the file is slightly larger than without restart markers
+    const int nCores = static_cast<int>(std::thread::hardware_concurrency());
+    const int nThreads = std::max(nCores, 1);
+    const int nStripes =
+        std::clamp(_size.y / MinRowsPerJpegStripe, 1, std::min(nThreads, nRows));
+
+    std::vector<std::vector<unsigned char>> stripes(nStripes);
+    {
+        auto encode = [&](int i) {
+            const int first = nRows * i / nStripes;
+            const int last = nRows * (i + 1) / nStripes;
+            stripes[i] = encodeJpegStripe(
+                pixels, _size, _nChannels, first, last, nRows, tables, subsampling
+            );
+        };
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(nStripes - 1);
+        for (int i = 1; i < nStripes; ++i) {
+            futures.push_back(std::async(std::launch::async, encode, i));
+        }
+        encode(0);
+        for (std::future<void>& f : futures) {
+            // Rethrows the exceptions that occurred while encoding the stripe
+            f.get();
+        }
     }
-    png_write_image(png_ptr, rowPtrs.data());
-    rowPtrs.clear();
 
-    png_write_end(png_ptr, nullptr);
-    png_destroy_write_struct(&png_ptr, &info_ptr);
+    std::vector<unsigned char> header;
+    auto append = [&header](std::initializer_list<unsigned int> bytes) {
+        for (unsigned int b : bytes) {
+            header.push_back(static_cast<unsigned char>(b));
+        }
+    };
+    auto appendTable = [&header](const unsigned char* table, size_t size) {
+        header.insert(header.end(), table, table + size);
+    };
+    const unsigned int w = static_cast<unsigned int>(_size.x);
+    const unsigned int h = static_cast<unsigned int>(_size.y);
+    const unsigned int n = static_cast<unsigned int>(nColumns);
+    const unsigned int sampling = (mcuWidth / 8) << 4 | (mcuHeight / 8);
+
+    // Start of image and JFIF header without a thumbnail
+    append({ 0xff, 0xd8, 0xff, 0xe0, 0, 16, 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1,
+             0, 0 });
+    // Quantization tables
+    append({ 0xff, 0xdb, 0, 132, 0 });
+    appendTable(tables.luma, 64);
+    append({ 1 });
+    appendTable(tables.chroma, 64);
+    // Baseline frame; the sampling factors of the luma define the chroma subsampling
+    append({ 0xff, 0xc0, 0, 17, 8, h >> 8, h & 0xff, w >> 8, w & 0xff, 3,
+             1, sampling, 0, 2, 0x11, 1, 3, 0x11, 1 });
+    // Huffman tables
+    const unsigned int dhtSize = 2 + 4 * 17 + 2 * 12 + 2 * 162;
+    append({ 0xff, 0xc4, dhtSize >> 8, dhtSize & 0xff });
+    append({ 0x00 });
+    appendTable(JpegLumaDC, sizeof(JpegLumaDC));
+    append({ 0x10 });
+    appendTable(JpegLumaAC, sizeof(JpegLumaAC));
+    append({ 0x01 });
+    appendTable(JpegChromaDC, sizeof(JpegChromaDC));
+    append({ 0x11 });
+    appendTable(JpegChromaAC, sizeof(JpegChromaAC));
+    // Restart interval of one MCU row
+    append({ 0xff, 0xdd, 0, 4, n >> 8, n & 0xff });
+    // Start of scan with all three components
+    append({ 0xff, 0xda, 0, 12, 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0 });
+
+    FILE* fp = fopen(filename.c_str(), "wb");
+    if (fp == nullptr) {
+        throw Err(9004, "Could not save file '" + filename + "' as JPG");
+    }
+    constexpr const unsigned char EndOfImage[2] = { 0xff, 0xd9 };
+    bool success = fwrite(header.data(), 1, header.size(), fp) == header.size();
+    for (const std::vector<unsigned char>& stripe : stripes) {
+        success &= fwrite(stripe.data(), 1, stripe.size(), fp) == stripe.size();
+    }
+    success &= fwrite(EndOfImage, 1, 2, fp) == 2;
     fclose(fp);
 
+    if (!success) {
+        throw Err(9004, "Could not save file '" + filename + "' as JPG");
+    }
+
     const double time = (Engine::getTime() - t0) * 1000.0;
-    Log::Debug("'%s' was saved successfully (%.2f ms)", filename.c_str(), time);
+    Log::Debug(
+        "'%s' was saved successfully in %d stripes (%.2f ms)",
+        filename.c_str(), nStripes, time
+    );
+}
+
+void Image::saveTGA(std::string filename) const {
+    ZoneScoped
+
+    if (_bytesPerChannel > 2) {
+        throw Err(9007, "Can't save " + std::to_string(_bytesPerChannel * 8) + " bit");
+    }
+    if (_data == nullptr || _size.x > 65535 || _size.y > 65535) {
+        throw Err(9005, "Could not save file '" + filename + "' as TGA");
+    }
+
+    std::vector<unsigned char> buffer;
+    const unsigned char* pixels = pixels8Bit(*this, buffer);
+
+    // Uncompressed TGA files store BGR(A) or grayscale rows from bottom to top, which is
+    // exactly how the image is stored in memory
+    const bool hasAlpha = _nChannels == 2 || _nChannels == 4;
+    unsigned char header[18] = {};
+    header[2] = _nChannels >= 3 ? 2 : 3;
+    header[12] = static_cast<unsigned char>(_size.x & 0xff);
+    header[13] = static_cast<unsigned char>((_size.x >> 8) & 0xff);
+    header[14] = static_cast<unsigned char>(_size.y & 0xff);
+    header[15] = static_cast<unsigned char>((_size.y >> 8) & 0xff);
+    header[16] = static_cast<unsigned char>(_nChannels * 8);
+    header[17] = hasAlpha ? 8 : 0;
+
+    FILE* fp = fopen(filename.c_str(), "wb");
+    if (fp == nullptr) {
+        throw Err(9005, "Could not save file '" + filename + "' as TGA");
+    }
+    const size_t size = static_cast<size_t>(_size.x) * _size.y * _nChannels;
+    const bool success =
+        fwrite(header, 1, sizeof(header), fp) == sizeof(header) &&
+        fwrite(pixels, 1, size, fp) == size;
+    fclose(fp);
+
+    if (!success) {
+        throw Err(9005, "Could not save file '" + filename + "' as TGA");
+    }
+}
+
+void Image::convertLoadedData() {
+    // stb returns RGB(A) rows from top to bottom, but images are stored as BGR(A) rows
+    // from bottom to top. The flip is not left to stb as its setting for that is global
+    // and would not be safe when images are loaded on multiple threads
+    const size_t nPixels = static_cast<size_t>(_size.x) * _size.y;
+    const size_t rowBytes = static_cast<size_t>(_size.x) * _nChannels;
+    pixelkernels::flipVertically(_data, rowBytes, _size.y);
+    if (_nChannels >= 3) {
+        pixelkernels::swapRedBlue(_data, _data, nPixels, _nChannels);
+    }
 }
 
 unsigned char* Image::data() {
@@ -278,6 +1055,7 @@ void Image::allocateOrResizeData() {
 
     if (_data && _dataSize != dataSize) {
         // re-allocate if needed
+        memory::deallocate(memory::Subsystem::Image, _dataSize);
         delete[] _data;
         _data = nullptr;
         _dataSize = 0;
@@ -286,6 +1064,7 @@ void Image::allocateOrResizeData() {
     if (!_data) {
         _data = new unsigned char[dataSize];
         _dataSize = dataSize;
+        memory::allocate(memory::Subsystem::Image, _dataSize);
 
         Log::Debug(
             "Allocated %d bytes for image data (%.2f ms)",
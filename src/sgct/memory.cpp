@@ -0,0 +1,298 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/memory.h>
+
+#include <sgct/log.h>
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    using sgct::memory::Subsystem;
+
+    constexpr const int NSubsystems = static_cast<int>(Subsystem::Count);
+
+    struct Counter {
+        std::atomic<std::int64_t> bytes{ 0 };
+        std::atomic<std::int64_t> highWaterMark{ 0 };
+        std::atomic<std::uint64_t> allocations{ 0 };
+        std::atomic<std::uint64_t> deallocations{ 0 };
+        std::atomic<std::int64_t> budget{ 0 };
+        std::atomic_bool hasWarnedBudget{ false };
+    };
+
+    // This is a function-local static rather than a global to make it usable during
+    // static initialization and destruction of other objects
+    std::array<Counter, NSubsystems>& counters() {
+        static std::array<Counter, NSubsystems> Counters;
+        return Counters;
+    }
+
+    struct TextureEntry {
+        Subsystem subsystem;
+        std::size_t bytes;
+    };
+
+    std::mutex& textureMutex() {
+        static std::mutex Mutex;
+        return Mutex;
+    }
+
+    std::unordered_map<unsigned int, TextureEntry>& textures() {
+        static std::unordered_map<unsigned int, TextureEntry> Textures;
+        return Textures;
+    }
+
+    Counter& counter(Subsystem subsystem) {
+        return counters()[static_cast<int>(subsystem)];
+    }
+
+    std::string formatBytes(std::int64_t bytes) {
+        char buf[32];
+        const double b = static_cast<double>(bytes);
+        if (bytes >= 1024 * 1024 * 1024) {
+            std::snprintf(buf, sizeof(buf), "%.2f GiB", b / (1024.0 * 1024.0 * 1024.0));
+        }
+        else if (bytes >= 1024 * 1024) {
+            std::snprintf(buf, sizeof(buf), "%.2f MiB", b / (1024.0 * 1024.0));
+        }
+        else if (bytes >= 1024) {
+            std::snprintf(buf, sizeof(buf), "%.2f KiB", b / 1024.0);
+        }
+        else {
+            std::snprintf(buf, sizeof(buf), "%lld B", static_cast<long long>(bytes));
+        }
+        return buf;
+    }
+} // namespace
+
+namespace sgct::memory {
+
+const char* toString(Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::Network: return "Network";
+        case Subsystem::SharedData: return "SharedData";
+        case Subsystem::Image: return "Image";
+        case Subsystem::Capture: return "Capture";
+        case Subsystem::CorrectionMesh: return "CorrectionMesh";
+        case Subsystem::Font: return "Font";
+        case Subsystem::Texture: return "Texture";
+        case Subsystem::FrameBuffer: return "FrameBuffer";
+        case Subsystem::CubeMap: return "CubeMap";
+        default: throw std::logic_error("Unhandled case label");
+    }
+}
+
+bool isGpuMemory(Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::Network:
+        case Subsystem::SharedData:
+        case Subsystem::Image:
+            return false;
+        case Subsystem::Capture:
+        case Subsystem::CorrectionMesh:
+        case Subsystem::Font:
+        case Subsystem::Texture:
+        case Subsystem::FrameBuffer:
+        case Subsystem::CubeMap:
+            return true;
+        default: throw std::logic_error("Unhandled case label");
+    }
+}
+
+void allocate(Subsystem subsystem, std::size_t bytes) {
+    Counter& c = counter(subsystem);
+    c.allocations++;
+    const std::int64_t current = (c.bytes += static_cast<std::int64_t>(bytes));
+
+    std::int64_t hwm = c.highWaterMark;
+    while (current > hwm && !c.highWaterMark.compare_exchange_weak(hwm, current)) {}
+
+    const std::int64_t budget = c.budget;
+    if (budget > 0 && current > budget && !c.hasWarnedBudget.exchange(true)) {
+        Log::Warning(
+            "Memory budget for %s exceeded: %s of %s", toString(subsystem),
+            formatBytes(current).c_str(), formatBytes(budget).c_str()
+        );
+    }
+
+    TracyPlot(toString(subsystem), current);
+}
+
+void deallocate(Subsystem subsystem, std::size_t bytes) {
+    Counter& c = counter(subsystem);
+    c.deallocations++;
+    c.bytes -= static_cast<std::int64_t>(bytes);
+
+    TracyPlot(toString(subsystem), c.bytes.load());
+}
+
+void track(Subsystem subsystem, std::size_t& tracked, std::size_t bytes) {
+    if (bytes > tracked) {
+        allocate(subsystem, bytes - tracked);
+    }
+    else if (bytes < tracked) {
+        deallocate(subsystem, tracked - bytes);
+    }
+    tracked = bytes;
+}
+
+void trackTexture(Subsystem subsystem, unsigned int texture, std::size_t bytes) {
+    if (texture == 0) {
+        return;
+    }
+
+    std::unique_lock lock(textureMutex());
+    auto it = textures().find(texture);
+    if (it != textures().end()) {
+        deallocate(it->second.subsystem, it->second.bytes);
+        it->second = { subsystem, bytes };
+    }
+    else {
+        textures()[texture] = { subsystem, bytes };
+    }
+    allocate(subsystem, bytes);
+}
+
+void untrackTexture(unsigned int texture) {
+    if (texture == 0) {
+        return;
+    }
+
+    std::unique_lock lock(textureMutex());
+    auto it = textures().find(texture);
+    if (it != textures().end()) {
+        deallocate(it->second.subsystem, it->second.bytes);
+        textures().erase(it);
+    }
+}
+
+std::size_t estimateImageBytes(unsigned int internalFormat, int width, int height,
+                               int layers, int samples)
+{
+    const std::size_t bytesPerPixel = [](GLenum format) -> std::size_t {
+        switch (format) {
+            case GL_R8:
+            case GL_RED:
+                return 1;
+            case GL_RG8:
+            case GL_RG:
+            case GL_R16F:
+            case GL_COMPRESSED_RG:
+                return 2;
+            case GL_RGB8:
+            case GL_RGB:
+                return 3;
+            case GL_RGBA8:
+            case GL_RGBA:
+            case GL_SRGB8_ALPHA8:
+            case GL_RGB10_A2:
+            case GL_R11F_G11F_B10F:
+            case GL_RG16F:
+            case GL_R32F:
+            case GL_DEPTH_COMPONENT24:
+            case GL_DEPTH_COMPONENT32:
+            case GL_DEPTH_COMPONENT32F:
+            case GL_DEPTH24_STENCIL8:
+                return 4;
+            case GL_RGB16:
+            case GL_RGB16F:
+                return 6;
+            case GL_RGBA16:
+            case GL_RGBA16F:
+            case GL_RGBA16I:
+            case GL_RGBA16UI:
+            case GL_RG32F:
+                return 8;
+            case GL_RGB32F:
+                return 12;
+            case GL_RGBA32F:
+            case GL_RGBA32I:
+            case GL_RGBA32UI:
+                return 16;
+            default:
+                // Unknown formats are assumed to be the common 8 bit RGBA format
+                return 4;
+        }
+    }(internalFormat);
+
+    return bytesPerPixel * static_cast<std::size_t>(width) *
+        static_cast<std::size_t>(height) * static_cast<std::size_t>(layers) *
+        static_cast<std::size_t>(std::max(samples, 1));
+}
+
+void setBudget(Subsystem subsystem, std::size_t bytes) {
+    Counter& c = counter(subsystem);
+    c.budget = static_cast<std::int64_t>(bytes);
+    c.hasWarnedBudget = false;
+}
+
+Usage usage(Subsystem subsystem) {
+    const Counter& c = counter(subsystem);
+    Usage u;
+    u.bytes = c.bytes;
+    u.highWaterMark = c.highWaterMark;
+    u.allocations = c.allocations;
+    u.deallocations = c.deallocations;
+    u.budget = c.budget;
+    return u;
+}
+
+std::uint64_t totalAllocations() {
+    std::uint64_t res = 0;
+    for (const Counter& c : counters()) {
+        res += c.allocations;
+    }
+    return res;
+}
+
+void resetHighWaterMarks() {
+    for (Counter& c : counters()) {
+        c.highWaterMark = c.bytes.load();
+    }
+}
+
+std::string report() {
+    std::string res = "Memory usage:\n";
+
+    std::int64_t hostTotal = 0;
+    std::int64_t gpuTotal = 0;
+    for (int i = 0; i < NSubsystems; ++i) {
+        const Subsystem s = static_cast<Subsystem>(i);
+        const Usage u = usage(s);
+        (isGpuMemory(s) ? gpuTotal : hostTotal) += u.bytes;
+
+        char buf[256];
+        std::snprintf(
+            buf, sizeof(buf),
+            "  %-16s %-4s current: %-12s peak: %-12s allocs: %llu frees: %llu",
+            toString(s), isGpuMemory(s) ? "GPU" : "Host", formatBytes(u.bytes).c_str(),
+            formatBytes(u.highWaterMark).c_str(),
+            static_cast<unsigned long long>(u.allocations),
+            static_cast<unsigned long long>(u.deallocations)
+        );
+        res += buf;
+        if (u.budget > 0) {
+            res += " budget: " + formatBytes(u.budget);
+        }
+        res += '\n';
+    }
+
+    res += "  Total host: " + formatBytes(hostTotal) + "  Total GPU (estimated): " +
+        formatBytes(gpuTotal);
+    return res;
+}
+
+} // namespace sgct::memory
@@ -11,12 +11,15 @@
 #include <sgct/error.h>
 #include <sgct/log.h>
 #include <sgct/math.h>
+#include <sgct/profiling.h>
+#include <sgct/correction/mpcdimesh.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <tinyxml2.h>
 #include <unzip.h>
 #include <algorithm>
+#include <future>
 
 #define Error(code, msg) Error(Error::Component::MPCDI, code, msg)
 
@@ -30,9 +33,12 @@ namespace {
         return r;
     }
 
+    // A PFM file in the archive that is only decompressed once it is known which region
+    // it belongs to
     struct SubFile {
         std::string fileName;
-        std::vector<char> buffer;
+        unz_file_pos position;
+        uint64_t size = 0;
     };
 
     [[nodiscard]] config::MpcdiProjection parseRegion(const tinyxml2::XMLElement& elem) {
@@ -144,7 +150,8 @@ namespace {
     }
 
     void parseGeoWarpFile(const tinyxml2::XMLElement& element, const std::string& region,
-                          const SubFile& pfmFile, ReturnValue& res)
+                          const std::vector<SubFile>& pfmFiles,
+                          std::vector<const SubFile*>& warpFiles, ReturnValue& res)
     {
         const tinyxml2::XMLElement* interp = element.FirstChildElement("interpolation");
         if (interp == nullptr) {
@@ -160,12 +167,18 @@ namespace {
         }
         std::string_view pathWarpFile(path->GetText());
 
+        const auto pfmFile = std::find_if(
+            pfmFiles.cbegin(),
+            pfmFiles.cend(),
+            [&pathWarpFile](const SubFile& f) { return f.fileName == pathWarpFile; }
+        );
+
         // Look for matching MPCDI region (SGCT viewport) to pass the warp field data to
         bool foundMatchingPfmBuffer = false;
-        for (ReturnValue::ViewportInfo& vpInfo : res.viewports) {
-            const std::string& viewportId = *vpInfo.proj.id;
-            if (viewportId == region && pathWarpFile == pfmFile.fileName) {
-                vpInfo.meshData = pfmFile.buffer;
+        for (size_t i = 0; i < res.viewports.size() && pfmFile != pfmFiles.cend(); ++i) {
+            const std::string& viewportId = *res.viewports[i].proj.id;
+            if (viewportId == region) {
+                warpFiles[i] = &*pfmFile;
                 foundMatchingPfmBuffer = true;
             }
         }
@@ -174,7 +187,9 @@ namespace {
         }
     }
 
-    void parseFiles(const tinyxml2::XMLElement& e, const SubFile& pfm, ReturnValue& res) {
+    void parseFiles(const tinyxml2::XMLElement& e, const std::vector<SubFile>& pfmFiles,
+                    std::vector<const SubFile*>& warpFiles, ReturnValue& res)
+    {
         std::string fileRegion;
 
         const tinyxml2::XMLElement* child = e.FirstChildElement("fileset");
@@ -207,7 +222,7 @@ namespace {
                     Log::Warning("Unsupported feature: encodeLUT");
                 }
 
-                parseGeoWarpFile(*c, fileRegion, pfm, res);
+                parseGeoWarpFile(*c, fileRegion, pfmFiles, warpFiles, res);
 
                 c = c->NextSiblingElement("geometryWarpFile");
             }
@@ -215,7 +230,10 @@ namespace {
         }
     }
 
-    ReturnValue parseMpcdi(const tinyxml2::XMLDocument& doc, const SubFile& pfmFile) {
+    ReturnValue parseMpcdi(const tinyxml2::XMLDocument& doc,
+                           const std::vector<SubFile>& pfmFiles,
+                           std::vector<const SubFile*>& warpFiles)
+    {
         const tinyxml2::XMLElement* rootNode = doc.FirstChildElement("MPCDI");
         if (rootNode == nullptr) {
             throw Error(4012, "Cannot find XML root");
@@ -252,7 +270,8 @@ namespace {
         if (filesElement == nullptr) {
             throw Error(4018, "Missing 'files' element");
         }
-        parseFiles(*filesElement, pfmFile, res);
+        warpFiles.resize(res.viewports.size(), nullptr);
+        parseFiles(*filesElement, pfmFiles, warpFiles, res);
 
         // Check for unsupported features that we might want to warn about
         const tinyxml2::XMLElement* extSetElem = root.FirstChildElement("extensionSet");
@@ -262,6 +281,51 @@ namespace {
 
         return res;
     }
+
+    /**
+     * Decompresses the PFM file straight into the mesh of a region. Every region opens
+     * the archive on its own, as the state of an unzFile cannot be shared between the
+     * threads that read the regions in parallel.
+     */
+    correction::Buffer readWarpMesh(const std::string& filename, const SubFile& pfm) {
+        ZoneScoped
+
+        unzFile zip = unzOpen(filename.c_str());
+        if (zip == nullptr) {
+            throw Error(4019, "Unable to open zip archive file " + filename);
+        }
+        unz_file_pos position = pfm.position;
+        if (unzGoToFilePos(zip, &position) != UNZ_OK ||
+            unzOpenCurrentFile(zip) != UNZ_OK)
+        {
+            unzClose(zip);
+            throw Error(4024, "Unable to open " + pfm.fileName);
+        }
+
+        try {
+            auto read = [zip](char* buffer, size_t size) -> size_t {
+                const unsigned int bytes = static_cast<unsigned int>(size);
+                const int n = unzReadCurrentFile(zip, buffer, bytes);
+                if (n < 0) {
+                    throw Error(4025, "Read from PFM file failed");
+                }
+                return static_cast<size_t>(n);
+            };
+            correction::Buffer mesh = correction::generateMpcdiMesh(read, pfm.size);
+
+            // Closing the file also verifies the checksum of the data that was read
+            if (unzCloseCurrentFile(zip) != UNZ_OK) {
+                throw Error(4025, "Read from " + pfm.fileName + " failed");
+            }
+            unzClose(zip);
+            return mesh;
+        }
+        catch (...) {
+            unzCloseCurrentFile(zip);
+            unzClose(zip);
+            throw;
+        }
+    }
 } // namespace
 
 ReturnValue parseMpcdiConfiguration(const std::string& filename) {
@@ -277,9 +341,10 @@ ReturnValue parseMpcdiConfiguration(const std::string& filename) {
         throw Error(4020, "Unable to get zip archive info from " + filename);
     }
 
-    // Search for required files inside mpcdi archive file
+    // Search for required files inside mpcdi archive file. Only the XML file is read
+    // here, the PFM files are decompressed once it is known which regions use them
     std::vector<char> xmlBuffer;
-    SubFile pfmComponent;
+    std::vector<SubFile> pfmFiles;
     try {
         for (unsigned int i = 0; i < globalInfo.number_entry; ++i) {
             unz_file_info info;
@@ -310,22 +375,26 @@ ReturnValue parseMpcdiConfiguration(const std::string& filename) {
                 }
             }
             else if (endsWith(fileName, "pfm")) {
-                // Uncompress the PFM file
-                if (!pfmComponent.buffer.empty()) {
-                    Log::Warning("Duplicate file %s found in MPCDI", fileName.c_str());
+                SubFile pfm;
+                pfm.fileName = fileName;
+                pfm.size = info.uncompressed_size;
+                if (unzGetFilePos(zip, &pfm.position) != UNZ_OK) {
+                    throw Error(4024, "Unable to open " + fileName);
                 }
 
-                const int openCurrentFile = unzOpenCurrentFile(zip);
-                if (openCurrentFile != UNZ_OK) {
-                    throw Error(4024, "Unable to open " + fileName);
+                // As before, the last of multiple files with the same name is used
+                const auto it = std::find_if(
+                    pfmFiles.begin(),
+                    pfmFiles.end(),
+                    [&fileName](const SubFile& f) { return f.fileName == fileName; }
+                );
+                if (it != pfmFiles.end()) {
+                    Log::Warning("Duplicate file %s found in MPCDI", fileName.c_str());
+                    *it = std::move(pfm);
                 }
-                std::vector<char> buffer(uncompSize);
-                const int size = unzReadCurrentFile(zip, buffer.data(), uncompSize);
-                if (size < 0) {
-                    throw Error(4025, "Read from " + fileName + " failed");
+                else {
+                    pfmFiles.push_back(std::move(pfm));
                 }
-                pfmComponent.fileName = fileName;
-                pfmComponent.buffer = std::move(buffer);
             }
             else {
                 Log::Warning("Ignoring extension %s", fileName.c_str());
@@ -345,7 +414,7 @@ ReturnValue parseMpcdiConfiguration(const std::string& filename) {
     }
 
     unzClose(zip);
-    if (xmlBuffer.empty() || pfmComponent.buffer.empty()) {
+    if (xmlBuffer.empty() || pfmFiles.empty()) {
         throw Error(4026, filename + " does not contain the XML and/or PFM file");
     }
 
@@ -360,7 +429,38 @@ ReturnValue parseMpcdiConfiguration(const std::string& filename) {
         throw Error(4027, "Error parsing file. " + str);
     }
 
-    ReturnValue res = parseMpcdi(xmlDoc, pfmComponent);
+    std::vector<const SubFile*> warpFiles;
+    ReturnValue res = parseMpcdi(xmlDoc, pfmFiles, warpFiles);
+
+    // The regions are independent of each other, so their meshes are built in parallel.
+    // All tasks are waited for before the first error is rethrown, as they refer to the
+    // local list of files
+    std::vector<std::future<correction::Buffer>> meshes(res.viewports.size());
+    for (size_t i = 0; i < res.viewports.size(); ++i) {
+        if (warpFiles[i]) {
+            meshes[i] = std::async(
+                std::launch::async,
+                readWarpMesh,
+                std::cref(filename),
+                std::cref(*warpFiles[i])
+            );
+        }
+    }
+    std::exception_ptr error;
+    for (size_t i = 0; i < res.viewports.size(); ++i) {
+        if (!meshes[i].valid()) {
+            continue;
+        }
+        try {
+            res.viewports[i].mesh = meshes[i].get();
+        }
+        catch (...) {
+            error = error ? error : std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
     return res;
 }
 
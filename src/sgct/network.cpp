@@ -34,6 +34,7 @@
 #include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/log.h>
+#include <sgct/memory.h>
 #include <sgct/mutexes.h>
 #include <sgct/networkmanager.h>
 #include <sgct/profiling.h>
@@ -172,6 +173,7 @@ Network::Network(int port, std::string address, bool isServer, ConnectionType t)
 
 Network::~Network() {
     closeNetwork(false);
+    memory::track(memory::Subsystem::Network, _trackedBufferBytes, 0);
 }
 
 void Network::initialize() {
@@ -348,17 +350,19 @@ int Network::iterateFrameCounter() {
     return _currentSendFrame;
 }
 
-void Network::pushClientMessage() {
+void Network::pushClientMessage(const void* payload, uint32_t length) {
     // The servers' render function is locked until an ack message is received
     const int currentFrame = iterateFrameCounter();
-    uint32_t localSyncHeaderSize = 0;
 
-    char data[HeaderSize];
+    std::vector<char> data(HeaderSize + length);
     data[0] = Network::DataId;
-    std::memcpy(data + 1, &currentFrame, sizeof(currentFrame));
-    std::memcpy(data + 5, &localSyncHeaderSize, sizeof(localSyncHeaderSize));
-    std::memset(data + 9, DefaultId, 4);
-    sendData(data, HeaderSize);
+    std::memcpy(data.data() + 1, &currentFrame, sizeof(currentFrame));
+    std::memcpy(data.data() + 5, &length, sizeof(length));
+    std::memset(data.data() + 9, DefaultId, 4);
+    if (length > 0) {
+        std::memcpy(data.data() + HeaderSize, payload, length);
+    }
+    sendData(data.data(), static_cast<int>(data.size()));
 }
 
 int Network::sendFrameCurrent() const {
@@ -493,6 +497,15 @@ void Network::updateBuffer(std::vector<char>& buf, uint32_t reqSize, uint32_t& c
     std::unique_lock lock(_connectionMutex);
     buf.resize(reqSize);
     curSize = reqSize;
+    trackBufferMemory();
+}
+
+void Network::trackBufferMemory() {
+    memory::track(
+        memory::Subsystem::Network,
+        _trackedBufferBytes,
+        _recvBuffer.capacity() + _uncompressBuffer.capacity()
+    );
 }
 
 int Network::readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize,
@@ -630,6 +643,7 @@ void Network::communicationHandler() {
         std::unique_lock lk(_connectionMutex);
         _recvBuffer.resize(_bufferSize);
         _uncompressBuffer.resize(_uncompressedBufferSize);
+        trackBufferMemory();
     }
     std::string extBuffer; // for external communication
 
@@ -22,6 +22,7 @@
 #include <sgct/mutexes.h>
 #include <sgct/node.h>
 #include <sgct/profiling.h>
+#include <sgct/settings.h>
 #include <sgct/shareddata.h>
 #include <algorithm>
 #include <cstring>
@@ -316,8 +317,19 @@ void NetworkManager::initialize() {
             if (_isServer && !matchesAddress(n.address())) {
                 addConnection(n.syncPort(), remoteAddress);
 
+                const Network* connection = _networkConnections.back().get();
                 _networkConnections.back()->setDecodeFunction(
-                    [](const char* data, int length) {
+                    [this, connection](const char* data, int length) {
+                        // The clients attach the time of their last frame to the ack
+                        constexpr int FrameTimeSize = 1 + sizeof(float);
+                        if (length == FrameTimeSize && data[0] == Network::FrameTimeId) {
+                            float frameTime;
+                            std::memcpy(&frameTime, data + 1, sizeof(float));
+                            std::unique_lock lock(_clientFrameTimesMutex);
+                            _clientFrameTimes[connection] = frameTime;
+                            return;
+                        }
+
                         std::vector<char> d(data, data + length);
                         d.push_back('\0');
                         Log::Info("[client]: %s [end]", d.data());
@@ -394,7 +406,7 @@ std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
             minTime = std::min(currentTime, minTime);
 
             const int currentSize =
-                static_cast<int>(SharedData::instance().dataSize()) - Network::HeaderSize;
+                SharedData::instance().dataSize() - Network::HeaderSize;
 
             // iterate counter
             const int currentFrame = connection->iterateFrameCounter();
@@ -405,7 +417,7 @@ std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
 
             connection->sendData(
                 SharedData::instance().dataBlock(),
-                static_cast<int>(SharedData::instance().dataSize())
+                SharedData::instance().dataSize()
             );
         }
 
@@ -414,17 +426,47 @@ std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
         }
     }
     else if (sm == SyncMode::Acknowledge) {
+        // The frame time is only needed by the dynamic resolution controller
+        const bool sendFrameTime = Settings::instance().dynamicResolution().isEnabled;
+        char frameTime[1 + sizeof(float)];
+        frameTime[0] = Network::FrameTimeId;
+        std::memcpy(frameTime + 1, &_frameTime, sizeof(float));
+
         for (Network* connection : _syncConnections) {
             if (!connection->isServer() && connection->isConnected()) {
                 // The servers's render function is locked until a message starting with
                 // the ack-byte is received.
-                connection->pushClientMessage();
+                if (sendFrameTime) {
+                    connection->pushClientMessage(frameTime, sizeof(frameTime));
+                }
+                else {
+                    connection->pushClientMessage();
+                }
             }
         }
     }
     return std::nullopt;
 }
 
+void NetworkManager::setFrameTime(float frameTime) {
+    _frameTime = frameTime;
+}
+
+float NetworkManager::maxClientFrameTime() const {
+    std::unique_lock lock(_clientFrameTimesMutex);
+    float res = 0.f;
+    for (Network* connection : _syncConnections) {
+        if (!connection->isConnected()) {
+            continue;
+        }
+        const auto it = _clientFrameTimes.find(connection);
+        if (it != _clientFrameTimes.cend()) {
+            res = std::max(res, it->second);
+        }
+    }
+    return res;
+}
+
 bool NetworkManager::isSyncComplete() const {
     const unsigned int counter = static_cast<unsigned int>(std::count_if(
         _syncConnections.cbegin(),
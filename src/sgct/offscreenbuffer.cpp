@@ -9,6 +9,7 @@
 #include <sgct/offscreenbuffer.h>
 
 #include <sgct/log.h>
+#include <sgct/memory.h>
 #include <sgct/opengl.h>
 #include <sgct/settings.h>
 #include <algorithm>
@@ -51,6 +52,7 @@ OffScreenBuffer::~OffScreenBuffer() {
     glDeleteRenderbuffers(1, &_colorBuffer);
     glDeleteRenderbuffers(1, &_normalBuffer);
     glDeleteRenderbuffers(1, &_positionBuffer);
+    memory::track(memory::Subsystem::FrameBuffer, _trackedBytes, 0);
 }
 
 void OffScreenBuffer::createFBO(int width, int height, int samples) {
@@ -196,6 +198,33 @@ void OffScreenBuffer::createFBO(int width, int height, int samples) {
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // The color attachments of the non-multisampled buffer are textures owned by the
+    // caller, so only the render buffers that are created here are accounted for
+    size_t bytes = memory::estimateImageBytes(
+        GL_DEPTH_COMPONENT32,
+        width,
+        height,
+        1,
+        _isMultiSampled ? samples : 1
+    );
+    if (_isMultiSampled) {
+        bytes += memory::estimateImageBytes(
+            _internalColorFormat,
+            width,
+            height,
+            1,
+            samples
+        );
+        const unsigned int precision = Settings::instance().bufferFloatPrecision();
+        if (Settings::instance().useNormalTexture()) {
+            bytes += memory::estimateImageBytes(precision, width, height, 1, samples);
+        }
+        if (Settings::instance().usePositionTexture()) {
+            bytes += memory::estimateImageBytes(precision, width, height, 1, samples);
+        }
+    }
+    memory::track(memory::Subsystem::FrameBuffer, _trackedBytes, bytes);
 }
 
 void OffScreenBuffer::resizeFBO(int width, int height, int samples) {
@@ -0,0 +1,826 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/pixelkernels.h>
+
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SGCT_PIXELKERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else // _MSC_VER
+#include <cpuid.h>
+#endif // _MSC_VER
+#endif // x86
+
+// The vectorized kernels are compiled for their instruction set regardless of the flags
+// of the rest of the library and are only called if the CPU supports that set
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SGCT_TARGET(isa)
+#else // defined(_MSC_VER) && !defined(__clang__)
+#define SGCT_TARGET(isa) __attribute__((target(isa)))
+#endif // defined(_MSC_VER) && !defined(__clang__)
+
+namespace {
+    using sgct::pixelkernels::InstructionSet;
+
+    // The largest pixel is four 32-bit channels
+    constexpr const int MaxPixelBytes = 16;
+
+    InstructionSet detectInstructionSet() {
+#ifdef SGCT_PIXELKERNELS_X86
+        auto cpuid = [](unsigned int leaf, std::array<unsigned int, 4>& regs) {
+#ifdef _MSC_VER
+            int r[4];
+            __cpuidex(r, static_cast<int>(leaf), 0);
+            std::copy(std::begin(r), std::end(r), regs.begin());
+#else // _MSC_VER
+            __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif // _MSC_VER
+        };
+
+        std::array<unsigned int, 4> regs = {};
+        cpuid(0, regs);
+        const unsigned int maxLeaf = regs[0];
+        if (maxLeaf < 1) {
+            return InstructionSet::Scalar;
+        }
+
+        cpuid(1, regs);
+        const bool hasSSE41 = regs[2] & (1 << 19);
+        const bool hasOSXSave = regs[2] & (1 << 27);
+        const bool hasAVX = regs[2] & (1 << 28);
+        const bool hasF16C = regs[2] & (1 << 29);
+
+        bool hasAVX2 = false;
+        if (maxLeaf >= 7) {
+            cpuid(7, regs);
+            hasAVX2 = regs[1] & (1 << 5);
+        }
+
+        // The operating system also has to save the AVX registers on context switches
+        bool hasOSSupport = false;
+        if (hasOSXSave && hasAVX) {
+#ifdef _MSC_VER
+            const unsigned long long xcr0 = _xgetbv(0);
+#else // _MSC_VER
+            unsigned int eax = 0;
+            unsigned int edx = 0;
+            __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            const unsigned long long xcr0 =
+                (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif // _MSC_VER
+            hasOSSupport = (xcr0 & 0x6) == 0x6;
+        }
+
+        if (hasOSSupport && hasAVX2 && hasF16C) {
+            return InstructionSet::AVX2;
+        }
+        if (hasSSE41) {
+            return InstructionSet::SSE41;
+        }
+#endif // SGCT_PIXELKERNELS_X86
+        return InstructionSet::Scalar;
+    }
+
+    InstructionSet supportedInstructionSet() {
+        static const InstructionSet Supported = []() {
+            const InstructionSet set = detectInstructionSet();
+            sgct::Log::Debug(
+                "Using %s pixel kernels", sgct::pixelkernels::toString(set)
+            );
+            return set;
+        }();
+        return Supported;
+    }
+
+    std::atomic<InstructionSet> CurrentSet = InstructionSet::Scalar;
+    std::atomic_bool IsInitialized = false;
+
+    InstructionSet currentSet() {
+        if (!IsInitialized) {
+            CurrentSet = supportedInstructionSet();
+            IsInitialized = true;
+        }
+        return CurrentSet;
+    }
+
+    //
+    // Byte shuffles within pixels
+    //
+
+    // pattern[i] is the byte of the source pixel that is stored in byte i of the
+    // destination pixel
+    void shuffleScalar(const unsigned char* src, unsigned char* dst, size_t nPixels,
+                       int pixelBytes, const unsigned char* pattern)
+    {
+        std::array<unsigned char, MaxPixelBytes> pixel;
+        for (size_t i = 0; i < nPixels; ++i) {
+            std::memcpy(pixel.data(), src + i * pixelBytes, pixelBytes);
+            unsigned char* d = dst + i * pixelBytes;
+            for (int b = 0; b < pixelBytes; ++b) {
+                d[b] = pixel[pattern[b]];
+            }
+        }
+    }
+
+    // Creates the mask for shuffling as many whole pixels as fit into 16 bytes. The bytes
+    // after the last whole pixel are kept as they are, so that a 16-byte store does not
+    // change any pixel that has not been shuffled yet when converting in place
+    std::array<unsigned char, 16> shuffleMask(int pixelBytes,
+                                              const unsigned char* pattern)
+    {
+        const int step = (16 / pixelBytes) * pixelBytes;
+        std::array<unsigned char, 16> mask;
+        for (int i = 0; i < 16; ++i) {
+            mask[i] = static_cast<unsigned char>(
+                i < step ? (i / pixelBytes) * pixelBytes + pattern[i % pixelBytes] : i
+            );
+        }
+        return mask;
+    }
+
+#ifdef SGCT_PIXELKERNELS_X86
+    SGCT_TARGET("sse4.1")
+    void shuffleSSE41(const unsigned char* src, unsigned char* dst, size_t nPixels,
+                      int pixelBytes, const unsigned char* pattern)
+    {
+        const std::array<unsigned char, 16> m = shuffleMask(pixelBytes, pattern);
+        const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m.data()));
+        const size_t pixelsPerStep = 16 / pixelBytes;
+        const size_t step = pixelsPerStep * pixelBytes;
+        const size_t nBytes = nPixels * pixelBytes;
+
+        size_t i = 0;
+        for (; i + 16 <= nBytes; i += step) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(dst + i),
+                _mm_shuffle_epi8(v, mask)
+            );
+        }
+        shuffleScalar(src + i, dst + i, nPixels - i / pixelBytes, pixelBytes, pattern);
+    }
+
+    SGCT_TARGET("avx2")
+    void shuffleAVX2(const unsigned char* src, unsigned char* dst, size_t nPixels,
+                     int pixelBytes, const unsigned char* pattern)
+    {
+        if (16 % pixelBytes != 0) {
+            // Pixels would straddle the two 128-bit lanes that vpshufb works on
+            shuffleSSE41(src, dst, nPixels, pixelBytes, pattern);
+            return;
+        }
+
+        const std::array<unsigned char, 16> m = shuffleMask(pixelBytes, pattern);
+        const __m128i lane = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m.data()));
+        const __m256i mask = _mm256_broadcastsi128_si256(lane);
+        const size_t nBytes = nPixels * pixelBytes;
+
+        size_t i = 0;
+        for (; i + 32 <= nBytes; i += 32) {
+            const __m256i* s = reinterpret_cast<const __m256i*>(src + i);
+            const __m256i v = _mm256_loadu_si256(s);
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(dst + i),
+                _mm256_shuffle_epi8(v, mask)
+            );
+        }
+        shuffleSSE41(src + i, dst + i, nPixels - i / pixelBytes, pixelBytes, pattern);
+    }
+#endif // SGCT_PIXELKERNELS_X86
+
+    void shuffle(const unsigned char* src, unsigned char* dst, size_t nPixels,
+                 int pixelBytes, const unsigned char* pattern)
+    {
+        switch (currentSet()) {
+#ifdef SGCT_PIXELKERNELS_X86
+            case InstructionSet::AVX2:
+                shuffleAVX2(src, dst, nPixels, pixelBytes, pattern);
+                break;
+            case InstructionSet::SSE41:
+                shuffleSSE41(src, dst, nPixels, pixelBytes, pattern);
+                break;
+#endif // SGCT_PIXELKERNELS_X86
+            default:
+                shuffleScalar(src, dst, nPixels, pixelBytes, pattern);
+                break;
+        }
+    }
+
+    //
+    // Removing the alpha channel
+    //
+
+    void stripAlphaScalar(const unsigned char* src, unsigned char* dst, size_t nPixels,
+                          bool swapRedBlue)
+    {
+        const int r = swapRedBlue ? 0 : 2;
+        const int b = swapRedBlue ? 2 : 0;
+        for (size_t i = 0; i < nPixels; ++i) {
+            const unsigned char* s = src + i * 4;
+            unsigned char* d = dst + i * 3;
+            // Reading all channels first makes the in-place conversion safe
+            const unsigned char c0 = s[0];
+            const unsigned char c1 = s[1];
+            const unsigned char c2 = s[2];
+            d[b] = c0;
+            d[1] = c1;
+            d[r] = c2;
+        }
+    }
+
+#ifdef SGCT_PIXELKERNELS_X86
+    SGCT_TARGET("sse4.1")
+    void stripAlphaSSE41(const unsigned char* src, unsigned char* dst, size_t nPixels,
+                         bool swapRedBlue)
+    {
+        const __m128i mask = swapRedBlue ?
+            _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+            _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+        // Each step reads 16 bytes but writes 16 bytes of which only 12 are valid. The
+        // additional bytes are overwritten by the next step, but must not be written past
+        // the end of the destination
+        size_t i = 0;
+        for (; i + 6 <= nPixels; i += 4) {
+            const __m128i* s = reinterpret_cast<const __m128i*>(src + i * 4);
+            const __m128i v = _mm_loadu_si128(s);
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(dst + i * 3),
+                _mm_shuffle_epi8(v, mask)
+            );
+        }
+        stripAlphaScalar(src + i * 4, dst + i * 3, nPixels - i, swapRedBlue);
+    }
+#endif // SGCT_PIXELKERNELS_X86
+
+    //
+    // Conversions into 8-bit values
+    //
+
+    unsigned char uint16ToByte(uint16_t v) {
+        // Equal to the rounded value of v * 255 / 65535
+        return static_cast<unsigned char>((v * 255u + 32895u) >> 16);
+    }
+
+    unsigned char floatToByte(float v) {
+        // Written so that NaN fails both comparisons and becomes 0
+        const float c = v > 0.f ? (v < 1.f ? v : 1.f) : 0.f;
+        return static_cast<unsigned char>(static_cast<int>(c * 255.f + 0.5f));
+    }
+
+    float halfToFloat(uint16_t h) {
+        const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+        const uint32_t exponent = (h >> 10) & 0x1f;
+        const uint32_t mantissa = h & 0x3ff;
+
+        uint32_t bits;
+        if (exponent == 0) {
+            if (mantissa == 0) {
+                bits = sign;
+            }
+            else {
+                // Subnormal numbers are normalized for the larger exponent range
+                int e = -1;
+                uint32_t m = mantissa;
+                do {
+                    e++;
+                    m <<= 1;
+                } while ((m & 0x400) == 0);
+                bits = sign | ((112 - e) << 23) | ((m & 0x3ff) << 13);
+            }
+        }
+        else if (exponent == 31) {
+            // Infinity or NaN
+            bits = sign | 0x7f800000 | (mantissa << 13);
+        }
+        else {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+        float res;
+        std::memcpy(&res, &bits, sizeof(res));
+        return res;
+    }
+
+    // There are only 65536 half values, so a table is faster than any conversion
+    const std::vector<unsigned char>& halfTable() {
+        static const std::vector<unsigned char> Table = []() {
+            std::vector<unsigned char> table(65536);
+            for (size_t i = 0; i < table.size(); ++i) {
+                table[i] = floatToByte(halfToFloat(static_cast<uint16_t>(i)));
+            }
+            return table;
+        }();
+        return Table;
+    }
+
+    void uint16ToUInt8Scalar(const unsigned char* src, unsigned char* dst, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            uint16_t v;
+            std::memcpy(&v, src + i * 2, sizeof(v));
+            dst[i] = uint16ToByte(v);
+        }
+    }
+
+    void halfToUInt8Scalar(const unsigned char* src, unsigned char* dst, size_t n) {
+        const std::vector<unsigned char>& table = halfTable();
+        for (size_t i = 0; i < n; ++i) {
+            uint16_t v;
+            std::memcpy(&v, src + i * 2, sizeof(v));
+            dst[i] = table[v];
+        }
+    }
+
+    void floatToUInt8Scalar(const unsigned char* src, unsigned char* dst, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            float v;
+            std::memcpy(&v, src + i * 4, sizeof(v));
+            dst[i] = floatToByte(v);
+        }
+    }
+
+#ifdef SGCT_PIXELKERNELS_X86
+    // Converts eight 16-bit values into 32-bit values of v * 255 + 32895 >> 16
+    SGCT_TARGET("sse4.1")
+    __m128i scaleUInt16SSE41(__m128i v) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi32(32895);
+        const __m128i scale = _mm_set1_epi32(255);
+        const __m128i lo = _mm_srli_epi32(
+            _mm_add_epi32(_mm_mullo_epi32(_mm_unpacklo_epi16(v, zero), scale), bias),
+            16
+        );
+        const __m128i hi = _mm_srli_epi32(
+            _mm_add_epi32(_mm_mullo_epi32(_mm_unpackhi_epi16(v, zero), scale), bias),
+            16
+        );
+        return _mm_packus_epi32(lo, hi);
+    }
+
+    SGCT_TARGET("sse4.1")
+    void uint16ToUInt8SSE41(const unsigned char* src, unsigned char* dst, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i* s = reinterpret_cast<const __m128i*>(src + i * 2);
+            const __m128i a = scaleUInt16SSE41(_mm_loadu_si128(s));
+            const __m128i b = scaleUInt16SSE41(_mm_loadu_si128(s + 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+        }
+        uint16ToUInt8Scalar(src + i * 2, dst + i, n - i);
+    }
+
+    SGCT_TARGET("avx2")
+    __m256i scaleUInt16AVX2(__m128i v) {
+        const __m256i bias = _mm256_set1_epi32(32895);
+        const __m256i scale = _mm256_set1_epi32(255);
+        const __m256i wide = _mm256_cvtepu16_epi32(v);
+        return _mm256_srli_epi32(
+            _mm256_add_epi32(_mm256_mullo_epi32(wide, scale), bias),
+            16
+        );
+    }
+
+    // Packs 32 values of four registers with eight 32-bit values each into bytes
+    SGCT_TARGET("avx2")
+    __m256i packToBytesAVX2(__m256i a, __m256i b, __m256i c, __m256i d) {
+        // The packs work within 128-bit lanes, so the result has to be reordered
+        const __m256i ab = _mm256_packus_epi32(a, b);
+        const __m256i cd = _mm256_packus_epi32(c, d);
+        const __m256i bytes = _mm256_packus_epi16(ab, cd);
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        return _mm256_permutevar8x32_epi32(bytes, order);
+    }
+
+    SGCT_TARGET("avx2")
+    void uint16ToUInt8AVX2(const unsigned char* src, unsigned char* dst, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            const __m128i* s = reinterpret_cast<const __m128i*>(src + i * 2);
+            const __m256i bytes = packToBytesAVX2(
+                scaleUInt16AVX2(_mm_loadu_si128(s)),
+                scaleUInt16AVX2(_mm_loadu_si128(s + 1)),
+                scaleUInt16AVX2(_mm_loadu_si128(s + 2)),
+                scaleUInt16AVX2(_mm_loadu_si128(s + 3))
+            );
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+        }
+        uint16ToUInt8SSE41(src + i * 2, dst + i, n - i);
+    }
+
+    SGCT_TARGET("sse4.1")
+    __m128i floatToIntSSE41(__m128 v) {
+        // maxps returns the second operand if the first one is NaN
+        const __m128 c = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+        const __m128 scaled = _mm_add_ps(
+            _mm_mul_ps(c, _mm_set1_ps(255.f)),
+            _mm_set1_ps(0.5f)
+        );
+        return _mm_cvttps_epi32(scaled);
+    }
+
+    SGCT_TARGET("sse4.1")
+    void floatToUInt8SSE41(const unsigned char* src, unsigned char* dst, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const float* s = reinterpret_cast<const float*>(src + i * 4);
+            const __m128i a = floatToIntSSE41(_mm_loadu_ps(s));
+            const __m128i b = floatToIntSSE41(_mm_loadu_ps(s + 4));
+            const __m128i c = floatToIntSSE41(_mm_loadu_ps(s + 8));
+            const __m128i d = floatToIntSSE41(_mm_loadu_ps(s + 12));
+            const __m128i bytes = _mm_packus_epi16(
+                _mm_packus_epi32(a, b),
+                _mm_packus_epi32(c, d)
+            );
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+        }
+        floatToUInt8Scalar(src + i * 4, dst + i, n - i);
+    }
+
+    SGCT_TARGET("avx2")
+    __m256i floatToIntAVX2(__m256 v) {
+        const __m256 c = _mm256_min_ps(
+            _mm256_max_ps(v, _mm256_setzero_ps()),
+            _mm256_set1_ps(1.f)
+        );
+        const __m256 scaled = _mm256_add_ps(
+            _mm256_mul_ps(c, _mm256_set1_ps(255.f)),
+            _mm256_set1_ps(0.5f)
+        );
+        return _mm256_cvttps_epi32(scaled);
+    }
+
+    SGCT_TARGET("avx2")
+    void floatToUInt8AVX2(const unsigned char* src, unsigned char* dst, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            const float* s = reinterpret_cast<const float*>(src + i * 4);
+            const __m256i bytes = packToBytesAVX2(
+                floatToIntAVX2(_mm256_loadu_ps(s)),
+                floatToIntAVX2(_mm256_loadu_ps(s + 8)),
+                floatToIntAVX2(_mm256_loadu_ps(s + 16)),
+                floatToIntAVX2(_mm256_loadu_ps(s + 24))
+            );
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+        }
+        floatToUInt8SSE41(src + i * 4, dst + i, n - i);
+    }
+
+    SGCT_TARGET("avx2,f16c")
+    void halfToUInt8AVX2(const unsigned char* src, unsigned char* dst, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            const __m128i* s = reinterpret_cast<const __m128i*>(src + i * 2);
+            const __m256i bytes = packToBytesAVX2(
+                floatToIntAVX2(_mm256_cvtph_ps(_mm_loadu_si128(s))),
+                floatToIntAVX2(_mm256_cvtph_ps(_mm_loadu_si128(s + 1))),
+                floatToIntAVX2(_mm256_cvtph_ps(_mm_loadu_si128(s + 2))),
+                floatToIntAVX2(_mm256_cvtph_ps(_mm_loadu_si128(s + 3)))
+            );
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+        }
+        halfToUInt8Scalar(src + i * 2, dst + i, n - i);
+    }
+#endif // SGCT_PIXELKERNELS_X86
+
+    //
+    // YUV conversion
+    //
+    // The conversion uses the BT.601 coefficients for limited range video in 8-bit fixed
+    // point. The chroma of each 2x2 block is computed from the sum of its four pixels,
+    // which is why the chroma results are shifted by two additional bits
+
+    unsigned char luma(const unsigned char* bgr) {
+        return static_cast<unsigned char>(
+            ((25 * bgr[0] + 129 * bgr[1] + 66 * bgr[2] + 128) >> 8) + 16
+        );
+    }
+
+    unsigned char chromaU(int b, int g, int r) {
+        return static_cast<unsigned char>(
+            ((112 * b - 74 * g - 38 * r + 512) >> 10) + 128
+        );
+    }
+
+    unsigned char chromaV(int b, int g, int r) {
+        return static_cast<unsigned char>(
+            ((-18 * b - 94 * g + 112 * r + 512) >> 10) + 128
+        );
+    }
+
+    // Converts two rows of BGR(A) pixels into two rows of luma and one row of chroma,
+    // starting at pixel x. For the last row of an image with an odd height, both rows
+    // point to the same pixels
+    void convertRowPairScalar(const unsigned char* row0, const unsigned char* row1,
+                              int x, int width, int channels, unsigned char* y0,
+                              unsigned char* y1, unsigned char* u, unsigned char* v)
+    {
+        for (; x < width; x += 2) {
+            // The last column of an image with an odd width forms a block with itself
+            const int next = std::min(x + 1, width - 1);
+            const unsigned char* p00 = row0 + x * channels;
+            const unsigned char* p01 = row0 + next * channels;
+            const unsigned char* p10 = row1 + x * channels;
+            const unsigned char* p11 = row1 + next * channels;
+
+            y0[x] = luma(p00);
+            y1[x] = luma(p10);
+            if (next != x) {
+                y0[next] = luma(p01);
+                y1[next] = luma(p11);
+            }
+
+            const int b = p00[0] + p01[0] + p10[0] + p11[0];
+            const int g = p00[1] + p01[1] + p10[1] + p11[1];
+            const int r = p00[2] + p01[2] + p10[2] + p11[2];
+            u[x / 2] = chromaU(b, g, r);
+            v[x / 2] = chromaV(b, g, r);
+        }
+    }
+
+#ifdef SGCT_PIXELKERNELS_X86
+    // Adds the neighboring 32-bit values: [a0 + a1, a2 + a3, b0 + b1, b2 + b3]
+    SGCT_TARGET("sse4.1")
+    __m128i addPairs(__m128i a, __m128i b) {
+        const __m128 fa = _mm_castsi128_ps(a);
+        const __m128 fb = _mm_castsi128_ps(b);
+        const __m128 even = _mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 odd = _mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+    }
+
+    // Returns the weighted sums of the channels of four BGRA pixels as 32-bit values
+    SGCT_TARGET("sse4.1")
+    __m128i weightedSum(__m128i pixels, __m128i weights) {
+        const __m128i lo = _mm_madd_epi16(_mm_cvtepu8_epi16(pixels), weights);
+        const __m128i hi = _mm_madd_epi16(
+            _mm_unpackhi_epi8(pixels, _mm_setzero_si128()),
+            weights
+        );
+        return addPairs(lo, hi);
+    }
+
+    // Returns the luma of eight BGRA pixels in the lower eight bytes
+    SGCT_TARGET("sse4.1")
+    __m128i lumaSSE41(__m128i first, __m128i second) {
+        const __m128i weights = _mm_setr_epi16(25, 129, 66, 0, 25, 129, 66, 0);
+        const __m128i offset = _mm_set1_epi32(128 + (16 << 8));
+        const __m128i l0 = _mm_srai_epi32(
+            _mm_add_epi32(weightedSum(first, weights), offset),
+            8
+        );
+        const __m128i l1 = _mm_srai_epi32(
+            _mm_add_epi32(weightedSum(second, weights), offset),
+            8
+        );
+        const __m128i words = _mm_packs_epi32(l0, l1);
+        return _mm_packus_epi16(words, words);
+    }
+
+    // Returns the 16-bit channel sums of the two 2x2 blocks that are formed by four BGRA
+    // pixels of two neighboring rows
+    SGCT_TARGET("sse4.1")
+    __m128i blockSums(__m128i row0, __m128i row1) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lo = _mm_add_epi16(
+            _mm_unpacklo_epi8(row0, zero),
+            _mm_unpacklo_epi8(row1, zero)
+        );
+        const __m128i hi = _mm_add_epi16(
+            _mm_unpackhi_epi8(row0, zero),
+            _mm_unpackhi_epi8(row1, zero)
+        );
+        return _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+    }
+
+    // Returns the chroma of the four blocks whose channel sums are in s0 and s1
+    SGCT_TARGET("sse4.1")
+    int chromaSSE41(__m128i s0, __m128i s1, __m128i weights) {
+        const __m128i offset = _mm_set1_epi32(512 + (128 << 10));
+        const __m128i sum = addPairs(
+            _mm_madd_epi16(s0, weights),
+            _mm_madd_epi16(s1, weights)
+        );
+        const __m128i c = _mm_srai_epi32(_mm_add_epi32(sum, offset), 10);
+        const __m128i words = _mm_packs_epi32(c, c);
+        return _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+    }
+
+    SGCT_TARGET("sse4.1")
+    void convertRowPairSSE41(const unsigned char* row0, const unsigned char* row1,
+                             int width, int channels, unsigned char* y0,
+                             unsigned char* y1, unsigned char* u, unsigned char* v)
+    {
+        const __m128i weightsU = _mm_setr_epi16(112, -74, -38, 0, 112, -74, -38, 0);
+        const __m128i weightsV = _mm_setr_epi16(-18, -94, 112, 0, -18, -94, 112, 0);
+
+        int x = 0;
+        if (channels == 4) {
+            for (; x + 8 <= width; x += 8) {
+                const __m128i* p0 = reinterpret_cast<const __m128i*>(row0 + x * 4);
+                const __m128i* p1 = reinterpret_cast<const __m128i*>(row1 + x * 4);
+                const __m128i a0 = _mm_loadu_si128(p0);
+                const __m128i a1 = _mm_loadu_si128(p0 + 1);
+                const __m128i b0 = _mm_loadu_si128(p1);
+                const __m128i b1 = _mm_loadu_si128(p1 + 1);
+
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(y0 + x), lumaSSE41(a0, a1));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(y1 + x), lumaSSE41(b0, b1));
+
+                const __m128i s0 = blockSums(a0, b0);
+                const __m128i s1 = blockSums(a1, b1);
+                const int cu = chromaSSE41(s0, s1, weightsU);
+                const int cv = chromaSSE41(s0, s1, weightsV);
+                std::memcpy(u + x / 2, &cu, sizeof(cu));
+                std::memcpy(v + x / 2, &cv, sizeof(cv));
+            }
+        }
+        convertRowPairScalar(row0, row1, x, width, channels, y0, y1, u, v);
+    }
+#endif // SGCT_PIXELKERNELS_X86
+} // namespace
+
+namespace sgct::pixelkernels {
+
+InstructionSet instructionSet() {
+    return currentSet();
+}
+
+void setInstructionSet(InstructionSet set) {
+    CurrentSet = std::min(set, supportedInstructionSet());
+    IsInitialized = true;
+}
+
+const char* toString(InstructionSet set) {
+    switch (set) {
+        case InstructionSet::Scalar: return "scalar";
+        case InstructionSet::SSE41: return "SSE4.1";
+        case InstructionSet::AVX2: return "AVX2";
+        default: throw std::logic_error("Unhandled case label");
+    }
+}
+
+void swapRedBlue(const unsigned char* src, unsigned char* dst, size_t nPixels,
+                 int channels, int bytesPerChannel, bool swapEndian)
+{
+    ZoneScoped
+
+    swapEndian = swapEndian && bytesPerChannel == 2;
+    if (channels < 3 && !swapEndian) {
+        if (src != dst) {
+            std::memmove(dst, src, nPixels * channels * bytesPerChannel);
+        }
+        return;
+    }
+
+    const int pixelBytes = channels * bytesPerChannel;
+    std::array<unsigned char, MaxPixelBytes> pattern;
+    for (int c = 0; c < channels; ++c) {
+        const int srcChannel = (channels >= 3 && (c == 0 || c == 2)) ? 2 - c : c;
+        for (int b = 0; b < bytesPerChannel; ++b) {
+            const int srcByte = swapEndian ? bytesPerChannel - 1 - b : b;
+            pattern[c * bytesPerChannel + b] =
+                static_cast<unsigned char>(srcChannel * bytesPerChannel + srcByte);
+        }
+    }
+    shuffle(src, dst, nPixels, pixelBytes, pattern.data());
+}
+
+void swapEndian16(const unsigned char* src, unsigned char* dst, size_t nValues) {
+    ZoneScoped
+
+    constexpr const unsigned char Pattern[] = { 1, 0 };
+    shuffle(src, dst, nValues, 2, Pattern);
+}
+
+void stripAlpha(const unsigned char* src, unsigned char* dst, size_t nPixels,
+                bool swapRedBlue)
+{
+    ZoneScoped
+
+#ifdef SGCT_PIXELKERNELS_X86
+    if (currentSet() >= InstructionSet::SSE41) {
+        stripAlphaSSE41(src, dst, nPixels, swapRedBlue);
+        return;
+    }
+#endif // SGCT_PIXELKERNELS_X86
+    stripAlphaScalar(src, dst, nPixels, swapRedBlue);
+}
+
+void flipVertically(unsigned char* data, size_t rowBytes, int nRows) {
+    ZoneScoped
+
+    // Copying whole rows is already as fast as it gets, memcpy is vectorized
+    std::vector<unsigned char> row(rowBytes);
+    for (int i = 0; i < nRows / 2; ++i) {
+        unsigned char* top = data + i * rowBytes;
+        unsigned char* bottom = data + (nRows - 1 - i) * rowBytes;
+        std::memcpy(row.data(), top, rowBytes);
+        std::memcpy(top, bottom, rowBytes);
+        std::memcpy(bottom, row.data(), rowBytes);
+    }
+}
+
+void uint16ToUInt8(const unsigned char* src, unsigned char* dst, size_t nValues) {
+    ZoneScoped
+
+    switch (currentSet()) {
+#ifdef SGCT_PIXELKERNELS_X86
+        case InstructionSet::AVX2:
+            uint16ToUInt8AVX2(src, dst, nValues);
+            break;
+        case InstructionSet::SSE41:
+            uint16ToUInt8SSE41(src, dst, nValues);
+            break;
+#endif // SGCT_PIXELKERNELS_X86
+        default:
+            uint16ToUInt8Scalar(src, dst, nValues);
+            break;
+    }
+}
+
+void halfToUInt8(const unsigned char* src, unsigned char* dst, size_t nValues) {
+    ZoneScoped
+
+#ifdef SGCT_PIXELKERNELS_X86
+    // Without F16C the table is faster than converting to float with SSE
+    if (currentSet() == InstructionSet::AVX2) {
+        halfToUInt8AVX2(src, dst, nValues);
+        return;
+    }
+#endif // SGCT_PIXELKERNELS_X86
+    halfToUInt8Scalar(src, dst, nValues);
+}
+
+void floatToUInt8(const unsigned char* src, unsigned char* dst, size_t nValues) {
+    ZoneScoped
+
+    switch (currentSet()) {
+#ifdef SGCT_PIXELKERNELS_X86
+        case InstructionSet::AVX2:
+            floatToUInt8AVX2(src, dst, nValues);
+            break;
+        case InstructionSet::SSE41:
+            floatToUInt8SSE41(src, dst, nValues);
+            break;
+#endif // SGCT_PIXELKERNELS_X86
+        default:
+            floatToUInt8Scalar(src, dst, nValues);
+            break;
+    }
+}
+
+void bgrToI420(const unsigned char* src, int width, int height, int channels,
+               unsigned char* dst)
+{
+    ZoneScoped
+
+    const size_t stride = static_cast<size_t>(width) * channels;
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+
+    unsigned char* planeY = dst;
+    unsigned char* planeU = planeY + static_cast<size_t>(width) * height;
+    unsigned char* planeV = planeU + static_cast<size_t>(chromaWidth) * chromaHeight;
+
+    [[maybe_unused]] const InstructionSet set = currentSet();
+    for (int row = 0; row < height; row += 2) {
+        const bool hasSecond = row + 1 < height;
+        const unsigned char* src0 = src + (height - 1 - row) * stride;
+        const unsigned char* src1 = hasSecond ? src0 - stride : src0;
+        unsigned char* y0 = planeY + static_cast<size_t>(row) * width;
+        unsigned char* y1 = hasSecond ? y0 + width : y0;
+        unsigned char* u = planeU + static_cast<size_t>(row / 2) * chromaWidth;
+        unsigned char* v = planeV + static_cast<size_t>(row / 2) * chromaWidth;
+#ifdef SGCT_PIXELKERNELS_X86
+        if (set >= InstructionSet::SSE41) {
+            convertRowPairSSE41(src0, src1, width, channels, y0, y1, u, v);
+            continue;
+        }
+#endif // SGCT_PIXELKERNELS_X86
+        convertRowPairScalar(src0, src1, 0, width, channels, y0, y1, u, v);
+    }
+}
+
+size_t i420Size(int width, int height) {
+    const size_t chromaWidth = static_cast<size_t>((width + 1) / 2);
+    const size_t chromaHeight = static_cast<size_t>((height + 1) / 2);
+    return static_cast<size_t>(width) * height + 2 * chromaWidth * chromaHeight;
+}
+
+} // namespace sgct::pixelkernels
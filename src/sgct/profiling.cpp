@@ -8,7 +8,11 @@
 
 #include <sgct/profiling.h>
 
-#ifdef TRACY_ENABLE
+#if defined(TRACY_ENABLE) && defined(SGCT_TRACY_GLOBAL_ALLOCATIONS)
+
+// Overriding the global allocation functions makes every allocation in the application
+// more expensive. The allocations made by SGCT itself are reported per subsystem in
+// sgct/memory.h, so this is only enabled when a complete picture is required
 
 void* operator new(size_t count) {
     void* ptr = malloc(count);
@@ -21,4 +25,4 @@ void operator delete(void* ptr) noexcept {
     free(ptr);
 }
 
-#endif // TRACY_ENABLE
+#endif // TRACY_ENABLE && SGCT_TRACY_GLOBAL_ALLOCATIONS
@@ -50,6 +50,19 @@ FisheyeProjection::~FisheyeProjection() {
     _depthCorrectionShader.deleteProgram();
 }
 
+void FisheyeProjection::setCubemapResolutionScale(float scale) {
+    NonLinearProjection::setCubemapResolutionScale(scale);
+
+    if (_interpolationMode == InterpolationMode::Cubic) {
+        _shader.bind();
+        glUniform1f(
+            glGetUniformLocation(_shader.id(), "size"),
+            static_cast<float>(_cubemapResolution)
+        );
+        ShaderProgram::unbind();
+    }
+}
+
 void FisheyeProjection::update(vec2 size) {
     // do the cropping in the fragment shader and not by changing the vbo
 
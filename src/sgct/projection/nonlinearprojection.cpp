@@ -12,11 +12,13 @@
 #include <sgct/clustermanager.h>
 #include <sgct/engine.h>
 #include <sgct/log.h>
+#include <sgct/memory.h>
 #include <sgct/offscreenbuffer.h>
 #include <sgct/profiling.h>
 #include <sgct/settings.h>
 #include <algorithm>
 #include <array>
+#include <cmath>
 
 namespace sgct {
 
@@ -32,6 +34,16 @@ NonLinearProjection::NonLinearProjection(const Window* parent)
 {}
 
 NonLinearProjection::~NonLinearProjection() {
+    for (unsigned int t : {
+            _textures.cubeMapColor, _textures.cubeMapDepth, _textures.cubeMapNormals,
+            _textures.cubeMapPositions, _textures.colorSwap, _textures.depthSwap,
+            _textures.cubeFaceRight, _textures.cubeFaceLeft, _textures.cubeFaceBottom,
+            _textures.cubeFaceTop, _textures.cubeFaceFront, _textures.cubeFaceBack
+        })
+    {
+        memory::untrackTexture(t);
+    }
+
     glDeleteTextures(1, &_textures.cubeMapColor);
     glDeleteTextures(1, &_textures.cubeMapDepth);
     glDeleteTextures(1, &_textures.cubeMapNormals);
@@ -88,6 +100,21 @@ void NonLinearProjection::updateFrustums(Frustum::Mode mode, float nearClip,
 
 void NonLinearProjection::setCubemapResolution(int resolution) {
     _cubemapResolution = resolution;
+    _unscaledCubemapResolution = resolution;
+}
+
+void NonLinearProjection::setCubemapResolutionScale(float scale) {
+    const int res = std::max(
+        static_cast<int>(std::round(_unscaledCubemapResolution * scale)),
+        1
+    );
+    if (res == _cubemapResolution) {
+        return;
+    }
+
+    _cubemapResolution = res;
+    initTextures();
+    initFBO();
 }
 
 void NonLinearProjection::setInterpolationMode(InterpolationMode im) {
@@ -217,6 +244,7 @@ void NonLinearProjection::setupViewport(BaseViewport& vp) {
 void NonLinearProjection::generateMap(unsigned int& texture, unsigned int internalFormat,
                                       unsigned int format, unsigned int type)
 {
+    memory::untrackTexture(texture);
     glDeleteTextures(1, &texture);
 
     GLint maxMapRes;
@@ -245,6 +273,12 @@ void NonLinearProjection::generateMap(unsigned int& texture, unsigned int intern
         nullptr
     );
 
+    memory::trackTexture(
+        memory::Subsystem::CubeMap,
+        texture,
+        memory::estimateImageBytes(internalFormat, _cubemapResolution, _cubemapResolution)
+    );
+
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -255,6 +289,7 @@ void NonLinearProjection::generateCubeMap(unsigned int& texture,
                                           unsigned int internalFormat,
                                           unsigned int format, unsigned int type)
 {
+    memory::untrackTexture(texture);
     glDeleteTextures(1, &texture);
 
     glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
@@ -341,6 +376,17 @@ void NonLinearProjection::generateCubeMap(unsigned int& texture,
         nullptr
     );
 
+    memory::trackTexture(
+        memory::Subsystem::CubeMap,
+        texture,
+        memory::estimateImageBytes(
+            internalFormat,
+            _cubemapResolution,
+            _cubemapResolution,
+            6
+        )
+    );
+
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
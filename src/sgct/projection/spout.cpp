@@ -85,6 +85,8 @@ SpoutOutputProjection::~SpoutOutputProjection() {
     _depthCorrectionShader.deleteProgram();
 }
 
+void SpoutOutputProjection::setCubemapResolutionScale(float) {}
+
 void SpoutOutputProjection::update(vec2) {
     constexpr const std::array<const float, 20> v = {
         0.f, 0.f, -1.f, -1.f, -1.f,
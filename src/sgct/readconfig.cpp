@@ -501,6 +501,7 @@ namespace {
             viewport.correctionMeshTexture = a;
         }
 
+        viewport.useWarpMap = parseValue<bool>(elem, "warpMap");
         viewport.isTracked = parseValue<bool>(elem, "tracked");
 
         // get eye if set
@@ -756,6 +757,16 @@ namespace {
             display.refreshRate = parseValue<int>(*e, "refreshRate");
             settings.display = display;
         }
+        if (tinyxml2::XMLElement* e = elem.FirstChildElement("DynamicResolution"); e) {
+            sgct::config::Settings::DynamicResolution dr;
+            dr.targetFrameRate = parseValue<float>(*e, "targetFrameRate");
+            dr.minScale = parseValue<float>(*e, "minScale");
+            dr.maxScale = parseValue<float>(*e, "maxScale");
+            dr.step = parseValue<float>(*e, "step");
+            dr.hysteresis = parseValue<float>(*e, "hysteresis");
+            dr.frames = parseValue<int>(*e, "frames");
+            settings.dynamicResolution = dr;
+        }
 
         return settings;
     }
@@ -776,9 +787,84 @@ namespace {
                 if (format == "jpg" || format == "JPG") {
                     return sgct::config::Capture::Format::JPG;
                 }
+                if (format == "raw" || format == "RAW") {
+                    return sgct::config::Capture::Format::Raw;
+                }
+                if (format == "video" || format == "VIDEO") {
+                    return sgct::config::Capture::Format::Video;
+                }
+                if (format == "shm" || format == "SHM") {
+                    return sgct::config::Capture::Format::SharedMemory;
+                }
                 throw Err(6060, "Unknown capturing format");
             }(a);
         }
+        res.readbackBuffers = parseValue<int>(element, "readbackBuffers");
+        res.queueSize = parseValue<int>(element, "queueSize");
+        if (const char* a = element.Attribute("queuePolicy"); a) {
+            res.queuePolicy = [](std::string_view policy) {
+                if (policy == "block") {
+                    return sgct::config::Capture::QueuePolicy::Block;
+                }
+                if (policy == "drop") {
+                    return sgct::config::Capture::QueuePolicy::Drop;
+                }
+                if (policy == "grow") {
+                    return sgct::config::Capture::QueuePolicy::Grow;
+                }
+                throw Err(6061, "Unknown capture queue policy");
+            }(a);
+        }
+        res.segmentSize = parseValue<int>(element, "segmentSize");
+        if (const char* a = element.Attribute("videoCommand"); a) {
+            res.videoCommand = a;
+        }
+        res.videoFrameRate = parseValue<float>(element, "videoFrameRate");
+        if (const char* a = element.Attribute("sharedMemoryName"); a) {
+            res.sharedMemoryName = a;
+        }
+        res.sharedMemorySlots = parseValue<int>(element, "sharedMemorySlots");
+        res.pngCompression = parseValue<int>(element, "pngCompression");
+        if (const char* a = element.Attribute("pngFilter"); a) {
+            res.pngFilter = [](std::string_view filter) {
+                using Filter = sgct::config::Capture::PngFilter;
+                if (filter == "none") {
+                    return Filter::None;
+                }
+                if (filter == "sub") {
+                    return Filter::Sub;
+                }
+                if (filter == "up") {
+                    return Filter::Up;
+                }
+                if (filter == "average") {
+                    return Filter::Average;
+                }
+                if (filter == "paeth") {
+                    return Filter::Paeth;
+                }
+                if (filter == "adaptive") {
+                    return Filter::Adaptive;
+                }
+                throw Err(6062, "Unknown PNG filter");
+            }(a);
+        }
+        res.jpegQuality = parseValue<int>(element, "jpegQuality");
+        if (const char* a = element.Attribute("jpegSubsampling"); a) {
+            res.jpegSubsampling = [](std::string_view subsampling) {
+                using Subsampling = sgct::config::Capture::JpegSubsampling;
+                if (subsampling == "444") {
+                    return Subsampling::Chroma444;
+                }
+                if (subsampling == "422") {
+                    return Subsampling::Chroma422;
+                }
+                if (subsampling == "420") {
+                    return Subsampling::Chroma420;
+                }
+                throw Err(6063, "Unknown JPEG subsampling");
+            }(a);
+        }
         return res;
     }
 
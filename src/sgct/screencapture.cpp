@@ -8,34 +8,23 @@
 
 #include <sgct/screencapture.h>
 
+#include <sgct/capturesegment.h>
+#include <sgct/captureservice.h>
 #include <sgct/clustermanager.h>
 #include <sgct/engine.h>
 #include <sgct/image.h>
 #include <sgct/log.h>
+#include <sgct/memory.h>
+#include <sgct/pixelkernels.h>
 #include <sgct/profiling.h>
 #include <sgct/settings.h>
+#include <sgct/sharedmemorycapturesink.h>
+#include <sgct/videocapturesink.h>
 #include <sgct/window.h>
 #include <cstring>
 #include <string>
 
-// @TODO (abock, 2019-12-01) This class might want a complete overhaul; right now, there
-// is one instance of this class for each window, and it might be better to replace it
-// with a global version that keeps threads usable by all windows of the application
-
 namespace {
-    void screenCaptureHandler(void* arg) {
-        using SCTI = sgct::ScreenCapture::ScreenCaptureThreadInfo;
-        SCTI* ptr = reinterpret_cast<SCTI*>(arg);
-
-        try {
-            ptr->frameBufferImage->save(ptr->filename);
-        }
-        catch (const std::runtime_error& e) {
-            sgct::Log::Error("%s", e.what());
-        }
-        ptr->isRunning = false;
-    }
-
     GLenum sourceForCaptureSource(sgct::ScreenCapture::CaptureSource source) {
         using Source = sgct::ScreenCapture::CaptureSource;
         switch (source) {
@@ -46,6 +35,17 @@ namespace {
         }
     }
 
+    sgct::CaptureSink::DataType dataTypeForDownloadType(GLenum type) {
+        using DataType = sgct::CaptureSink::DataType;
+        switch (type) {
+            case GL_UNSIGNED_BYTE: return DataType::UInt8;
+            case GL_UNSIGNED_SHORT: return DataType::UInt16;
+            case GL_HALF_FLOAT: return DataType::Float16;
+            case GL_FLOAT: return DataType::Float32;
+            default: throw std::logic_error("Unhandled case label");
+        }
+    }
+
     GLenum getDownloadFormat(int nChannels) {
         switch (nChannels) {
             case 1: return GL_RED;
@@ -60,29 +60,32 @@ namespace {
 namespace sgct {
 
 ScreenCapture::ScreenCapture()
-    : _nThreads(Settings::instance().numberCaptureThreads())
+    : _readbacks(Settings::instance().numberCaptureReadbackBuffers())
 {
     ZoneScoped
 }
 
 ScreenCapture::~ScreenCapture() {
-    for (ScreenCaptureThreadInfo& info : _captureInfos) {
-        // kill threads that are still running
-        if (info.captureThread) {
-            info.captureThread->join();
-            info.captureThread = nullptr;
-        }
-
-        std::unique_lock lock(_mutex);
-        info.frameBufferImage = nullptr;
-        info.isRunning = false;
+    finishAllReadbacks();
+    if (_nStalledFrames > 0) {
+        Log::Debug(
+            "%u captures of window %d had to wait for a readback buffer",
+            _nStalledFrames, _windowIndex
+        );
     }
 
-    glDeleteBuffers(1, &_pbo);
+    for (Readback& readback : _readbacks) {
+        glDeleteBuffers(1, &readback.pbo);
+    }
+    memory::track(memory::Subsystem::Capture, _trackedBytes, 0);
 }
 
 void ScreenCapture::initOrResize(ivec2 resolution, int channels, int bytesPerColor) {
-    glDeleteBuffers(1, &_pbo);
+    // The pending readbacks have to be saved with the size they were captured with
+    finishAllReadbacks();
+    for (Readback& readback : _readbacks) {
+        glDeleteBuffers(1, &readback.pbo);
+    }
 
     _resolution = std::move(resolution);
     _bytesPerColor = bytesPerColor;
@@ -92,27 +95,24 @@ void ScreenCapture::initOrResize(ivec2 resolution, int channels, int bytesPerCol
 
     _downloadFormat = getDownloadFormat(_nChannels);
 
-    std::unique_lock lock(_mutex);
-    for (ScreenCaptureThreadInfo& info : _captureInfos) {
-        if (info.frameBufferImage) {
-            // kill threads that are still running
-            if (info.captureThread) {
-                info.captureThread->join();
-                info.captureThread = nullptr;
-            }
-            info.frameBufferImage = nullptr;
-        }
-        info.isRunning = false;
+    for (Readback& readback : _readbacks) {
+        glGenBuffers(1, &readback.pbo);
+        Log::Debug(
+            "Generating %dx%dx%d PBO: %u",
+            _resolution.x, _resolution.y, _nChannels, readback.pbo
+        );
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, _dataSize, nullptr, GL_STREAM_READ);
     }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    _nextReadback = 0;
 
-    glGenBuffers(1, &_pbo);
-    Log::Debug(
-        "Generating %dx%dx%d PBO: %u", _resolution.x, _resolution.y, _nChannels, _pbo
+    memory::track(
+        memory::Subsystem::Capture,
+        _trackedBytes,
+        static_cast<size_t>(_dataSize) * _readbacks.size()
     );
-
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbo);
-    glBufferData(GL_PIXEL_PACK_BUFFER, _dataSize, nullptr, GL_STATIC_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
 void ScreenCapture::setTextureTransferProperties(GLenum type) {
@@ -122,24 +122,95 @@ void ScreenCapture::setTextureTransferProperties(GLenum type) {
 }
 
 void ScreenCapture::setCaptureFormat(CaptureFormat cf) {
+    if (cf == _format) {
+        return;
+    }
+
+    finishAllReadbacks();
     _format = cf;
+    if (!_hasUserSink) {
+        // The sink for the new format is created with the next captured frame
+        _sink = nullptr;
+        _nextSequence = 0;
+    }
+}
+
+void ScreenCapture::setCaptureSink(std::shared_ptr<CaptureSink> sink) {
+    // The pending frames belong to the previous sink or file format
+    finishAllReadbacks();
+    _hasUserSink = sink != nullptr;
+    _sink = std::move(sink);
+    _nextSequence = 0;
+}
+
+void ScreenCapture::finishRecording() {
+    finishAllReadbacks();
+    // Raw segments continue with the frames of the next recording, but a video stream
+    // can not have gaps, so the next recording is written into a new stream
+    if (!_hasUserSink && _format == CaptureFormat::Video) {
+        _sink = nullptr;
+        _nextSequence = 0;
+    }
 }
 
 void ScreenCapture::saveScreenCapture(unsigned int textureId, CaptureSource capSrc) {
     ZoneScoped
 
-    std::string file = createFilename(Engine::instance().screenShotNumber());
+    const unsigned int frameNumber = Engine::instance().screenShotNumber();
+    // The sinks are created with the first frame so that the capture path and prefix
+    // can still be changed after the window was initialized
+    if (!_sink && _format == CaptureFormat::Raw) {
+        const uint64_t size = Settings::instance().captureSegmentSize();
+        _sink = std::make_shared<CaptureSegmentWriter>(
+            filenamePrefix(),
+            size * 1024 * 1024
+        );
+    }
+    else if (!_sink && _format == CaptureFormat::Video) {
+        const std::string filename = createFilename(frameNumber);
+        std::string command = Settings::instance().captureVideoCommand();
+        // The command gets the file name of the stream without the suffix
+        const std::string name = filename.substr(0, filename.rfind('.'));
+        for (size_t p = command.find("{file}"); p != std::string::npos;
+             p = command.find("{file}", p + name.size()))
+        {
+            command.replace(p, 6, name);
+        }
+        _sink = std::make_shared<VideoCaptureSink>(
+            filename,
+            std::move(command),
+            Settings::instance().captureVideoFrameRate()
+        );
+    }
+    else if (!_sink && _format == CaptureFormat::SharedMemory) {
+        // The name of a shared memory can not contain any further slashes, so it is
+        // not based on the capture path
+        std::string name = '/' + Settings::instance().captureSharedMemoryName() +
+            "_node" + std::to_string(ClusterManager::instance().thisNodeId()) +
+            "_win" + std::to_string(_windowIndex);
+        if (_eyeIndex != EyeIndex::Mono) {
+            name += _eyeIndex == EyeIndex::StereoLeft ? "_L" : "_R";
+        }
+        _sink = std::make_shared<SharedMemoryCaptureSink>(
+            std::move(name),
+            Settings::instance().captureSharedMemorySlots()
+        );
+    }
+    std::string file = _sink ? "" : createFilename(frameNumber);
     checkImageBuffer(capSrc);
-
-    int threadIndex = availableCaptureThread();
-    if (threadIndex == -1) {
-        Log::Error("Error finding available capture thread");
-        return;
+    collectReadbacks();
+
+    Readback& readback = _readbacks[_nextReadback];
+    if (readback.fence) {
+        // All buffers are still in flight, so we have to wait for the oldest one
+        ZoneScopedN("Wait for readback")
+        _nStalledFrames++;
+        TracyPlot("Stalled capture readbacks", static_cast<int64_t>(_nStalledFrames));
+        finishReadback(readback, true);
     }
 
-    Image* imPtr = prepareImage(threadIndex, std::move(file));
     glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
 
     if (capSrc == CaptureSource::Texture) {
         glBindTexture(GL_TEXTURE_2D, textureId);
@@ -148,49 +219,153 @@ void ScreenCapture::saveScreenCapture(unsigned int textureId, CaptureSource capS
     else {
         // set the target framebuffer to read
         glReadBuffer(sourceForCaptureSource(capSrc));
-        const ivec2& s = imPtr->size();
-        const GLsizei w = static_cast<GLsizei>(s.x);
-        const GLsizei h = static_cast<GLsizei>(s.y);
+        const GLsizei w = _resolution.x;
+        const GLsizei h = _resolution.y;
         glReadPixels(0, 0, w, h, _downloadFormat, _downloadType, nullptr);
     }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Make sure that the fence is submitted to the GPU, otherwise polling it in a later
+    // frame might never see it signaled
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    readback.filename = std::move(file);
+    readback.frameNumber = frameNumber;
+    readback.clusterFrameNumber = Engine::instance().clusterFrameNumber();
+    readback.timestamp = Engine::getTime();
+    _nextReadback = (_nextReadback + 1) % _readbacks.size();
+
+    if (_readbacks.size() == 1) {
+        // Without additional buffers there is nothing to gain from waiting
+        finishReadback(readback, true);
+    }
+}
+
+void ScreenCapture::collectReadbacks() {
+    ZoneScoped
+
+    // The readbacks are finished in the order they were issued, starting with the oldest
+    for (size_t i = 0; i < _readbacks.size(); ++i) {
+        Readback& readback = _readbacks[(_nextReadback + i) % _readbacks.size()];
+        if (!finishReadback(readback, false)) {
+            break;
+        }
+    }
+}
+
+unsigned int ScreenCapture::stalledFrames() const {
+    return _nStalledFrames;
+}
+
+bool ScreenCapture::finishReadback(Readback& readback, bool wait) {
+    if (!readback.fence) {
+        return true;
+    }
+
+    GLsync fence = static_cast<GLsync>(readback.fence);
+    if (wait) {
+        constexpr const GLuint64 Timeout = 100000000; // 100 ms
+        GLenum res = GL_TIMEOUT_EXPIRED;
+        while (res == GL_TIMEOUT_EXPIRED) {
+            res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, Timeout);
+        }
+        if (res == GL_WAIT_FAILED) {
+            Log::Error("Failed waiting for frame capture readback");
+        }
+    }
+    else {
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(fence, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED) {
+            return false;
+        }
+    }
+    glDeleteSync(fence);
+    readback.fence = nullptr;
+
+    if (_dataSize == 0) {
+        return true;
+    }
+
+    // Sinks get the data as it was read back, but image files can only store 8-bit
+    // values and 16-bit PNGs, so everything else is converted while it is copied out of
+    // the mapped buffer
+    const bool isConverted = !_sink && (
+        _downloadType == GL_HALF_FLOAT || _downloadType == GL_FLOAT ||
+        (_downloadType == GL_UNSIGNED_SHORT && _format != CaptureFormat::PNG)
+    );
 
+    CaptureService& service = CaptureService::instance();
+    std::unique_ptr<Image> image = service.acquireImage(
+        _resolution,
+        _nChannels,
+        isConverted ? 1 : _bytesPerColor
+    );
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
     unsigned char* ptr = reinterpret_cast<unsigned char*>(
         glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY)
     );
-    if (ptr) {
-        std::memcpy(imPtr->data(), ptr, _dataSize);
-
-        // save the image
-        _captureInfos[threadIndex].isRunning = true;
-        _captureInfos[threadIndex].captureThread = std::make_unique<std::thread>(
-            screenCaptureHandler,
-            &_captureInfos[threadIndex]
-        );
+    const bool isMapped = ptr != nullptr;
+    if (isMapped) {
+        const size_t nValues =
+            static_cast<size_t>(_resolution.x) * _resolution.y * _nChannels;
+        if (!isConverted) {
+            std::memcpy(image->data(), ptr, _dataSize);
+        }
+        else if (_downloadType == GL_UNSIGNED_SHORT) {
+            pixelkernels::uint16ToUInt8(ptr, image->data(), nValues);
+        }
+        else if (_downloadType == GL_HALF_FLOAT) {
+            pixelkernels::halfToUInt8(ptr, image->data(), nValues);
+        }
+        else {
+            pixelkernels::floatToUInt8(ptr, image->data(), nValues);
+        }
         glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
     }
     else {
         Log::Error("Can't map data (0) from GPU in frame capture");
     }
-
     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!isMapped) {
+        return true;
+    }
+
+    // The buffer is unmapped before submitting as the submission might have to wait for
+    // the capture queue
+    if (_sink) {
+        CaptureSink::Frame frame;
+        // The readbacks are finished in the order in which they were captured
+        frame.sequence = _nextSequence++;
+        frame.frameNumber = readback.frameNumber;
+        frame.clusterFrameNumber = readback.clusterFrameNumber;
+        frame.timestamp = readback.timestamp;
+        frame.nodeId = ClusterManager::instance().thisNodeId();
+        frame.windowId = _windowIndex;
+        frame.eye = static_cast<int>(_eyeIndex);
+        frame.dataType = dataTypeForDownloadType(_downloadType);
+        service.submit(std::move(image), _sink, frame);
+    }
+    else {
+        service.submit(std::move(image), std::move(readback.filename));
+    }
+    return true;
+}
+
+void ScreenCapture::finishAllReadbacks() {
+    for (size_t i = 0; i < _readbacks.size(); ++i) {
+        finishReadback(_readbacks[(_nextReadback + i) % _readbacks.size()], true);
+    }
 }
 
 void ScreenCapture::initialize(int windowIndex, ScreenCapture::EyeIndex ei) {
     _eyeIndex = ei;
-
-    _captureInfos.resize(_nThreads);
-    for (unsigned int i = 0; i < _nThreads; i++) {
-        _captureInfos[i].frameBufferImage = nullptr;
-        _captureInfos[i].captureThread = nullptr;
-        _captureInfos[i].mutex = &_mutex;
-        _captureInfos[i].isRunning = false;
-    }
     _windowIndex = windowIndex;
-
-    Log::Debug("Number of screencapture threads is set to %d", _nThreads);
 }
 
-std::string ScreenCapture::createFilename(unsigned int frameNumber) {
+std::string ScreenCapture::filenamePrefix() const {
     const std::string eyeSuffix = [](EyeIndex eyeIndex) {
         switch (eyeIndex) {
             case EyeIndex::Mono:        return "";
@@ -200,19 +375,6 @@ std::string ScreenCapture::createFilename(unsigned int frameNumber) {
         }
     }(_eyeIndex);
 
-    char Buffer[7];
-    std::fill(std::begin(Buffer), std::end(Buffer), '\0');
-    sprintf(Buffer, "%06d", frameNumber);
-
-    const std::string suffix = [](CaptureFormat format) {
-        switch (format) {
-        case CaptureFormat::PNG: return "png";
-        case CaptureFormat::TGA: return "tga";
-        case CaptureFormat::JPEG: return "jpg";
-        default: throw std::logic_error("Unhandled case label");
-        }
-    }(_format);
-
     std::string file;
     if (!Settings::instance().capturePath().empty()) {
         file = Settings::instance().capturePath() + '/';
@@ -237,27 +399,25 @@ std::string ScreenCapture::createFilename(unsigned int frameNumber) {
         file += eyeSuffix + '_';
     }
 
-    return file + std::string(Buffer)  + '.' + suffix;
+    return file;
 }
 
-int ScreenCapture::availableCaptureThread() {
-    while (true) {
-        for (unsigned int i = 0; i < _captureInfos.size(); i++) {
-            // check if thread is dead
-            if (_captureInfos[i].captureThread == nullptr) {
-                return i;
-            }
-
-            if (!_captureInfos[i].isRunning) {
-                _captureInfos[i].captureThread->join();
-                _captureInfos[i].captureThread = nullptr;
+std::string ScreenCapture::createFilename(unsigned int frameNumber) {
+    char Buffer[7];
+    std::fill(std::begin(Buffer), std::end(Buffer), '\0');
+    sprintf(Buffer, "%06d", frameNumber);
 
-                return i;
-            }
+    const std::string suffix = [](CaptureFormat format) {
+        switch (format) {
+        case CaptureFormat::PNG: return "png";
+        case CaptureFormat::TGA: return "tga";
+        case CaptureFormat::JPEG: return "jpg";
+        case CaptureFormat::Video: return "y4m";
+        default: throw std::logic_error("Unhandled case label");
         }
+    }(_format);
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    return filenamePrefix() + std::string(Buffer)  + '.' + suffix;
 }
 
 void ScreenCapture::checkImageBuffer(CaptureSource captureSource) {
@@ -281,23 +441,4 @@ void ScreenCapture::checkImageBuffer(CaptureSource captureSource) {
     }
 }
 
-Image* ScreenCapture::prepareImage(int index, std::string file) {
-    Log::Debug("Starting thread for screenshot/capture [%d]", index);
-
-    if (_captureInfos[index].frameBufferImage == nullptr) {
-        _captureInfos[index].frameBufferImage = std::make_unique<Image>();
-        _captureInfos[index].frameBufferImage->setBytesPerChannel(_bytesPerColor);
-        _captureInfos[index].frameBufferImage->setChannels(_nChannels);
-        _captureInfos[index].frameBufferImage->setSize(_resolution);
-        if (_bytesPerColor * _nChannels * _resolution.x * _resolution.y == 0) {
-            _captureInfos[index].frameBufferImage = nullptr;
-            return nullptr;
-        }
-        _captureInfos[index].frameBufferImage->allocateOrResizeData();
-    }
-    _captureInfos[index].filename = std::move(file);
-
-    return _captureInfos[index].frameBufferImage.get();
-}
-
 } // namespace sgct
@@ -11,6 +11,8 @@
 #include <sgct/config.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
+#include <algorithm>
+#include <filesystem>
 
 namespace sgct {
 
@@ -59,6 +61,18 @@ void Settings::applySettings(const config::Settings& settings) {
             setRefreshRateHint(*settings.display->refreshRate);
         }
     }
+    if (settings.dynamicResolution) {
+        const config::Settings::DynamicResolution& c = *settings.dynamicResolution;
+        DynamicResolution dr;
+        dr.isEnabled = true;
+        dr.targetFrameRate = c.targetFrameRate.value_or(dr.targetFrameRate);
+        dr.minScale = c.minScale.value_or(dr.minScale);
+        dr.maxScale = c.maxScale.value_or(dr.maxScale);
+        dr.step = c.step.value_or(dr.step);
+        dr.hysteresis = c.hysteresis.value_or(dr.hysteresis);
+        dr.frames = c.frames.value_or(dr.frames);
+        setDynamicResolution(dr);
+    }
 }
 
 void Settings::applyCapture(const config::Capture& capture) {
@@ -71,11 +85,81 @@ void Settings::applyCapture(const config::Capture& capture) {
                 case config::Capture::Format::PNG: return CaptureFormat::PNG;
                 case config::Capture::Format::JPG: return CaptureFormat::JPG;
                 case config::Capture::Format::TGA: return CaptureFormat::TGA;
+                case config::Capture::Format::Raw: return CaptureFormat::Raw;
+                case config::Capture::Format::Video: return CaptureFormat::Video;
+                case config::Capture::Format::SharedMemory:
+                    return CaptureFormat::SharedMemory;
                 default:      throw std::logic_error("Unhandled case label");
             }
         }(*capture.format);
         setCaptureFormat(f);
     }
+    if (capture.readbackBuffers) {
+        setNumberOfCaptureReadbackBuffers(*capture.readbackBuffers);
+    }
+    if (capture.queueSize) {
+        setCaptureQueueSize(*capture.queueSize);
+    }
+    if (capture.queuePolicy) {
+        CaptureQueuePolicy p = [](config::Capture::QueuePolicy policy) {
+            using QueuePolicy = config::Capture::QueuePolicy;
+            switch (policy) {
+                case QueuePolicy::Block: return CaptureQueuePolicy::Block;
+                case QueuePolicy::Drop: return CaptureQueuePolicy::Drop;
+                case QueuePolicy::Grow: return CaptureQueuePolicy::Grow;
+                default: throw std::logic_error("Unhandled case label");
+            }
+        }(*capture.queuePolicy);
+        setCaptureQueuePolicy(p);
+    }
+    if (capture.segmentSize) {
+        setCaptureSegmentSize(*capture.segmentSize);
+    }
+    if (capture.videoCommand) {
+        setCaptureVideoCommand(*capture.videoCommand);
+    }
+    if (capture.videoFrameRate) {
+        setCaptureVideoFrameRate(*capture.videoFrameRate);
+    }
+    if (capture.sharedMemoryName) {
+        setCaptureSharedMemoryName(*capture.sharedMemoryName);
+    }
+    if (capture.sharedMemorySlots) {
+        setCaptureSharedMemorySlots(*capture.sharedMemorySlots);
+    }
+    if (capture.pngCompression) {
+        setPngCompressionLevel(*capture.pngCompression);
+    }
+    if (capture.pngFilter) {
+        PngFilter f = [](config::Capture::PngFilter filter) {
+            using Filter = config::Capture::PngFilter;
+            switch (filter) {
+                case Filter::None: return PngFilter::None;
+                case Filter::Sub: return PngFilter::Sub;
+                case Filter::Up: return PngFilter::Up;
+                case Filter::Average: return PngFilter::Average;
+                case Filter::Paeth: return PngFilter::Paeth;
+                case Filter::Adaptive: return PngFilter::Adaptive;
+                default: throw std::logic_error("Unhandled case label");
+            }
+        }(*capture.pngFilter);
+        setPngFilter(f);
+    }
+    if (capture.jpegQuality) {
+        setJpegQuality(*capture.jpegQuality);
+    }
+    if (capture.jpegSubsampling) {
+        JpegSubsampling s = [](config::Capture::JpegSubsampling subsampling) {
+            using Subsampling = config::Capture::JpegSubsampling;
+            switch (subsampling) {
+                case Subsampling::Chroma444: return JpegSubsampling::Chroma444;
+                case Subsampling::Chroma422: return JpegSubsampling::Chroma422;
+                case Subsampling::Chroma420: return JpegSubsampling::Chroma420;
+                default: throw std::logic_error("Unhandled case label");
+            }
+        }(*capture.jpegSubsampling);
+        setJpegSubsampling(s);
+    }
 }
 
 void Settings::setSwapInterval(int val) {
@@ -110,6 +194,18 @@ void Settings::setBufferFloatPrecision(BufferFloatPrecision bfp) {
     _bufferFloatPrecision = bfp;
 }
 
+void Settings::setDynamicResolution(DynamicResolution dynamicResolution) {
+    if (dynamicResolution.minScale > dynamicResolution.maxScale) {
+        Log::Error("Dynamic resolution minimum scale must not exceed maximum scale");
+        return;
+    }
+    _dynamicResolution = dynamicResolution;
+}
+
+const Settings::DynamicResolution& Settings::dynamicResolution() const {
+    return _dynamicResolution;
+}
+
 void Settings::setNumberOfCaptureThreads(int count) {
     if (count <= 0) {
         Log::Error("Only positive number of capture threads allowed");
@@ -135,6 +231,137 @@ int Settings::numberCaptureThreads() const {
     return _nCaptureThreads;
 }
 
+void Settings::setNumberOfCaptureReadbackBuffers(int count) {
+    if (count <= 0) {
+        Log::Error("Only positive number of capture readback buffers allowed");
+    }
+    else {
+        _nCaptureReadbackBuffers = count;
+    }
+}
+
+int Settings::numberCaptureReadbackBuffers() const {
+    return _nCaptureReadbackBuffers;
+}
+
+void Settings::setCaptureQueueSize(int size) {
+    if (size <= 0) {
+        Log::Error("Only positive capture queue sizes allowed");
+    }
+    else {
+        _captureQueueSize = size;
+    }
+}
+
+int Settings::captureQueueSize() const {
+    return _captureQueueSize;
+}
+
+void Settings::setCaptureSegmentSize(int size) {
+    if (size <= 0) {
+        Log::Error("Only positive capture segment sizes allowed");
+    }
+    else {
+        _captureSegmentSize = size;
+    }
+}
+
+int Settings::captureSegmentSize() const {
+    return _captureSegmentSize;
+}
+
+void Settings::setCaptureVideoCommand(std::string command) {
+    _captureVideoCommand = std::move(command);
+}
+
+const std::string& Settings::captureVideoCommand() const {
+    return _captureVideoCommand;
+}
+
+void Settings::setCaptureVideoFrameRate(float frameRate) {
+    if (frameRate <= 0.f) {
+        Log::Error("Only positive video capture frame rates allowed");
+    }
+    else {
+        _captureVideoFrameRate = frameRate;
+    }
+}
+
+float Settings::captureVideoFrameRate() const {
+    return _captureVideoFrameRate;
+}
+
+void Settings::setCaptureSharedMemoryName(std::string name) {
+    _captureSharedMemoryName = std::move(name);
+}
+
+const std::string& Settings::captureSharedMemoryName() const {
+    return _captureSharedMemoryName;
+}
+
+void Settings::setCaptureSharedMemorySlots(int slots) {
+    if (slots <= 0) {
+        Log::Error("Only positive numbers of shared memory capture slots allowed");
+    }
+    else {
+        _captureSharedMemorySlots = slots;
+    }
+}
+
+int Settings::captureSharedMemorySlots() const {
+    return _captureSharedMemorySlots;
+}
+
+void Settings::setCaptureQueuePolicy(CaptureQueuePolicy policy) {
+    _captureQueuePolicy = policy;
+}
+
+Settings::CaptureQueuePolicy Settings::captureQueuePolicy() const {
+    return _captureQueuePolicy;
+}
+
+void Settings::setPngCompressionLevel(int level) {
+    if (level < -1 || level > 9) {
+        Log::Error("PNG compression level must be in the range [-1, 9]");
+    }
+    else {
+        _pngCompressionLevel = level;
+    }
+}
+
+int Settings::pngCompressionLevel() const {
+    return _pngCompressionLevel;
+}
+
+void Settings::setPngFilter(PngFilter filter) {
+    _pngFilter = filter;
+}
+
+Settings::PngFilter Settings::pngFilter() const {
+    return _pngFilter;
+}
+
+void Settings::setJpegQuality(int quality) {
+    if (quality < 1 || quality > 100) {
+        Log::Error("JPEG quality must be in the range [1, 100]");
+    }
+    else {
+        _jpegQuality = quality;
+    }
+}
+
+int Settings::jpegQuality() const {
+    return _jpegQuality;
+}
+
+void Settings::setJpegSubsampling(JpegSubsampling subsampling) {
+    _jpegSubsampling = subsampling;
+}
+
+Settings::JpegSubsampling Settings::jpegSubsampling() const {
+    return _jpegSubsampling;
+}
+
 Settings::DrawBufferType Settings::drawBufferType() const {
     if (_usePositionTexture) {
         if (_useNormalTexture) {
@@ -182,6 +409,18 @@ void Settings::setExportWarpingMeshes(bool state) {
     _exportWarpingMeshes = state;
 }
 
+void Settings::setUseWarpingMeshCache(bool state) {
+    _useWarpingMeshCache = state;
+}
+
+void Settings::setWarpingMeshCachePath(std::string path) {
+    _warpingMeshCachePath = std::move(path);
+}
+
+void Settings::setWarpingMeshTolerance(float pixels) {
+    _warpingMeshTolerance = std::max(pixels, 0.f);
+}
+
 void Settings::setAddNodeNameToScreenshot(bool state) {
     _screenshot.addNodeName = state;
 }
@@ -194,6 +433,22 @@ bool Settings::exportWarpingMeshes() const {
     return _exportWarpingMeshes;
 }
 
+std::string Settings::warpingMeshCachePath() const {
+    if (!_useWarpingMeshCache) {
+        return "";
+    }
+    if (_warpingMeshCachePath.empty()) {
+        std::error_code ec;
+        const std::filesystem::path tmp = std::filesystem::temp_directory_path(ec);
+        return ec ? "" : (tmp / "sgct-mesh-cache").string();
+    }
+    return _warpingMeshCachePath;
+}
+
+float Settings::warpingMeshTolerance() const {
+    return _warpingMeshTolerance;
+}
+
 bool Settings::captureFromBackBuffer() const {
     return _captureBackBuffer;
 }
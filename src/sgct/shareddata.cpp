@@ -9,6 +9,7 @@
 #include <sgct/shareddata.h>
 
 #include <sgct/log.h>
+#include <sgct/memory.h>
 #include <sgct/profiling.h>
 #include <zlib.h>
 #include <cstring>
@@ -38,6 +39,12 @@ SharedData::SharedData() {
     // fill rest of header with Network::DefaultId
     std::memset(_headerSpace.data(), Network::DefaultId, Network::HeaderSize);
     _headerSpace[0] = std::byte { Network::DataId };
+
+    memory::track(memory::Subsystem::SharedData, _trackedBytes, _dataBlock.capacity());
+}
+
+SharedData::~SharedData() {
+    memory::track(memory::Subsystem::SharedData, _trackedBytes, 0);
 }
 
 void SharedData::setEncodeFunction(std::function<std::vector<std::byte>()> function) {
@@ -50,6 +57,18 @@ void SharedData::setDecodeFunction(
     _decodeFn = std::move(function);
 }
 
+void SharedData::setInternalEncodeFunction(
+                                  std::function<void(std::vector<std::byte>&)> function)
+{
+    _internalEncodeFn = std::move(function);
+}
+
+void SharedData::setInternalDecodeFunction(
+                std::function<void(const std::vector<std::byte>&, unsigned int)> function)
+{
+    _internalDecodeFn = std::move(function);
+}
+
 void SharedData::decode(const char* receivedData, int receivedLength) {
     ZoneScoped
 
@@ -67,15 +86,38 @@ void SharedData::decode(const char* receivedData, int receivedLength) {
             reinterpret_cast<const std::byte*>(receivedData),
             reinterpret_cast<const std::byte*>(receivedData) + receivedLength
         );
+        memory::track(
+            memory::Subsystem::SharedData,
+            _trackedBytes,
+            _dataBlock.capacity()
+        );
     }
 
+    if (receivedLength < static_cast<int>(sizeof(uint32_t))) {
+        Log::Error("Received synchronization data without an SGCT state block");
+        return;
+    }
+
+    std::vector<std::byte> data;
+    data.assign(
+        reinterpret_cast<const std::byte*>(receivedData),
+        reinterpret_cast<const std::byte*>(receivedData) + receivedLength
+    );
+
+    unsigned int pos = 0;
+    uint32_t internalSize = 0;
+    deserializeObject(data, pos, internalSize);
+    if (pos + internalSize > data.size()) {
+        Log::Error("Received synchronization data with a corrupt SGCT state block");
+        return;
+    }
+    if (_internalDecodeFn && internalSize > 0) {
+        _internalDecodeFn(data, pos);
+    }
+    pos += internalSize;
+
     if (_decodeFn) {
-        std::vector<std::byte> data;
-        data.assign(
-            reinterpret_cast<const std::byte*>(receivedData),
-            reinterpret_cast<const std::byte*>(receivedData) + receivedLength
-        );
-        _decodeFn(data, 0u);
+        _decodeFn(data, pos);
     }
 }
 
@@ -93,10 +135,18 @@ void SharedData::encode() {
         );
     }
 
+    // SGCT's own state is always sent, length-prefixed, in front of the user data
+    _internalBlock.clear();
+    if (_internalEncodeFn) {
+        _internalEncodeFn(_internalBlock);
+    }
+    serializeObject(_dataBlock, _internalBlock);
+
     if (_encodeFn) {
         std::vector<std::byte> data = _encodeFn();
         _dataBlock.insert(_dataBlock.end(), data.begin(), data.end());
     }
+    memory::track(memory::Subsystem::SharedData, _trackedBytes, _dataBlock.capacity());
 }
 
 unsigned char* SharedData::dataBlock() {
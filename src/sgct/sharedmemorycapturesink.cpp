@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/sharedmemorycapturesink.h>
+
+#include <sgct/error.h>
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // WIN32
+
+#define Err(code, msg) sgct::Error(sgct::Error::Component::Image, code, msg)
+
+namespace {
+    std::string semaphoreName(const std::string& name) {
+        return name + "_ready";
+    }
+} // namespace
+
+namespace sgct {
+
+SharedMemoryCaptureSink::SharedMemoryCaptureSink(std::string name, int nSlots)
+    : _name(std::move(name))
+    , _nSlots(static_cast<uint32_t>(std::max(nSlots, 1)))
+    , _slotSequences(_nSlots, 0)
+    , _isWriting(_nSlots, false)
+{}
+
+SharedMemoryCaptureSink::~SharedMemoryCaptureSink() {
+    if (_nSkippedFrames > 0) {
+        Log::Warning(
+            "%u frames were not published to shared memory '%s'",
+            _nSkippedFrames, _name.c_str()
+        );
+    }
+
+#ifndef WIN32
+    if (_semaphore) {
+        sem_close(static_cast<sem_t*>(_semaphore));
+        sem_unlink(semaphoreName(_name).c_str());
+    }
+    if (_memory) {
+        // Consumers that still have the memory mapped can continue to read from it
+        munmap(_memory, _memorySize);
+        shm_unlink(_name.c_str());
+        Log::Info("Finished shared memory capture '%s'", _name.c_str());
+    }
+#endif // WIN32
+}
+
+void SharedMemoryCaptureSink::write(const Image& image, const Frame& frame) {
+    ZoneScoped
+
+    using namespace shmcapture;
+
+    const uint64_t dataSize = static_cast<uint64_t>(image.size().x) * image.size().y *
+        image.channels() * image.bytesPerChannel();
+    const uint32_t slot = static_cast<uint32_t>(frame.sequence % _nSlots);
+
+    SlotHeader* header = nullptr;
+    {
+        std::unique_lock lock(_mutex);
+        if (!_memory && !_hasFailed) {
+            try {
+                open(dataSize);
+            }
+            catch (const std::runtime_error& e) {
+                Log::Error("%s", e.what());
+                _hasFailed = true;
+            }
+        }
+        if (_hasFailed) {
+            return;
+        }
+
+        // A slot is only written by one thread at a time and a newer frame is never
+        // replaced by an older one that was delayed on another capture thread
+        const bool fits = SlotHeaderSize + dataSize <= _slotSize;
+        if (!fits || _isWriting[slot] || _slotSequences[slot] > frame.sequence) {
+            _nSkippedFrames++;
+            return;
+        }
+        _isWriting[slot] = true;
+        header = reinterpret_cast<SlotHeader*>(_memory + BlockSize + slot * _slotSize);
+    }
+
+    // The slot is marked as invalid until the frame is completely written
+    header->state.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->frameNumber = frame.frameNumber;
+    header->clusterFrameNumber = frame.clusterFrameNumber;
+    header->timestamp = frame.timestamp;
+    header->nodeId = frame.nodeId;
+    header->windowId = frame.windowId;
+    header->eye = frame.eye;
+    header->width = image.size().x;
+    header->height = image.size().y;
+    header->channels = image.channels();
+    header->dataType = frame.dataType;
+    header->dataSize = dataSize;
+    unsigned char* data = reinterpret_cast<unsigned char*>(header) + SlotHeaderSize;
+    {
+        ZoneScopedN("Copy frame")
+        std::memcpy(data, image.data(), dataSize);
+    }
+    header->state.store(frame.sequence + 1, std::memory_order_release);
+
+    {
+        std::unique_lock lock(_mutex);
+        _isWriting[slot] = false;
+        _slotSequences[slot] = frame.sequence + 1;
+
+        RingHeader* ring = reinterpret_cast<RingHeader*>(_memory);
+        const uint64_t nPublished = ring->nPublished.load(std::memory_order_relaxed);
+        if (frame.sequence + 1 > nPublished) {
+            ring->nPublished.store(frame.sequence + 1, std::memory_order_release);
+        }
+    }
+
+#ifndef WIN32
+    sem_post(static_cast<sem_t*>(_semaphore));
+#endif // WIN32
+}
+
+void SharedMemoryCaptureSink::open([[maybe_unused]] uint64_t dataSize) {
+    ZoneScoped
+
+#ifdef WIN32
+    throw Err(9018, "Shared memory capture is not supported on Windows");
+#else // WIN32
+    using namespace shmcapture;
+
+    // Every slot is padded so that the pixel data of all slots has the same alignment
+    const uint64_t slotSize =
+        (SlotHeaderSize + dataSize + BlockSize - 1) / BlockSize * BlockSize;
+    const size_t size = BlockSize + slotSize * _nSlots;
+
+    // Memory that is left over from an earlier run that did not shut down is replaced
+    shm_unlink(_name.c_str());
+    const int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw Err(9018, "Could not create shared memory '" + _name + "'");
+    }
+    const bool hasSize = ftruncate(fd, static_cast<off_t>(size)) == 0;
+    void* memory = hasSize ?
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) :
+        MAP_FAILED;
+    close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(_name.c_str());
+        throw Err(9018, "Could not create shared memory '" + _name + "'");
+    }
+    _memory = static_cast<unsigned char*>(memory);
+    _memorySize = size;
+    _slotSize = slotSize;
+
+    const std::string semName = semaphoreName(_name);
+    sem_unlink(semName.c_str());
+    sem_t* semaphore = sem_open(semName.c_str(), O_CREAT | O_EXCL, 0644, 0);
+    if (semaphore == SEM_FAILED) {
+        throw Err(9019, "Could not create semaphore '" + semName + "'");
+    }
+    _semaphore = semaphore;
+
+    for (uint32_t i = 0; i < _nSlots; ++i) {
+        new (_memory + BlockSize + i * _slotSize) SlotHeader();
+    }
+    RingHeader* ring = new (_memory) RingHeader();
+    ring->version = Version;
+    ring->nSlots = _nSlots;
+    ring->slotSize = _slotSize;
+    // Consumers only use the header once the magic is valid
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(ring->magic, Magic, sizeof(Magic));
+
+    Log::Info(
+        "Starting shared memory capture '%s' with %u slots of %llu bytes",
+        _name.c_str(), _nSlots, static_cast<unsigned long long>(_slotSize)
+    );
+#endif // WIN32
+}
+
+} // namespace sgct
@@ -10,6 +10,7 @@
 
 #include <sgct/image.h>
 #include <sgct/log.h>
+#include <sgct/memory.h>
 #include <sgct/opengl.h>
 #include <algorithm>
 
@@ -44,13 +45,25 @@ namespace {
             GL_TEXTURE_2D,
             0,
             internalFormat,
-            static_cast<GLsizei>(img.size().x),
-            static_cast<GLsizei>(img.size().y),
+            img.size().x,
+            img.size().y,
             0,
             type,
             format,
             img.data()
         );
+
+        size_t bytes = sgct::memory::estimateImageBytes(
+            internalFormat,
+            img.size().x,
+            img.size().y
+        );
+        if (mipmap > 1) {
+            // The full mipmap chain adds roughly a third on top of the base level
+            bytes += bytes / 3;
+        }
+        sgct::memory::trackTexture(sgct::memory::Subsystem::Texture, tex, bytes);
+
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmap - 1);
 
@@ -110,6 +123,9 @@ void TextureManager::destroy() {
 }
 
 TextureManager::~TextureManager() {
+    for (unsigned int t : _textures) {
+        memory::untrackTexture(t);
+    }
     glDeleteTextures(static_cast<GLsizei>(_textures.size()), _textures.data());
 }
 
@@ -120,15 +136,24 @@ unsigned int TextureManager::loadTexture(const std::string& filename, bool inter
     Image img;
     img.load(filename);
 
-    if (img.data() == nullptr) {
+    const unsigned int t =
+        loadTexture(img, interpolate, anisotropicFilterSize, mipmapLevels);
+    if (t != 0) {
+        Log::Debug("Texture created from '%s' [id=%d]", filename.c_str(), t);
+    }
+    return t;
+}
+
+unsigned int TextureManager::loadTexture(const Image& image, bool interpolate,
+                                         float anisotropicFilterSize, int mipmapLevels)
+{
+    if (image.data() == nullptr) {
         // image data not valid
         return 0;
     }
 
-    GLuint t = uploadImage(img, interpolate, mipmapLevels, anisotropicFilterSize);
+    GLuint t = uploadImage(image, interpolate, mipmapLevels, anisotropicFilterSize);
     _textures.push_back(t);
-
-    Log::Debug("Texture created from '%s' [id=%d]", filename.c_str(), t);
     return t;
 }
 
@@ -138,6 +163,7 @@ void TextureManager::removeTexture(unsigned int textureId) {
         _textures.end()
     );
 
+    memory::untrackTexture(textureId);
     glDeleteTextures(1, &textureId);
 }
 
@@ -0,0 +1,253 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/videocapturesink.h>
+
+#include <sgct/error.h>
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/pixelkernels.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cmath>
+
+#ifndef WIN32
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#endif // WIN32
+
+#define Err(code, msg) sgct::Error(sgct::Error::Component::Image, code, msg)
+
+#ifndef WIN32
+namespace {
+    // Blocks SIGPIPE for the calling thread while it writes to the encoder. Without
+    // this, an encoder that exits early would terminate the application with the next
+    // frame that is written to its input. A SIGPIPE that was raised by these writes is
+    // consumed before the signal is unblocked again, so the write only fails with EPIPE
+    // and the signal handling of the rest of the application is left untouched
+    class SigPipeBlock {
+    public:
+        SigPipeBlock() {
+            sigemptyset(&_set);
+            sigaddset(&_set, SIGPIPE);
+
+            sigset_t pending;
+            sigpending(&pending);
+            _wasPending = sigismember(&pending, SIGPIPE) == 1;
+            pthread_sigmask(SIG_BLOCK, &_set, &_previous);
+        }
+
+        ~SigPipeBlock() {
+            if (!_wasPending) {
+                sigset_t pending;
+                sigpending(&pending);
+                if (sigismember(&pending, SIGPIPE) == 1) {
+                    const timespec noWait = { 0, 0 };
+                    while (sigtimedwait(&_set, nullptr, &noWait) == -1 && errno == EINTR)
+                    {}
+                }
+            }
+            pthread_sigmask(SIG_SETMASK, &_previous, nullptr);
+        }
+
+    private:
+        sigset_t _set;
+        sigset_t _previous;
+        bool _wasPending = false;
+    };
+} // namespace
+#endif // WIN32
+
+namespace sgct {
+
+VideoCaptureSink::VideoCaptureSink(std::string filename, std::string command,
+                                   float frameRate)
+    : _filename(std::move(filename))
+    , _command(std::move(command))
+    , _frameRate(frameRate)
+{}
+
+VideoCaptureSink::~VideoCaptureSink() {
+    const std::string& name = _command.empty() ? _filename : _command;
+    if (_nRepeatedFrames > 0) {
+        Log::Warning(
+            "%u frames of video capture '%s' were replaced by the previous frame",
+            _nRepeatedFrames, name.c_str()
+        );
+    }
+
+    if (!_file) {
+        return;
+    }
+
+    if (_isPipe) {
+#ifdef WIN32
+        const int res = _pclose(_file);
+#else // WIN32
+        // Closing flushes the frames that are still buffered
+        SigPipeBlock block;
+        const int res = pclose(_file);
+#endif // WIN32
+        if (res != 0) {
+            Log::Warning("Video capture command exited with status %d", res);
+        }
+        else {
+            Log::Info("Finished video capture to '%s'", name.c_str());
+        }
+    }
+    else {
+        fclose(_file);
+        Log::Info("Finished video capture '%s'", name.c_str());
+    }
+}
+
+void VideoCaptureSink::write(const Image& image, const Frame& frame) {
+    ZoneScoped
+
+    const bool isSupported =
+        frame.dataType == DataType::UInt8 && image.bytesPerChannel() == 1 &&
+        image.channels() >= 3;
+
+    std::vector<unsigned char> yuv;
+    {
+        std::unique_lock lock(_mutex);
+        if (!_freeBuffers.empty()) {
+            yuv = std::move(_freeBuffers.back());
+            _freeBuffers.pop_back();
+        }
+    }
+    // The conversion does not depend on the other frames, so it runs in parallel
+    if (isSupported) {
+        const ivec2 size = image.size();
+        yuv.resize(pixelkernels::i420Size(size.x, size.y));
+        const int channels = image.channels();
+        pixelkernels::bgrToI420(image.data(), size.x, size.y, channels, yuv.data());
+    }
+
+    std::unique_lock lock(_mutex);
+    {
+        ZoneScopedN("Wait for previous frames")
+        _frameWritten.wait(lock, [&]() { return frame.sequence <= _nextSequence; });
+    }
+
+    if (!isSupported) {
+        if (!_hasFailed) {
+            Log::Error("Video capture only supports 8-bit images with 3 or 4 channels");
+        }
+        _hasFailed = true;
+    }
+    else if (!_file && !_hasFailed) {
+        try {
+            open(image.size());
+        }
+        catch (const std::runtime_error& e) {
+            Log::Error("%s", e.what());
+            _hasFailed = true;
+        }
+    }
+
+    if (isSupported && image.size().x == _size.x && image.size().y == _size.y) {
+        writeFrame(yuv);
+        std::swap(_lastFrame, yuv);
+    }
+    else if (!_hasFailed && !_lastFrame.empty()) {
+        // The stream has a fixed size, so a frame with a different size is replaced
+        writeFrame(_lastFrame);
+        _nRepeatedFrames++;
+    }
+    _freeBuffers.push_back(std::move(yuv));
+
+    _nextSequence = std::max(_nextSequence, frame.sequence + 1);
+    writeDroppedFrames();
+    lock.unlock();
+    _frameWritten.notify_all();
+}
+
+void VideoCaptureSink::drop(const Frame& frame) {
+    {
+        std::unique_lock lock(_mutex);
+        _droppedFrames.insert(frame.sequence);
+        writeDroppedFrames();
+    }
+    _frameWritten.notify_all();
+}
+
+void VideoCaptureSink::open(ivec2 size) {
+    ZoneScoped
+
+    if (_command.empty()) {
+        _file = fopen(_filename.c_str(), "wb");
+        if (!_file) {
+            throw Err(9016, "Could not open video stream '" + _filename + "'");
+        }
+        Log::Info("Starting video capture '%s'", _filename.c_str());
+    }
+    else {
+#ifdef WIN32
+        _file = _popen(_command.c_str(), "wb");
+#else // WIN32
+        _file = popen(_command.c_str(), "w");
+#endif // WIN32
+        if (!_file) {
+            throw Err(9016, "Could not open video stream '" + _command + "'");
+        }
+        _isPipe = true;
+        Log::Info("Starting video capture to '%s'", _command.c_str());
+    }
+    _size = size;
+
+    // The frame rate is stored as a fraction to support rates like 29.97
+    const int rate = static_cast<int>(std::round(_frameRate * 1000.f));
+    const std::string header =
+        "YUV4MPEG2 W" + std::to_string(_size.x) + " H" + std::to_string(_size.y) +
+        " F" + std::to_string(rate) + ":1000 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+#ifndef WIN32
+    SigPipeBlock block;
+#endif // WIN32
+    if (fwrite(header.data(), 1, header.size(), _file) != header.size()) {
+        throw Err(9017, "Could not write to video stream '" + _filename + "'");
+    }
+}
+
+void VideoCaptureSink::writeFrame(const std::vector<unsigned char>& yuv) {
+    ZoneScoped
+
+    if (_hasFailed || !_file || yuv.empty()) {
+        return;
+    }
+
+    constexpr const char FrameHeader[] = "FRAME\n";
+    constexpr const size_t HeaderSize = sizeof(FrameHeader) - 1;
+#ifndef WIN32
+    SigPipeBlock block;
+#endif // WIN32
+    const bool success =
+        fwrite(FrameHeader, 1, HeaderSize, _file) == HeaderSize &&
+        fwrite(yuv.data(), 1, yuv.size(), _file) == yuv.size();
+    if (!success) {
+        const std::string& name = _isPipe ? _command : _filename;
+        Log::Error("Could not write to video stream '%s'", name.c_str());
+        _hasFailed = true;
+    }
+}
+
+void VideoCaptureSink::writeDroppedFrames() {
+    auto it = _droppedFrames.find(_nextSequence);
+    while (it != _droppedFrames.end()) {
+        if (!_lastFrame.empty()) {
+            writeFrame(_lastFrame);
+            _nRepeatedFrames++;
+        }
+        _droppedFrames.erase(it);
+        _nextSequence++;
+        it = _droppedFrames.find(_nextSequence);
+    }
+}
+
+} // namespace sgct
@@ -10,6 +10,8 @@
 
 #include <sgct/clustermanager.h>
 #include <sgct/config.h>
+#include <sgct/engine.h>
+#include <sgct/image.h>
 #include <sgct/log.h>
 #include <sgct/profiling.h>
 #include <sgct/readconfig.h>
@@ -30,12 +32,18 @@ namespace {
     // Helper structs for the visitor pattern of the std::variant on projections
     template <class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
     template <class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
+
+    // The MPCDI warping mesh is not read from a file, but the extension of this name
+    // selects the MPCDI loader
+    constexpr const char* MpcdiMeshName = "mesh.mpcdi";
 } // namespace
 
 namespace sgct {
 
 Viewport::Viewport(const Window* parent) : BaseViewport(parent) {}
 
+Viewport::~Viewport() = default;
+
 void Viewport::initialize(vec2 size, bool hasStereo, unsigned int internalFormat,
                           unsigned int format, unsigned int type, int samples)
 {
@@ -64,6 +72,9 @@ void Viewport::applyViewport(const config::Viewport& viewport) {
     if (viewport.correctionMeshTexture) {
         _meshFilename = *viewport.correctionMeshTexture;
     }
+    if (viewport.useWarpMap) {
+        _useWarpMap = *viewport.useWarpMap;
+    }
     if (viewport.isTracked) {
         _isTracked = *viewport.isTracked;
     }
@@ -298,41 +309,92 @@ void Viewport::applySphericalMirrorProjection(const config::SphericalMirrorProje
     _nonLinearProjection = std::move(proj);
 }
 
-void Viewport::setMpcdiWarpMesh(std::vector<char> data) {
-    _mpcdiWarpMesh = std::move(data);
+void Viewport::setMpcdiWarpMesh(correction::Buffer mesh) {
+    _mpcdiWarpMesh = std::move(mesh);
+    _meshFilename = MpcdiMeshName;
+}
+
+std::vector<std::string> Viewport::dataFiles() const {
+    std::vector<std::string> res;
+    for (const std::string& file : { _overlayFilename, _blendMaskFilename,
+                                     _blackLevelMaskFilename, _meshFilename })
+    {
+        if (!file.empty() && file != MpcdiMeshName) {
+            res.push_back(file);
+        }
+    }
+    return res;
+}
+
+void Viewport::readData(const CorrectionMesh::WindowState& window) {
+    ZoneScoped
+
+    auto loadImage = [](const std::string& filename) -> std::unique_ptr<Image> {
+        if (filename.empty()) {
+            return nullptr;
+        }
+        auto image = std::make_unique<Image>();
+        image->load(filename);
+        return image;
+    };
+
+    const double t0 = Engine::getTime();
+    _overlayImage = loadImage(_overlayFilename);
+    _blendMaskImage = loadImage(_blendMaskFilename);
+    _blackLevelMaskImage = loadImage(_blackLevelMaskFilename);
+    const double t1 = Engine::getTime();
+    if (!_isDataLoaded || _meshFilename != MpcdiMeshName) {
+        _mesh.readMesh(_meshFilename, *this, window, _useWarpMap);
+    }
+    const double t2 = Engine::getTime();
+
+    Log::Debug(
+        "Viewport data read. Masks: %.1f ms, Correction mesh '%s': %.1f ms",
+        (t1 - t0) * 1000.0, _meshFilename.c_str(), (t2 - t1) * 1000.0
+    );
 }
 
 void Viewport::loadData() {
     ZoneScoped
 
     TextureManager& mgr = TextureManager::instance();
-    if (!_overlayFilename.empty()) {
-        _overlayTextureIndex = mgr.loadTexture(_overlayFilename, true, 1);
-    }
-
-    if (!_blendMaskFilename.empty()) {
-        _blendMaskTextureIndex = mgr.loadTexture(_blendMaskFilename, true, 1);
-    }
+    auto loadTexture = [&mgr](unsigned int& texture, std::unique_ptr<Image>& image,
+                              const std::string& filename)
+    {
+        if (filename.empty()) {
+            return;
+        }
+        const unsigned int tex = image ?
+            mgr.loadTexture(*image, true, 1) :
+            mgr.loadTexture(filename, true, 1);
+        image = nullptr;
+        // The data is loaded again if the files have changed while running
+        if (texture != 0) {
+            mgr.removeTexture(texture);
+        }
+        texture = tex;
+    };
+    loadTexture(_overlayTextureIndex, _overlayImage, _overlayFilename);
+    loadTexture(_blendMaskTextureIndex, _blendMaskImage, _blendMaskFilename);
+    loadTexture(
+        _blackLevelMaskTextureIndex,
+        _blackLevelMaskImage,
+        _blackLevelMaskFilename
+    );
 
-    if (!_blackLevelMaskFilename.empty()) {
-        _blackLevelMaskTextureIndex = mgr.loadTexture(_blackLevelMaskFilename, true, 1);
+    // The MPCDI mesh is released after it was uploaded, so it is kept when reloading
+    if (_isDataLoaded && _meshFilename == MpcdiMeshName) {
+        return;
     }
 
-    if (!_mpcdiWarpMesh.empty()) {
-        _mesh.loadMesh(
-            "mesh.mpcdi",
-            *this,
-            hasBlendMaskTexture() || hasBlackLevelMaskTexture()
-        );
-    }
-    else {
-        // load default if _meshFilename is empty
-        _mesh.loadMesh(
-            _meshFilename,
-            *this,
-            hasBlendMaskTexture() || hasBlackLevelMaskTexture()
-        );
-    }
+    // load default if _meshFilename is empty
+    _mesh.loadMesh(
+        _meshFilename,
+        *this,
+        hasBlendMaskTexture() || hasBlackLevelMaskTexture(),
+        _useWarpMap
+    );
+    _isDataLoaded = true;
 }
 
 void Viewport::renderQuadMesh() const {
@@ -359,6 +421,14 @@ void Viewport::renderMaskMesh() const {
     }
 }
 
+void Viewport::renderWarpMap() const {
+    ZoneScoped
+
+    if (_isEnabled) {
+        _mesh.renderWarpMap();
+    }
+}
+
 bool Viewport::hasOverlayTexture() const {
     return _overlayTextureIndex != 0;
 }
@@ -371,6 +441,10 @@ bool Viewport::hasBlackLevelMaskTexture() const {
     return _blackLevelMaskTextureIndex != 0;
 }
 
+bool Viewport::hasWarpMap() const {
+    return _mesh.hasWarpMap();
+}
+
 bool Viewport::hasSubViewports() const {
     return _nonLinearProjection != nullptr;
 }
@@ -395,8 +469,10 @@ NonLinearProjection* Viewport::nonLinearProjection() const {
     return _nonLinearProjection.get();
 }
 
-const std::vector<char>& Viewport::mpcdiWarpMesh() const {
-    return _mpcdiWarpMesh;
+std::optional<correction::Buffer> Viewport::takeMpcdiWarpMesh() {
+    std::optional<correction::Buffer> mesh = std::move(_mpcdiWarpMesh);
+    _mpcdiWarpMesh = std::nullopt;
+    return mesh;
 }
 
 } // namespace sgct
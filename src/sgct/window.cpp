@@ -14,6 +14,7 @@
 #include <sgct/error.h>
 #include <sgct/internalshaders.h>
 #include <sgct/log.h>
+#include <sgct/memory.h>
 #include <sgct/mpcdi.h>
 #include <sgct/networkmanager.h>
 #include <sgct/node.h>
@@ -26,6 +27,7 @@
 #include <sgct/projection/nonlinearprojection.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <algorithm>
+#include <cmath>
 
 #ifdef WIN32
 #define NOMINMAX
@@ -63,6 +65,13 @@ namespace {
         }
     }
 
+    sgct::ivec2 scaleResolution(sgct::ivec2 resolution, float scale) {
+        return sgct::ivec2{
+            std::max(static_cast<int>(std::round(resolution.x * scale)), 1),
+            std::max(static_cast<int>(std::round(resolution.y * scale)), 1)
+        };
+    }
+
     void windowFocusCallback(GLFWwindow* window, int state) {
         const sgct::Node& node = sgct::ClusterManager::instance().thisNode();
         for (const std::unique_ptr<sgct::Window>& win : node.windows()) {
@@ -160,10 +169,12 @@ void Window::applyWindow(const config::Window& window) {
         setFramebufferResolution(r.resolution);
         setFixResolution(true);
 
-        for (const mpcdi::ReturnValue::ViewportInfo& vp : r.viewports) {
+        for (mpcdi::ReturnValue::ViewportInfo& vp : r.viewports) {
             std::unique_ptr<Viewport> v = std::make_unique<Viewport>(this);
             v->applySettings(vp.proj);
-            v->setMpcdiWarpMesh(vp.meshData);
+            if (vp.mesh) {
+                v->setMpcdiWarpMesh(std::move(*vp.mesh));
+            }
             addViewport(std::move(v));
         }
         return;
@@ -364,6 +375,33 @@ void Window::initContextSpecificOGL() {
     );
 }
 
+void Window::reloadViewportData(const std::vector<Viewport*>& viewports) {
+    ZoneScoped
+
+    makeOpenGLContextCurrent();
+    for (const std::unique_ptr<Viewport>& vp : _viewports) {
+        const auto it = std::find(viewports.cbegin(), viewports.cend(), vp.get());
+        if (it == viewports.cend()) {
+            continue;
+        }
+
+        try {
+            vp->loadData();
+        }
+        catch (const std::runtime_error& e) {
+            // The previous data is kept if a file could not be loaded
+            Log::Error("Could not reload correction data: %s", e.what());
+        }
+    }
+    _hasAnyMasks = std::any_of(
+        _viewports.cbegin(),
+        _viewports.cend(),
+        [](const std::unique_ptr<Viewport>& vp) {
+            return vp->hasBlendMaskTexture() || vp->hasBlackLevelMaskTexture();
+        }
+    );
+}
+
 unsigned int Window::frameBufferTexture(TextureIndex index) {
     ZoneScoped
 
@@ -450,6 +488,11 @@ void Window::setFramebufferResolution(ivec2 resolution) {
     }
 }
 
+void Window::setResolutionScale(float scale) {
+    // Deferred for the same reason as the framebuffer resolution above
+    _pendingResolutionScale = scale;
+}
+
 void Window::swap(bool takeScreenshot) {
     if (!(_isVisible || _shouldRenderWhileHidden)) {
         return;
@@ -457,6 +500,14 @@ void Window::swap(bool takeScreenshot) {
 
     makeOpenGLContextCurrent();
 
+    // Frames that were captured earlier are saved as soon as their readback has finished
+    if (_screenCaptureLeftOrMono) {
+        _screenCaptureLeftOrMono->collectReadbacks();
+    }
+    if (_screenCaptureRight) {
+        _screenCaptureRight->collectReadbacks();
+    }
+
     if (takeScreenshot) {
         ZoneScopedN("Take Screenshot")
         if (Settings::instance().captureFromBackBuffer() && _isDoubleBuffered) {
@@ -500,6 +551,16 @@ void Window::swap(bool takeScreenshot) {
     }
 }
 
+void Window::finishRecording() {
+    makeOpenGLContextCurrent();
+    if (_screenCaptureLeftOrMono) {
+        _screenCaptureLeftOrMono->finishRecording();
+    }
+    if (_screenCaptureRight) {
+        _screenCaptureRight->finishRecording();
+    }
+}
+
 void Window::updateResolutions() {
     ZoneScoped
 
@@ -527,7 +588,8 @@ void Window::updateResolutions() {
     }
 
     if (_pendingFramebufferRes.has_value()) {
-        _framebufferRes = *_pendingFramebufferRes;
+        _unscaledFramebufferRes = *_pendingFramebufferRes;
+        _framebufferRes = scaleResolution(_unscaledFramebufferRes, _resolutionScale);
 
         Log::Debug(
             "Framebuffer resolution changed to %dx%d for window %d",
@@ -536,6 +598,20 @@ void Window::updateResolutions() {
 
         _pendingFramebufferRes = std::nullopt;
     }
+
+    if (_pendingResolutionScale.has_value()) {
+        if (*_pendingResolutionScale != _resolutionScale) {
+            _resolutionScale = *_pendingResolutionScale;
+            _framebufferRes = scaleResolution(_unscaledFramebufferRes, _resolutionScale);
+            _hasResolutionScaleChanged = true;
+
+            Log::Debug(
+                "Resolution scale changed to %.2f (%dx%d) for window %d",
+                _resolutionScale, _framebufferRes.x, _framebufferRes.y, _id
+            );
+        }
+        _pendingResolutionScale = std::nullopt;
+    }
 }
 
 void Window::setHorizFieldOfView(float hFovDeg) {
@@ -556,15 +632,21 @@ void Window::initWindowResolution(ivec2 resolution) {
     _isWindowResolutionSet = true;
 
     if (!_useFixResolution) {
-        _framebufferRes = resolution;
+        _unscaledFramebufferRes = resolution;
+        _framebufferRes = scaleResolution(_unscaledFramebufferRes, _resolutionScale);
     }
 }
 
-void Window::update() {
+bool Window::update() {
     ZoneScoped
 
-    if (!_isVisible || !isWindowResized()) {
-        return;
+    // A changed resolution scale also has to be applied to windows that are hidden but
+    // still rendering, for example in the headless benchmark mode
+    const bool isResized = _isVisible && isWindowResized();
+    const bool isRescaled =
+        (_isVisible || _shouldRenderWhileHidden) && _hasResolutionScaleChanged;
+    if (!isResized && !isRescaled) {
+        return false;
     }
     makeOpenGLContextCurrent();
 
@@ -595,6 +677,9 @@ void Window::update() {
     // resize non linear projection buffers
     for (const std::unique_ptr<Viewport>& vp : _viewports) {
         if (vp->hasSubViewports()) {
+            if (_hasResolutionScaleChanged) {
+                vp->nonLinearProjection()->setCubemapResolutionScale(_resolutionScale);
+            }
             const vec2 viewport = vec2{
                 _framebufferRes.x * vp->size().x,
                 _framebufferRes.y * vp->size().y
@@ -602,6 +687,8 @@ void Window::update() {
             vp->nonLinearProjection()->update(std::move(viewport));
         }
     }
+    _hasResolutionScaleChanged = false;
+    return true;
 }
 
 void Window::makeSharedContextCurrent() {
@@ -823,8 +910,8 @@ void Window::openWindow(GLFWwindow* share, bool isLastWindow) {
     _scale.x = static_cast<float>(bufferSize.x) / static_cast<float>(_windowRes.x);
     _scale.y = static_cast<float>(bufferSize.y) / static_cast<float>(_windowRes.y);
     if (!_useFixResolution) {
-        _framebufferRes.x = bufferSize.x;
-        _framebufferRes.y = bufferSize.y;
+        _unscaledFramebufferRes = ivec2{ bufferSize.x, bufferSize.y };
+        _framebufferRes = scaleResolution(_unscaledFramebufferRes, _resolutionScale);
     }
 
     // Swap inerval:
@@ -910,6 +997,10 @@ void Window::initScreenCapture() {
                 case CF::PNG: return ScreenCapture::CaptureFormat::PNG;
                 case CF::TGA: return ScreenCapture::CaptureFormat::TGA;
                 case CF::JPG: return ScreenCapture::CaptureFormat::JPEG;
+                case CF::Raw: return ScreenCapture::CaptureFormat::Raw;
+                case CF::Video: return ScreenCapture::CaptureFormat::Video;
+                case CF::SharedMemory:
+                    return ScreenCapture::CaptureFormat::SharedMemory;
                 default: throw std::logic_error("Unhandled case label");
             }
         }(format);
@@ -999,6 +1090,7 @@ void Window::generateTexture(unsigned int& id, Window::TextureType type) {
     ZoneScoped
     TracyGpuZone("Generate Textures")
 
+    memory::untrackTexture(id);
     glDeleteTextures(1, &id);
     glGenTextures(1, &id);
     glBindTexture(GL_TEXTURE_2D, id);
@@ -1031,6 +1123,11 @@ void Window::generateTexture(unsigned int& id, Window::TextureType type) {
         std::get<2>(formats),
         nullptr
     );
+    memory::trackTexture(
+        memory::Subsystem::FrameBuffer,
+        id,
+        memory::estimateImageBytes(std::get<0>(formats), res.x, res.y)
+    );
     Log::Debug("%dx%d texture generated for window %d", res.x, res.y, id);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -1160,7 +1257,8 @@ ivec2 Window::finalFBODimensions() const {
 }
 
 void Window::resizeFBOs() {
-    if (_useFixResolution) {
+    // A fixed resolution only changes if the resolution scale is changed
+    if (_useFixResolution && !_hasResolutionScaleChanged) {
         return;
     }
 
@@ -1178,14 +1276,19 @@ void Window::resizeFBOs() {
 }
 
 void Window::destroyFBOs() {
+    memory::untrackTexture(_frameBufferTextures.leftEye);
     glDeleteTextures(1, &_frameBufferTextures.leftEye);
     _frameBufferTextures.leftEye = 0;
+    memory::untrackTexture(_frameBufferTextures.rightEye);
     glDeleteTextures(1, &_frameBufferTextures.rightEye);
     _frameBufferTextures.rightEye = 0;
+    memory::untrackTexture(_frameBufferTextures.depth);
     glDeleteTextures(1, &_frameBufferTextures.depth);
     _frameBufferTextures.depth = 0;
+    memory::untrackTexture(_frameBufferTextures.intermediate);
     glDeleteTextures(1, &_frameBufferTextures.intermediate);
     _frameBufferTextures.intermediate = 0;
+    memory::untrackTexture(_frameBufferTextures.positions);
     glDeleteTextures(1, &_frameBufferTextures.positions);
     _frameBufferTextures.positions = 0;
 }
@@ -1249,6 +1352,10 @@ ivec2 Window::framebufferResolution() const {
     return _framebufferRes;
 }
 
+float Window::resolutionScale() const {
+    return _resolutionScale;
+}
+
 ivec2 Window::initialResolution() const {
     return _windowInitialRes;
 }
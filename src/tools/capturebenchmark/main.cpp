@@ -0,0 +1,352 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+// Measures how many frames the capture subsystem can save per second. Synthetic frames
+// are submitted to the CaptureService as fast as possible, the same way the windows
+// submit their captured frames, for every combination of the selected formats and number
+// of capture threads. For every run, the throughput, the latency from the submission of
+// a frame until it is saved, and the time the submitting thread had to wait for the
+// capture queue are reported
+
+#include <sgct/capturesegment.h>
+#include <sgct/captureservice.h>
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/pixelkernels.h>
+#include <sgct/settings.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sgct;
+
+namespace {
+    namespace fs = std::filesystem;
+    using Clock = std::chrono::steady_clock;
+
+    enum class Format { PNG, JPG, TGA, Raw };
+
+    struct Options {
+        ivec2 size = ivec2{ 1920, 1080 };
+        int channels = 4;
+        int bytesPerChannel = 1;
+        int nFrames = 100;
+        int maxThreads =
+            std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+        std::vector<Format> formats =
+            { Format::PNG, Format::JPG, Format::TGA, Format::Raw };
+        fs::path output = fs::temp_directory_path() / "sgct-capture-benchmark";
+    };
+    Options options;
+
+    const Clock::time_point StartTime = Clock::now();
+
+    double now() {
+        return std::chrono::duration<double>(Clock::now() - StartTime).count();
+    }
+
+    const char* toString(Format format) {
+        switch (format) {
+            case Format::PNG: return "png";
+            case Format::JPG: return "jpg";
+            case Format::TGA: return "tga";
+            case Format::Raw: return "raw";
+            default: throw std::logic_error("Unhandled case label");
+        }
+    }
+
+    /**
+     * Saves the frames like the CaptureService would and records the time from the
+     * submission of every frame, which is stored as its timestamp, until it is saved
+     */
+    class TimingSink : public CaptureSink {
+    public:
+        TimingSink(Format format, std::string prefix)
+            : _format(format)
+            , _prefix(std::move(prefix))
+        {
+            if (_format == Format::Raw) {
+                const uint64_t size = Settings::instance().captureSegmentSize();
+                _raw = std::make_unique<CaptureSegmentWriter>(
+                    _prefix,
+                    size * 1024 * 1024
+                );
+            }
+        }
+
+        void write(const Image& image, const Frame& frame) override {
+            if (_raw) {
+                _raw->write(image, frame);
+            }
+            else {
+                char number[16];
+                std::snprintf(number, sizeof(number), "%06u", frame.frameNumber);
+                image.save(_prefix + number + '.' + toString(_format));
+            }
+
+            const double latency = now() - frame.timestamp;
+            std::unique_lock lock(_mutex);
+            _latencies.push_back(latency);
+        }
+
+        std::vector<double> latencies() {
+            std::unique_lock lock(_mutex);
+            return _latencies;
+        }
+
+    private:
+        const Format _format;
+        const std::string _prefix;
+        std::unique_ptr<CaptureSegmentWriter> _raw;
+
+        std::mutex _mutex;
+        std::vector<double> _latencies;
+    };
+
+    /// Creates a frame that is neither trivial to compress nor random noise
+    std::vector<unsigned char> createFrame() {
+        const size_t nValues = static_cast<size_t>(options.size.x) * options.size.y *
+            options.channels;
+        std::vector<unsigned char> res(nValues * options.bytesPerChannel);
+        uint32_t state = 0x12345678;
+        for (int y = 0; y < options.size.y; ++y) {
+            for (int x = 0; x < options.size.x; ++x) {
+                // xorshift32 for a small amount of grain on top of a gradient
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                const size_t i = static_cast<size_t>(y) * options.size.x + x;
+                for (int c = 0; c < options.channels; ++c) {
+                    const unsigned int v = (x * (c + 1) + y * (3 - c % 3) +
+                        ((state >> (c * 4)) & 0xf)) & 0xffff;
+                    unsigned char* p =
+                        res.data() + (i * options.channels + c) * options.bytesPerChannel;
+                    std::memcpy(p, &v, options.bytesPerChannel);
+                }
+            }
+        }
+        return res;
+    }
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const size_t i = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[i];
+    }
+
+    void runBenchmark(Format format, int nThreads, const std::vector<unsigned char>& data)
+    {
+        const fs::path folder =
+            options.output / (std::string(toString(format)) + std::to_string(nThreads));
+        fs::create_directories(folder);
+
+        Settings::instance().setNumberOfCaptureThreads(nThreads);
+        CaptureService& service = CaptureService::instance();
+        auto sink = std::make_shared<TimingSink>(format, (folder / "frame").string());
+
+        const CaptureSink::DataType type = options.bytesPerChannel == 2 ?
+            CaptureSink::DataType::UInt16 :
+            CaptureSink::DataType::UInt8;
+        const double start = now();
+        for (int i = 0; i < options.nFrames; ++i) {
+            std::unique_ptr<Image> image = service.acquireImage(
+                options.size,
+                options.channels,
+                options.bytesPerChannel
+            );
+            // This copy stands in for the copy out of the mapped pixel buffer
+            std::memcpy(image->data(), data.data(), data.size());
+
+            CaptureSink::Frame frame;
+            frame.sequence = i;
+            frame.frameNumber = i;
+            frame.timestamp = now();
+            frame.dataType = type;
+            service.submit(std::move(image), sink, frame);
+        }
+        const double submitted = now();
+        const CaptureService::Statistics stats = service.statistics();
+        // Destroying the service waits until all queued frames are saved
+        CaptureService::destroy();
+        const double duration = now() - start;
+
+        std::vector<double> latencies = sink->latencies();
+        std::sort(latencies.begin(), latencies.end());
+        sink = nullptr;
+        fs::remove_all(folder);
+
+        const double megabytes =
+            static_cast<double>(data.size()) * options.nFrames / (1024.0 * 1024.0);
+        std::printf(
+            "%-6s %7d %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %7u %9.1f\n",
+            toString(format), nThreads, options.nFrames / duration, megabytes / duration,
+            percentile(latencies, 0.5) * 1000.0, percentile(latencies, 0.9) * 1000.0,
+            percentile(latencies, 0.99) * 1000.0,
+            latencies.empty() ? 0.0 : latencies.back() * 1000.0,
+            (submitted - start) * 1000.0 / options.nFrames, stats.nWaits,
+            stats.waitTime * 1000.0
+        );
+    }
+
+    void printHelp() {
+        std::cerr <<
+            "Usage: sgct-capture-benchmark [options]\n"
+            "  -size <w>x<h>             Resolution of the frames (default: 1920x1080)\n"
+            "  -channels <3|4>           Number of channels (default: 4)\n"
+            "  -bits <8|16>              Bits per channel (default: 8)\n"
+            "  -frames <n>               Number of frames per run (default: 100)\n"
+            "  -threads <n>              Runs with 1 to <n> capture threads\n"
+            "                            (default: number of cores)\n"
+            "  -formats <list>           Comma separated list of png, jpg, tga, and raw\n"
+            "                            (default: all)\n"
+            "  -output <path>            Folder for the temporary files\n"
+            "  -instructions <set>       Restricts the pixel conversions to scalar,\n"
+            "                            sse4.1, or avx2 (default: best supported)\n"
+            "  -help                     Shows this help message\n";
+    }
+
+    bool parseArguments(const std::vector<std::string>& args) {
+        size_t i = 0;
+        while (i < args.size()) {
+            const bool hasValue = i + 1 < args.size();
+            if (args[i] == "-size" && hasValue) {
+                const std::string& s = args[i + 1];
+                const size_t x = s.find('x');
+                if (x == std::string::npos) {
+                    std::cerr << "Size has to be <width>x<height>\n";
+                    return false;
+                }
+                options.size.x = std::max(std::stoi(s.substr(0, x)), 1);
+                options.size.y = std::max(std::stoi(s.substr(x + 1)), 1);
+                i += 2;
+            }
+            else if (args[i] == "-channels" && hasValue) {
+                options.channels = std::clamp(std::stoi(args[i + 1]), 3, 4);
+                i += 2;
+            }
+            else if (args[i] == "-bits" && hasValue) {
+                options.bytesPerChannel = std::stoi(args[i + 1]) > 8 ? 2 : 1;
+                i += 2;
+            }
+            else if (args[i] == "-frames" && hasValue) {
+                options.nFrames = std::max(std::stoi(args[i + 1]), 1);
+                i += 2;
+            }
+            else if (args[i] == "-threads" && hasValue) {
+                options.maxThreads = std::max(std::stoi(args[i + 1]), 1);
+                i += 2;
+            }
+            else if (args[i] == "-formats" && hasValue) {
+                options.formats.clear();
+                std::string list = args[i + 1] + ',';
+                for (size_t p = list.find(','); p != std::string::npos;
+                     p = list.find(','))
+                {
+                    const std::string f = list.substr(0, p);
+                    list.erase(0, p + 1);
+                    if (f == "png") {
+                        options.formats.push_back(Format::PNG);
+                    }
+                    else if (f == "jpg") {
+                        options.formats.push_back(Format::JPG);
+                    }
+                    else if (f == "tga") {
+                        options.formats.push_back(Format::TGA);
+                    }
+                    else if (f == "raw") {
+                        options.formats.push_back(Format::Raw);
+                    }
+                    else {
+                        std::cerr << "Unknown format '" << f << "'\n";
+                        return false;
+                    }
+                }
+                i += 2;
+            }
+            else if (args[i] == "-output" && hasValue) {
+                options.output = args[i + 1];
+                i += 2;
+            }
+            else if (args[i] == "-instructions" && hasValue) {
+                using pixelkernels::InstructionSet;
+                const std::string& s = args[i + 1];
+                if (s == "scalar") {
+                    pixelkernels::setInstructionSet(InstructionSet::Scalar);
+                }
+                else if (s == "sse4.1") {
+                    pixelkernels::setInstructionSet(InstructionSet::SSE41);
+                }
+                else if (s == "avx2") {
+                    pixelkernels::setInstructionSet(InstructionSet::AVX2);
+                }
+                else {
+                    std::cerr << "Unknown instruction set '" << s << "'\n";
+                    return false;
+                }
+                i += 2;
+            }
+            else {
+                printHelp();
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    try {
+        if (!parseArguments(args)) {
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error parsing arguments: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    Log::instance().setNotifyLevel(Log::Level::Warning);
+    // Every frame has to be saved for the measurements to be comparable
+    Settings::instance().setCaptureQueuePolicy(Settings::CaptureQueuePolicy::Block);
+
+    std::printf(
+        "%d frames of %dx%d pixels with %d channels of %d bits, pixel conversions: %s\n",
+        options.nFrames, options.size.x, options.size.y, options.channels,
+        options.bytesPerChannel * 8,
+        pixelkernels::toString(pixelkernels::instructionSet())
+    );
+    std::printf(
+        "%-6s %7s %9s %9s %9s %9s %9s %9s %9s %7s %9s\n", "format", "threads",
+        "frames/s", "MB/s", "p50 ms", "p90 ms", "p99 ms", "max ms", "submit ms",
+        "waits", "wait ms"
+    );
+
+    try {
+        const std::vector<unsigned char> data = createFrame();
+        for (Format format : options.formats) {
+            for (int n = 1; n <= options.maxThreads; ++n) {
+                runBenchmark(format, n, data);
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,472 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+// Converts the segment files that are written by raw captures into individual images.
+// The frames are named the same way as if they had been captured as images directly and
+// are converted on all cores. Every frame can be written as PNG, TGA, JPG, or as an
+// uncompressed OpenEXR file that keeps the full range of floating point captures
+
+#include <sgct/capturesegment.h>
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/pixelkernels.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sgct;
+
+namespace {
+    namespace fs = std::filesystem;
+
+    struct Options {
+        enum class Format { PNG, TGA, JPG, EXR };
+
+        Format format = Format::PNG;
+        std::string output = ".";
+        int nThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+        std::vector<std::string> segments;
+    };
+    Options options;
+
+    struct Frame {
+        std::string segment;
+        std::string prefix;
+        std::streamoff offset = 0;
+        rawcapture::FrameHeader header;
+    };
+
+    float halfToFloat(uint16_t h) {
+        const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+        const uint32_t exponent = (h >> 10) & 0x1f;
+        const uint32_t mantissa = h & 0x3ff;
+
+        if (exponent == 0) {
+            // Zero or subnormal number
+            const float v = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign ? -v : v;
+        }
+
+        uint32_t bits;
+        if (exponent == 31) {
+            // Infinity or NaN
+            bits = sign | 0x7f800000 | (mantissa << 13);
+        }
+        else {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+        float res;
+        std::memcpy(&res, &bits, sizeof(res));
+        return res;
+    }
+
+    uint16_t floatToHalf(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        const int exponent = static_cast<int>((bits >> 23) & 0xff) - 127 + 15;
+        const uint32_t mantissa = bits & 0x7fffff;
+
+        if (((bits >> 23) & 0xff) == 0xff) {
+            // Infinity or NaN
+            return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+        }
+        if (exponent >= 31) {
+            // Too large to be represented, so it becomes infinity
+            return sign | 0x7c00;
+        }
+        if (exponent <= 0) {
+            if (exponent < -10) {
+                return sign;
+            }
+            // Subnormal number
+            const uint32_t m = mantissa | 0x800000;
+            return sign | static_cast<uint16_t>(m >> (14 - exponent));
+        }
+        return sign | static_cast<uint16_t>(exponent << 10) |
+            static_cast<uint16_t>(mantissa >> 13);
+    }
+
+    // Returns the value of one channel of a pixel, normalized to [0, 1] for integer types
+    float channelValue(const unsigned char* data, size_t index, rawcapture::DataType t) {
+        switch (t) {
+            case rawcapture::DataType::UInt8:
+                return data[index] / 255.f;
+            case rawcapture::DataType::UInt16:
+            {
+                uint16_t v;
+                std::memcpy(&v, data + index * 2, sizeof(v));
+                return v / 65535.f;
+            }
+            case rawcapture::DataType::Float16:
+            {
+                uint16_t v;
+                std::memcpy(&v, data + index * 2, sizeof(v));
+                return halfToFloat(v);
+            }
+            case rawcapture::DataType::Float32:
+            {
+                float v;
+                std::memcpy(&v, data + index * 4, sizeof(v));
+                return v;
+            }
+            default: throw std::logic_error("Unhandled case label");
+        }
+    }
+
+    /**
+     * Writes an uncompressed scanline OpenEXR file. Integer and half precision captures
+     * are stored as half floats, single precision captures as floats. The pixel data is
+     * stored bottom-up in BGR(A) order whereas EXR stores the top row first and the
+     * channels in alphabetical order, so the rows and channels are reordered.
+     */
+    void writeExr(const std::string& filename, const rawcapture::FrameHeader& header,
+                  const unsigned char* data)
+    {
+        const int w = header.width;
+        const int h = header.height;
+        const int nChannels = header.channels;
+        const bool isFloat = header.dataType == rawcapture::DataType::Float32;
+        const int bytesPerValue = isFloat ? 4 : 2;
+
+        // EXR channels in alphabetical order and the index of the channel in our data
+        std::vector<std::pair<std::string, int>> channels;
+        switch (nChannels) {
+            case 1: channels = { { "Y", 0 } }; break;
+            case 2: channels = { { "A", 1 }, { "Y", 0 } }; break;
+            case 3: channels = { { "B", 0 }, { "G", 1 }, { "R", 2 } }; break;
+            case 4: channels = { { "A", 3 }, { "B", 0 }, { "G", 1 }, { "R", 2 } }; break;
+            default: throw std::logic_error("Unhandled case label");
+        }
+
+        std::vector<unsigned char> buf;
+        auto append = [&buf](const void* d, size_t size) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(d);
+            buf.insert(buf.end(), p, p + size);
+        };
+        auto appendInt = [&append](int32_t v) { append(&v, sizeof(v)); };
+        auto appendFloat = [&append](float v) { append(&v, sizeof(v)); };
+        auto attribute = [&](const char* name, const char* type, int32_t size) {
+            append(name, std::strlen(name) + 1);
+            append(type, std::strlen(type) + 1);
+            appendInt(size);
+        };
+
+        // EXR is little-endian, just like all platforms that we support
+        const unsigned char magic[8] = { 0x76, 0x2f, 0x31, 0x01, 2, 0, 0, 0 };
+        append(magic, sizeof(magic));
+
+        attribute("channels", "chlist", static_cast<int32_t>(channels.size() * 18 + 1));
+        for (const std::pair<std::string, int>& c : channels) {
+            append(c.first.c_str(), c.first.size() + 1);
+            appendInt(isFloat ? 2 : 1); // pixel type: 1 = HALF, 2 = FLOAT
+            const unsigned char linearAndReserved[4] = { 0, 0, 0, 0 };
+            append(linearAndReserved, 4);
+            appendInt(1); // x sampling
+            appendInt(1); // y sampling
+        }
+        buf.push_back(0);
+        attribute("compression", "compression", 1);
+        buf.push_back(0); // no compression
+        for (const char* window : { "dataWindow", "displayWindow" }) {
+            attribute(window, "box2i", 16);
+            appendInt(0);
+            appendInt(0);
+            appendInt(w - 1);
+            appendInt(h - 1);
+        }
+        attribute("lineOrder", "lineOrder", 1);
+        buf.push_back(0); // increasing y
+        attribute("pixelAspectRatio", "float", 4);
+        appendFloat(1.f);
+        attribute("screenWindowCenter", "v2f", 8);
+        appendFloat(0.f);
+        appendFloat(0.f);
+        attribute("screenWindowWidth", "float", 4);
+        appendFloat(1.f);
+        buf.push_back(0);
+
+        const size_t lineSize = static_cast<size_t>(w) * nChannels * bytesPerValue;
+        const uint64_t tableEnd = buf.size() + static_cast<uint64_t>(h) * 8;
+        for (int y = 0; y < h; ++y) {
+            const uint64_t offset = tableEnd + y * (8 + lineSize);
+            append(&offset, sizeof(offset));
+        }
+
+        for (int y = 0; y < h; ++y) {
+            appendInt(y);
+            appendInt(static_cast<int32_t>(lineSize));
+            const size_t row = static_cast<size_t>(h - 1 - y) * w;
+            for (const std::pair<std::string, int>& c : channels) {
+                for (int x = 0; x < w; ++x) {
+                    const size_t index = (row + x) * nChannels + c.second;
+                    if (header.dataType == rawcapture::DataType::Float16) {
+                        // Half values are copied as they are to not lose any precision
+                        append(data + index * 2, 2);
+                    }
+                    else if (isFloat) {
+                        append(data + index * 4, 4);
+                    }
+                    else {
+                        const uint16_t v = floatToHalf(
+                            channelValue(data, index, header.dataType)
+                        );
+                        append(&v, sizeof(v));
+                    }
+                }
+            }
+        }
+
+        std::ofstream file(filename, std::ofstream::binary);
+        file.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+        if (!file.good()) {
+            throw std::runtime_error("Could not write '" + filename + "'");
+        }
+    }
+
+    void writeImage(const std::string& filename, const rawcapture::FrameHeader& header,
+                    const unsigned char* data)
+    {
+        const bool is16Bit = header.dataType == rawcapture::DataType::UInt16 &&
+            options.format == Options::Format::PNG;
+        const bool isDirect = header.dataType == rawcapture::DataType::UInt8 || is16Bit;
+
+        Image image;
+        image.setSize(ivec2{ header.width, header.height });
+        image.setChannels(header.channels);
+        image.setBytesPerChannel(is16Bit ? 2 : 1);
+        image.allocateOrResizeData();
+
+        if (isDirect) {
+            std::memcpy(image.data(), data, header.dataSize);
+        }
+        else {
+            // Everything else is converted to 8 bit, clamping floating point values
+            const size_t nValues =
+                static_cast<size_t>(header.width) * header.height * header.channels;
+            switch (header.dataType) {
+                case rawcapture::DataType::UInt16:
+                    pixelkernels::uint16ToUInt8(data, image.data(), nValues);
+                    break;
+                case rawcapture::DataType::Float16:
+                    pixelkernels::halfToUInt8(data, image.data(), nValues);
+                    break;
+                case rawcapture::DataType::Float32:
+                    pixelkernels::floatToUInt8(data, image.data(), nValues);
+                    break;
+                default: throw std::logic_error("Unhandled case label");
+            }
+        }
+        image.save(filename);
+    }
+
+    // Collects the frames of a segment file without reading the pixel data
+    void indexSegment(const std::string& path, std::vector<Frame>& frames) {
+        std::ifstream file(path, std::ifstream::binary);
+        if (!file.good()) {
+            throw std::runtime_error("Could not open segment '" + path + "'");
+        }
+
+        rawcapture::SegmentHeader segment;
+        file.read(reinterpret_cast<char*>(&segment), sizeof(segment));
+        const bool isValid = file.good() &&
+            std::equal(
+                std::begin(segment.magic), std::end(segment.magic),
+                std::begin(rawcapture::SegmentMagic)
+            );
+        if (!isValid) {
+            throw std::runtime_error("'" + path + "' is not a capture segment");
+        }
+        // Version 2 only added the cluster frame number to the frame header
+        if (segment.version < 1 || segment.version > rawcapture::Version) {
+            throw std::runtime_error(
+                "Unsupported version " + std::to_string(segment.version) + " of '" +
+                path + "'"
+            );
+        }
+        segment.prefix[sizeof(segment.prefix) - 1] = '\0';
+
+        std::streamoff offset = segment.blockSize;
+        while (true) {
+            Frame frame;
+            file.seekg(offset);
+            file.read(reinterpret_cast<char*>(&frame.header), sizeof(frame.header));
+            if (!file.good() || frame.header.magic != rawcapture::FrameMagic) {
+                break;
+            }
+            frame.segment = path;
+            frame.prefix = segment.prefix;
+            frame.offset = offset + segment.blockSize;
+            frames.push_back(frame);
+            offset += static_cast<std::streamoff>(frame.header.recordSize);
+        }
+    }
+
+    void convertFrame(const Frame& frame, std::vector<unsigned char>& buffer) {
+        std::ifstream file(frame.segment, std::ifstream::binary);
+        file.seekg(frame.offset);
+        buffer.resize(frame.header.dataSize);
+        file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        if (!file.good()) {
+            throw std::runtime_error(
+                "Could not read frame " + std::to_string(frame.header.frameNumber) +
+                " from '" + frame.segment + "'"
+            );
+        }
+
+        const char* suffix = [](Options::Format format) {
+            switch (format) {
+                case Options::Format::PNG: return "png";
+                case Options::Format::TGA: return "tga";
+                case Options::Format::JPG: return "jpg";
+                case Options::Format::EXR: return "exr";
+                default: throw std::logic_error("Unhandled case label");
+            }
+        }(options.format);
+
+        char number[16];
+        std::snprintf(number, sizeof(number), "%06u", frame.header.frameNumber);
+        const fs::path filename =
+            fs::path(options.output) / (frame.prefix + number + '.' + suffix);
+
+        if (options.format == Options::Format::EXR) {
+            writeExr(filename.string(), frame.header, buffer.data());
+        }
+        else {
+            writeImage(filename.string(), frame.header, buffer.data());
+        }
+    }
+
+    void printHelp() {
+        std::cerr <<
+            "Usage: sgct-capture-convert [options] <segment files>\n"
+            "  -format <png|tga|jpg|exr>  Image format of the frames (default: png)\n"
+            "  -output <path>             Folder the frames are written to (default: .)\n"
+            "  -threads <n>               Number of frames that are converted at the\n"
+            "                             same time (default: number of cores)\n"
+            "  -help                      Shows this help message\n";
+    }
+
+    bool parseArguments(const std::vector<std::string>& args) {
+        size_t i = 0;
+        while (i < args.size()) {
+            const bool hasValue = i + 1 < args.size();
+            if (args[i] == "-format" && hasValue) {
+                const std::string& f = args[i + 1];
+                if (f == "png") {
+                    options.format = Options::Format::PNG;
+                }
+                else if (f == "tga") {
+                    options.format = Options::Format::TGA;
+                }
+                else if (f == "jpg") {
+                    options.format = Options::Format::JPG;
+                }
+                else if (f == "exr") {
+                    options.format = Options::Format::EXR;
+                }
+                else {
+                    std::cerr << "Unknown format '" << f << "'\n";
+                    return false;
+                }
+                i += 2;
+            }
+            else if (args[i] == "-output" && hasValue) {
+                options.output = args[i + 1];
+                i += 2;
+            }
+            else if (args[i] == "-threads" && hasValue) {
+                options.nThreads = std::max(std::stoi(args[i + 1]), 1);
+                i += 2;
+            }
+            else if (!args[i].empty() && args[i][0] != '-') {
+                options.segments.push_back(args[i]);
+                i += 1;
+            }
+            else {
+                printHelp();
+                return false;
+            }
+        }
+        if (options.segments.empty()) {
+            printHelp();
+            return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    try {
+        if (!parseArguments(args)) {
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error parsing arguments: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    Log::instance().setNotifyLevel(Log::Level::Warning);
+
+    std::vector<Frame> frames;
+    try {
+        for (const std::string& segment : options.segments) {
+            indexSegment(segment, frames);
+        }
+        fs::create_directories(options.output);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Converting " << frames.size() << " frames\n";
+
+    std::atomic_size_t nextFrame = 0;
+    std::atomic_int nFailed = 0;
+    std::mutex outputMutex;
+    auto worker = [&]() {
+        std::vector<unsigned char> buffer;
+        for (size_t i = nextFrame++; i < frames.size(); i = nextFrame++) {
+            try {
+                convertFrame(frames[i], buffer);
+            }
+            catch (const std::exception& e) {
+                std::unique_lock lock(outputMutex);
+                std::cerr << e.what() << '\n';
+                nFailed++;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < options.nThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    Log::destroy();
+    if (nFailed > 0) {
+        std::cerr << nFailed << " frames could not be converted\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,477 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2020                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+// Converts, validates, and benchmarks correction meshes without opening a window or
+// creating an OpenGL context. Every mesh is read with the same parsers and simplified the
+// same way as when a viewport loads it. The result is checked for broken topology and can
+// be written as an OBJ file or into the binary mesh cache, so that the meshes can be
+// parsed ahead of time, for example on a build server
+
+#include <sgct/log.h>
+#include <sgct/math.h>
+#include <sgct/opengl.h>
+#include <sgct/correction/buffer.h>
+#include <sgct/correction/domeprojection.h>
+#include <sgct/correction/meshcache.h>
+#include <sgct/correction/obj.h>
+#include <sgct/correction/paulbourke.h>
+#include <sgct/correction/pfm.h>
+#include <sgct/correction/scalable.h>
+#include <sgct/correction/simcad.h>
+#include <sgct/correction/simplify.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace sgct;
+
+namespace {
+    namespace fs = std::filesystem;
+    using Clock = std::chrono::steady_clock;
+    using correction::Buffer;
+    using correction::CorrectionMeshVertex;
+
+    struct Options {
+        enum class Output { None, OBJ, Cache };
+
+        Output output = Output::None;
+        std::string folder;
+        vec2 position = vec2{ 0.f, 0.f };
+        vec2 size = vec2{ 1.f, 1.f };
+        ivec2 resolution = ivec2{ 1920, 1080 };
+        std::optional<ivec2> framebufferResolution;
+        float tolerance = 0.f;
+        int nRepetitions = 1;
+        std::vector<std::string> meshes;
+    };
+    Options options;
+
+    double elapsed(Clock::time_point since) {
+        return std::chrono::duration<double>(Clock::now() - since).count();
+    }
+
+    std::string extension(const std::string& path) {
+        return path.substr(path.rfind('.') + 1);
+    }
+
+    // SCISS and SkySkan meshes also change the projection of the viewport they are loaded
+    // for and MPCDI meshes are part of the MPCDI configuration, so these formats can only
+    // be read by the application itself
+    const char* formatName(const std::string& ext) {
+        if (ext == "ol") {
+            return "Scalable";
+        }
+        else if (ext == "csv") {
+            return "DomeProjection";
+        }
+        else if (ext == "data") {
+            return "PaulBourke";
+        }
+        else if (ext == "obj") {
+            return "Wavefront OBJ";
+        }
+        else if (ext == "pfm") {
+            return "PFM";
+        }
+        else if (ext == "simcad") {
+            return "SimCAD";
+        }
+        else {
+            return nullptr;
+        }
+    }
+
+    Buffer parseMesh(const std::string& path, const std::string& ext, float aspectRatio)
+    {
+        const vec2& pos = options.position;
+        const vec2& size = options.size;
+        if (ext == "ol") {
+            return correction::generateScalableMesh(path, pos, size);
+        }
+        else if (ext == "csv") {
+            return correction::generateDomeProjectionMesh(path, pos, size);
+        }
+        else if (ext == "data") {
+            return correction::generatePaulBourkeMesh(path, pos, size, aspectRatio);
+        }
+        else if (ext == "obj") {
+            return correction::generateOBJMesh(path);
+        }
+        else if (ext == "pfm") {
+            return correction::generatePerEyeMeshFromPFMImage(path, pos, size);
+        }
+        else if (ext == "simcad") {
+            return correction::generateSimCADMesh(path, pos, size);
+        }
+        else {
+            throw std::logic_error("Unhandled mesh format");
+        }
+    }
+
+    struct Validation {
+        size_t nTriangles = 0;
+        size_t nStrips = 0;
+        size_t nDegenerate = 0;
+        size_t nOutOfRange = 0;
+        size_t nInvalidValues = 0;
+        size_t nOutsideUV = 0;
+        size_t nUnused = 0;
+        vec2 minPosition = vec2{ 0.f, 0.f };
+        vec2 maxPosition = vec2{ 0.f, 0.f };
+        vec2 minUV = vec2{ 0.f, 0.f };
+        vec2 maxUV = vec2{ 0.f, 0.f };
+    };
+
+    Validation validate(const Buffer& buffer) {
+        Validation res;
+        const std::vector<CorrectionMeshVertex>& v = buffer.vertices;
+        const std::vector<unsigned int>& idx = buffer.indices;
+
+        if (!v.empty()) {
+            constexpr float Max = std::numeric_limits<float>::max();
+            res.minPosition = vec2{ Max, Max };
+            res.maxPosition = vec2{ -Max, -Max };
+            res.minUV = vec2{ Max, Max };
+            res.maxUV = vec2{ -Max, -Max };
+        }
+        for (const CorrectionMeshVertex& vertex : v) {
+            const bool isFinite = std::isfinite(vertex.x) && std::isfinite(vertex.y) &&
+                std::isfinite(vertex.s) && std::isfinite(vertex.t);
+            if (!isFinite) {
+                res.nInvalidValues++;
+                continue;
+            }
+            if (vertex.s < 0.f || vertex.s > 1.f || vertex.t < 0.f || vertex.t > 1.f) {
+                res.nOutsideUV++;
+            }
+            res.minPosition.x = std::min(res.minPosition.x, vertex.x);
+            res.minPosition.y = std::min(res.minPosition.y, vertex.y);
+            res.maxPosition.x = std::max(res.maxPosition.x, vertex.x);
+            res.maxPosition.y = std::max(res.maxPosition.y, vertex.y);
+            res.minUV.x = std::min(res.minUV.x, vertex.s);
+            res.minUV.y = std::min(res.minUV.y, vertex.t);
+            res.maxUV.x = std::max(res.maxUV.x, vertex.s);
+            res.maxUV.y = std::max(res.maxUV.y, vertex.t);
+        }
+
+        std::vector<bool> isUsed(v.size(), false);
+        auto checkTriangle = [&](unsigned int a, unsigned int b, unsigned int c) {
+            res.nTriangles++;
+            if (a >= v.size() || b >= v.size() || c >= v.size()) {
+                res.nOutOfRange++;
+                return;
+            }
+            isUsed[a] = true;
+            isUsed[b] = true;
+            isUsed[c] = true;
+
+            const float area = (v[b].x - v[a].x) * (v[c].y - v[a].y) -
+                (v[b].y - v[a].y) * (v[c].x - v[a].x);
+            if (a == b || b == c || a == c || area == 0.f) {
+                res.nDegenerate++;
+            }
+        };
+
+        if (buffer.geometryType == GL_TRIANGLE_STRIP) {
+            // Every strip starts over after a primitive restart index
+            size_t start = 0;
+            for (size_t i = 0; i < idx.size(); ++i) {
+                if (idx[i] == correction::PrimitiveRestartIndex) {
+                    start = i + 1;
+                    continue;
+                }
+                if (i == start) {
+                    res.nStrips++;
+                }
+                if (i >= start + 2) {
+                    checkTriangle(idx[i - 2], idx[i - 1], idx[i]);
+                }
+            }
+        }
+        else {
+            for (size_t i = 0; i + 2 < idx.size(); i += 3) {
+                checkTriangle(idx[i], idx[i + 1], idx[i + 2]);
+            }
+        }
+        res.nUnused = std::count(isUsed.cbegin(), isUsed.cend(), false);
+        return res;
+    }
+
+    bool processMesh(const std::string& path) {
+        const std::string ext = extension(path);
+        const char* format = formatName(ext);
+        std::printf("%s\n", path.c_str());
+        if (format == nullptr) {
+            std::printf(
+                "  Error:      Format '%s' can not be read without a viewport\n\n",
+                ext.c_str()
+            );
+            return false;
+        }
+
+        // The same parameters that a window with this resolution would use
+        const ivec2& res = options.resolution;
+        const float aspectRatio = static_cast<float>(res.x) / static_cast<float>(res.y);
+        const ivec2 fbRes = options.framebufferResolution.value_or(res);
+        const float pixels = options.tolerance;
+        const vec2 tolerance = {
+            pixels / static_cast<float>(std::max(fbRes.x, 1)),
+            pixels / static_cast<float>(std::max(fbRes.y, 1))
+        };
+
+        Buffer buffer;
+        double total = 0.0;
+        double fastest = std::numeric_limits<double>::max();
+        try {
+            for (int i = 0; i < options.nRepetitions; ++i) {
+                const Clock::time_point t = Clock::now();
+                buffer = parseMesh(path, ext, aspectRatio);
+                const double duration = elapsed(t);
+                total += duration;
+                fastest = std::min(fastest, duration);
+            }
+        }
+        catch (const std::exception& e) {
+            std::printf("  Error:      %s\n\n", e.what());
+            return false;
+        }
+        std::printf(
+            "  Format:     %s, parsed in %.2f ms (fastest %.2f ms of %d runs)\n",
+            format, total / options.nRepetitions * 1000.0, fastest * 1000.0,
+            options.nRepetitions
+        );
+
+        if (pixels > 0.f) {
+            const size_t nVertices = buffer.vertices.size();
+            const Clock::time_point t = Clock::now();
+            correction::simplifyGridMesh(buffer, tolerance);
+            std::printf(
+                "  Simplified: %zu to %zu vertices in %.2f ms\n",
+                nVertices, buffer.vertices.size(), elapsed(t) * 1000.0
+            );
+        }
+
+        const Validation v = validate(buffer);
+        const bool isStrip = buffer.geometryType == GL_TRIANGLE_STRIP;
+        std::printf(
+            "  Vertices:   %zu (%zu bytes)\n", buffer.vertices.size(),
+            buffer.vertices.size() * sizeof(CorrectionMeshVertex)
+        );
+        std::printf(
+            "  Indices:    %zu (%zu bytes), %zu triangles", buffer.indices.size(),
+            buffer.indices.size() * sizeof(unsigned int), v.nTriangles
+        );
+        if (isStrip) {
+            std::printf(" in %zu strips", v.nStrips);
+        }
+        std::printf("\n");
+        if (buffer.gridColumns > 0 && buffer.gridRows > 0) {
+            std::printf("  Grid:       %u x %u\n", buffer.gridColumns, buffer.gridRows);
+        }
+        if (!buffer.vertices.empty()) {
+            std::printf(
+                "  Position:   [%.4f, %.4f] x [%.4f, %.4f]\n",
+                v.minPosition.x, v.maxPosition.x, v.minPosition.y, v.maxPosition.y
+            );
+            std::printf(
+                "  UV:         [%.4f, %.4f] x [%.4f, %.4f]\n",
+                v.minUV.x, v.maxUV.x, v.minUV.y, v.maxUV.y
+            );
+        }
+
+        // Problems that break the rendering of the mesh are errors, the rest only hint at
+        // a mesh that might not be what was intended
+        bool hasErrors = false;
+        auto report = [&hasErrors](bool isError, size_t count, const char* message) {
+            if (count > 0) {
+                std::printf(
+                    "  %-11s %zu %s\n", isError ? "Error:" : "Warning:", count, message
+                );
+                hasErrors |= isError;
+            }
+        };
+        if (v.nTriangles == 0) {
+            std::printf("  Error:      The mesh does not contain any triangles\n");
+            hasErrors = true;
+        }
+        report(true, v.nOutOfRange, "triangles have indices that are out of range");
+        report(true, v.nInvalidValues, "vertices have values that are not finite");
+        report(false, v.nDegenerate, "triangles are degenerate");
+        report(false, v.nOutsideUV, "vertices have texture coordinates outside [0, 1]");
+        report(false, v.nUnused, "vertices are not used by any triangle");
+        if (hasErrors) {
+            std::printf("\n");
+            return false;
+        }
+
+        const Clock::time_point t = Clock::now();
+        try {
+            if (options.output == Options::Output::OBJ) {
+                const fs::path file = fs::path(options.folder) /
+                    (fs::path(path).stem().string() + "_export.obj");
+                correction::exportOBJMesh(file.string(), buffer);
+                std::printf(
+                    "  Written:    %s in %.2f ms\n",
+                    file.string().c_str(), elapsed(t) * 1000.0
+                );
+            }
+            else if (options.output == Options::Output::Cache) {
+                correction::cacheMesh(
+                    options.folder, path, options.position, options.size, aspectRatio,
+                    tolerance, buffer
+                );
+                // Writing to the cache never fails loudly, so the mesh is read back
+                const bool isCached = correction::loadCachedMesh(
+                    options.folder, path, options.position, options.size, aspectRatio,
+                    tolerance
+                ).has_value();
+                if (!isCached) {
+                    std::printf("  Error:      Could not write to the cache\n\n");
+                    return false;
+                }
+                std::printf(
+                    "  Cached:     %s in %.2f ms\n",
+                    options.folder.c_str(), elapsed(t) * 1000.0
+                );
+            }
+        }
+        catch (const std::exception& e) {
+            std::printf("  Error:      %s\n\n", e.what());
+            return false;
+        }
+
+        std::printf("\n");
+        return true;
+    }
+
+    void printHelp() {
+        std::cerr <<
+            "Usage: sgct-meshtool [options] <mesh files>\n"
+            "Reads, validates, and times correction meshes in all formats that do not\n"
+            "depend on the projection of the viewport, which excludes SCISS, SkySkan,\n"
+            "and MPCDI meshes.\n"
+            "  -obj <path>                   Writes every mesh as OBJ file into <path>\n"
+            "  -cache <path>                 Writes every mesh into the mesh cache in\n"
+            "                                <path>, see -correction-mesh-cache\n"
+            "  -position <x> <y>             Position of the viewport (default: 0 0)\n"
+            "  -size <x> <y>                 Size of the viewport (default: 1 1)\n"
+            "  -resolution <x> <y>           Resolution of the window, which sets the\n"
+            "                                aspect ratio (default: 1920 1080)\n"
+            "  -framebuffer <x> <y>          Framebuffer resolution of the window\n"
+            "                                (default: the window resolution)\n"
+            "  -tolerance <pixels>           Simplifies the meshes the same way as\n"
+            "                                -correction-mesh-tolerance (default: 0)\n"
+            "  -repeat <n>                   Parses every mesh <n> times (default: 1)\n"
+            "  -help                         Shows this help message\n"
+            "The cache is only used for meshes with the same absolute path and viewport\n"
+            "and window parameters as the ones provided here.\n";
+    }
+
+    bool parseArguments(const std::vector<std::string>& args) {
+        size_t i = 0;
+        while (i < args.size()) {
+            const bool hasValue = i + 1 < args.size();
+            const bool hasTwoValues = i + 2 < args.size();
+            if (args[i] == "-obj" && hasValue) {
+                options.output = Options::Output::OBJ;
+                options.folder = args[i + 1];
+                i += 2;
+            }
+            else if (args[i] == "-cache" && hasValue) {
+                options.output = Options::Output::Cache;
+                options.folder = args[i + 1];
+                i += 2;
+            }
+            else if (args[i] == "-position" && hasTwoValues) {
+                options.position = vec2{ std::stof(args[i + 1]), std::stof(args[i + 2]) };
+                i += 3;
+            }
+            else if (args[i] == "-size" && hasTwoValues) {
+                options.size = vec2{ std::stof(args[i + 1]), std::stof(args[i + 2]) };
+                i += 3;
+            }
+            else if (args[i] == "-resolution" && hasTwoValues) {
+                options.resolution =
+                    ivec2{ std::stoi(args[i + 1]), std::stoi(args[i + 2]) };
+                i += 3;
+            }
+            else if (args[i] == "-framebuffer" && hasTwoValues) {
+                options.framebufferResolution =
+                    ivec2{ std::stoi(args[i + 1]), std::stoi(args[i + 2]) };
+                i += 3;
+            }
+            else if (args[i] == "-tolerance" && hasValue) {
+                options.tolerance = std::max(std::stof(args[i + 1]), 0.f);
+                i += 2;
+            }
+            else if (args[i] == "-repeat" && hasValue) {
+                options.nRepetitions = std::max(std::stoi(args[i + 1]), 1);
+                i += 2;
+            }
+            else if (!args[i].empty() && args[i][0] != '-') {
+                options.meshes.push_back(args[i]);
+                i += 1;
+            }
+            else {
+                printHelp();
+                return false;
+            }
+        }
+        if (options.meshes.empty() || options.resolution.y == 0) {
+            printHelp();
+            return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    try {
+        if (!parseArguments(args)) {
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error parsing arguments: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    Log::instance().setNotifyLevel(Log::Level::Warning);
+
+    if (options.output != Options::Output::None) {
+        std::error_code ec;
+        fs::create_directories(options.folder, ec);
+        if (ec) {
+            std::cerr << "Could not create '" << options.folder << "'\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    int nFailed = 0;
+    for (const std::string& mesh : options.meshes) {
+        if (!processMesh(mesh)) {
+            nFailed++;
+        }
+    }
+
+    Log::destroy();
+    if (nFailed > 0) {
+        std::cerr << nFailed << " of " << options.meshes.size() << " meshes failed\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}